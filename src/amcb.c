@@ -0,0 +1,513 @@
+/*******************************************************\
+*                                                       *
+*  AMCB.C                                               *
+*  Binary motion cache (.amcb sidecar files)            *
+*                                                       *
+*  Stores a parsed skeleton and motion slab next to the *
+*  AMC file so later runs can map it instead of parsing *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "amcb.h"
+#include "arena.h"
+
+#define AMCB_MAGIC			"AMCB"
+#define AMCB_BYTEORDER		(0x01020304)	/* Reads back differently on a machine of the other endianness */
+#define AMCB_ALIGN			(16)			/* Every table starts on this boundary */
+
+/* File header - the tables follow at the given byte offsets */
+typedef struct _amcbheader {
+
+	char		magic[4];
+	int			version;
+	int			byteorder;
+	int			pointsize;				/* sizeof(POINT3D) of the writer */
+	AMCBSTAMP	asf;					/* Source files the cache was built from */
+	AMCBSTAMP	amc;
+
+	int			bones_enum;
+	int			frames_enum;
+	int			children_enum;			/* Children of the root */
+	int			names_len;				/* Bytes in the names table */
+	POINT3D		init_position;
+	POINT3D		init_orientation;
+
+	unsigned long long	off_bones;		/* AMCBBONE[bones_enum] */
+	unsigned long long	off_children;	/* int[] - root's children, then each bone's children in bone order */
+	unsigned long long	off_names;		/* Null terminated bone names back to back */
+	unsigned long long	off_rootpos;	/* POINT3D[frames_enum] */
+	unsigned long long	off_rootorient;	/* POINT3D[frames_enum] */
+	unsigned long long	off_slab;		/* POINT3D[frames_enum*bones_enum] */
+	unsigned long long	filesize;
+
+} AMCBHEADER;
+
+/* One bone of the skeleton with its pointers replaced by indices */
+typedef struct _amcbbone {
+
+	int		id;
+	int		parent;				/* Index into the bone table, -1 for children of the root */
+	int		xyzflags;
+	int		children_enum;
+	int		children_first;		/* Index of the first child in the children table */
+	int		name;				/* Offset into the names table */
+	POINT3D	direction;			/* Already rotated into the local/axis coord system */
+	POINT3D	asfdirection;		/* As given in the ASF file */
+	float	length;
+	POINT3D	axis;
+
+} AMCBBONE;
+
+
+unsigned long long	amcb_align(unsigned long long off);							/* Round a file offset up to AMCB_ALIGN */
+int		amcb_writepad(FILE* fp, unsigned long long* pos, unsigned long long to);	/* Zero fill from *pos up to offset 'to' */
+SKELETON*	amcb_buildskeleton(AMCBHEADER* hdr, char* data);					/* Rebuild a SKELETON from the cached tables */
+int		amcb_checktables(AMCBHEADER* hdr, char* data, unsigned long long size);	/* Non zero if every offset and index stays inside the file and the bones form a tree */
+int		amcb_span(unsigned long long off, unsigned long long count, unsigned long long eltsize, unsigned long long size);	/* Non zero if count elements at off fit in size bytes */
+int		amcb_unchanged(char* filename, AMCBSTAMP* before);					/* Non zero if a file's size and mtime still match a stamp */
+
+
+int amcb_load(char* asfFilename, char* amcFilename, SKELETON** skel, MOCAP** mocap) {
+
+	char		cacheFilename[FILENAME_MAX];
+	AMCBSTAMP	asfstamp,amcstamp;
+	int			stamped;
+
+	amcb_filename(amcFilename,cacheFilename,FILENAME_MAX);
+
+	if (amcb_read(cacheFilename,asfFilename,amcFilename,skel,mocap))
+		return AMCB_OK;
+
+	/* Missing or stale - stamp the sources before parsing them, so a file rewritten
+	   while it is parsed can't end up cached under the new version's stamp */
+	stamped=amcb_stamp(asfFilename,&asfstamp,1) && amcb_stamp(amcFilename,&amcstamp,1);
+
+	if (!(*skel=parser_loadSkeleton(asfFilename)))
+		return AMCB_BADSKEL;
+
+	if (!(*mocap=parser_loadMocapParallel(amcFilename,*skel,0))) {
+		parser_free_skeleton(*skel);
+		*skel=NULL;
+		return AMCB_BADMOCAP;
+	}
+
+	/* Failing to write (e.g. read only directory) just means parsing again next time,
+	   and so does a source that changed under the parser */
+	if (stamped && amcb_unchanged(asfFilename,&asfstamp) && amcb_unchanged(amcFilename,&amcstamp))
+		amcb_write(cacheFilename,&asfstamp,&amcstamp,*skel,*mocap);
+
+	return AMCB_OK;
+
+}
+
+
+void amcb_filename(char* amcFilename, char* cacheFilename, int len) {
+
+	char* ext;
+	char* sep;
+
+	strncpy(cacheFilename,amcFilename,len-6);
+	cacheFilename[len-6]='\0';
+
+	/* Replace the extension (if any) of the file name part */
+	ext=strrchr(cacheFilename,'.');
+	sep=strrchr(cacheFilename,'/');
+	if (!sep || strrchr(cacheFilename,'\\')>sep)
+		sep=strrchr(cacheFilename,'\\');
+	if (ext && (!sep || ext>sep))
+		*ext='\0';
+
+	strcat(cacheFilename,".amcb");
+
+}
+
+
+int amcb_stamp(char* filename, AMCBSTAMP* stamp, int withhash) {
+
+	struct stat st;
+	MAPPEDFILE* mf;
+	unsigned long long h;
+	size_t i;
+
+	if (stat(filename,&st))
+		return 0;
+
+	stamp->size=(unsigned long long)st.st_size;
+#ifdef WIN32
+	stamp->mtime=(long long)st.st_mtime*1000000000LL;
+#elif defined(__APPLE__)
+	stamp->mtime=(long long)st.st_mtimespec.tv_sec*1000000000LL+st.st_mtimespec.tv_nsec;
+#else
+	stamp->mtime=(long long)st.st_mtim.tv_sec*1000000000LL+st.st_mtim.tv_nsec;
+#endif
+	/* A file modified within the filesystem's timestamp resolution of now could be
+	   rewritten again without its mtime moving, so its mtime can't vouch for it later */
+	stamp->racy=(long long)st.st_mtime>=(long long)time(NULL)-AMCB_RACYSECS;
+	stamp->hash=0;
+
+	if (withhash) {
+		if (!(mf=mapfile_open(filename)))
+			return 0;
+		h=14695981039346656037ULL;
+		for (i=0; i<mf->size; i++) {
+			h^=(unsigned char)mf->data[i];
+			h*=1099511628211ULL;
+		}
+		stamp->hash=h;
+		mapfile_close(mf);
+	}
+
+	return 1;
+
+}
+
+
+int amcb_checkstamp(char* filename, AMCBSTAMP* cached) {
+
+	AMCBSTAMP now;
+
+	if (!amcb_stamp(filename,&now,0) || now.size!=cached->size)
+		return 0;
+
+	if (now.mtime==cached->mtime && !cached->racy)
+		return 1;
+
+	/* Touched, copied or stamped too soon after a write - still valid if the contents are the same */
+	if (!amcb_stamp(filename,&now,1))
+		return 0;
+
+	return now.hash==cached->hash;
+
+}
+
+
+int amcb_unchanged(char* filename, AMCBSTAMP* before) {
+
+	AMCBSTAMP now;
+
+	return amcb_stamp(filename,&now,0) && now.size==before->size && now.mtime==before->mtime;
+
+}
+
+
+int amcb_read(char* cacheFilename, char* asfFilename, char* amcFilename, SKELETON** skel, MOCAP** mocap) {
+
+	MAPPEDFILE*	mf;
+	AMCBHEADER*	hdr;
+	MOCAP*		mo;
+	int			i;
+
+	/* Copy-on-write so callers may edit the motion without touching the cache */
+	if (!(mf=mapfile_opencopy(cacheFilename)))
+		return 0;
+
+	hdr=(AMCBHEADER*)mf->data;
+	if (mf->size<sizeof(AMCBHEADER) ||
+		memcmp(hdr->magic,AMCB_MAGIC,4) ||
+		hdr->version!=AMCB_VERSION ||
+		hdr->byteorder!=AMCB_BYTEORDER ||
+		hdr->pointsize!=sizeof(POINT3D) ||
+		hdr->filesize!=mf->size ||
+		!amcb_checktables(hdr,mf->data,mf->size) ||
+		!amcb_checkstamp(asfFilename,&(hdr->asf)) ||
+		!amcb_checkstamp(amcFilename,&(hdr->amc))) {
+		mapfile_close(mf);
+		return 0;
+	}
+
+	*skel=amcb_buildskeleton(hdr,mf->data);
+
+	/* The motion arrays are used straight out of the mapping */
+	mo=(MOCAP*)calloc(1,sizeof(MOCAP));
+	mo->frames_enum=hdr->frames_enum;
+	mo->frames_alloc=hdr->frames_enum;
+	mo->bones_enum=hdr->bones_enum;
+	mo->root_pos=(POINT3D*)(mf->data+hdr->off_rootpos);
+	mo->root_orient=(POINT3D*)(mf->data+hdr->off_rootorient);
+	mo->bones_slab=(POINT3D*)(mf->data+hdr->off_slab);
+	mo->bones_orient=(POINT3D**)malloc(sizeof(POINT3D*)*(hdr->frames_enum ? hdr->frames_enum : 1));
+	for (i=0; i<hdr->frames_enum; i++)
+		mo->bones_orient[i]=mo->bones_slab+(size_t)i*hdr->bones_enum;
+	mo->backing=mf;
+
+	*mocap=mo;
+
+	return 1;
+
+}
+
+
+SKELETON* amcb_buildskeleton(AMCBHEADER* hdr, char* data) {
+
+	SKELETON*	skel;
+	ARENA*		arena;
+	AMCBBONE*	cbones=(AMCBBONE*)(data+hdr->off_bones);
+	int*		children=(int*)(data+hdr->off_children);
+	char*		names=data+hdr->off_names;
+	BONE*		bn;
+	size_t		size;
+	int			i,j,nchild;
+
+	/* Size the arena so the whole skeleton (name lookup included) fits in its first block */
+	nchild=hdr->children_enum;
+	for (i=0; i<hdr->bones_enum; i++)
+		nchild+=cbones[i].children_enum;
+	size=sizeof(SKELETON)+sizeof(BONE)*hdr->bones_enum+hdr->names_len+sizeof(BONE*)*nchild+
+		sizeof(int)*(hdr->bones_enum*4+8)+ARENA_ALIGN*(hdr->bones_enum*2+4);
+	arena=arena_create(size);
+
+	skel=(SKELETON*)arena_calloc(arena,1,sizeof(SKELETON));
+	skel->arena=arena;
+	skel->init_position=hdr->init_position;
+	skel->init_orientation=hdr->init_orientation;
+	skel->bonearray_enum=hdr->bones_enum;
+	skel->bonearray=(BONE*)arena_calloc(arena,hdr->bones_enum ? hdr->bones_enum : 1,sizeof(BONE));
+
+	for (i=0; i<hdr->bones_enum; i++) {
+		bn=skel->bonearray+i;
+		bn->id=cbones[i].id;
+		bn->direction=cbones[i].direction;
+		bn->asfdirection=cbones[i].asfdirection;
+		bn->length=cbones[i].length;
+		bn->axis=cbones[i].axis;
+		bn->xyzflags=cbones[i].xyzflags;
+		bn->parent=(cbones[i].parent<0) ? NULL : skel->bonearray+cbones[i].parent;
+		bn->name=arena_strndup(arena,names+cbones[i].name,strlen(names+cbones[i].name));
+
+		bn->children_enum=cbones[i].children_enum;
+		bn->children=NULL;
+		if (bn->children_enum) {
+			bn->children=(BONE**)arena_alloc(arena,sizeof(BONE*)*bn->children_enum);
+			for (j=0; j<bn->children_enum; j++)
+				bn->children[j]=skel->bonearray+children[cbones[i].children_first+j];
+		}
+	}
+
+	skel->children_enum=hdr->children_enum;
+	skel->children=NULL;
+	if (skel->children_enum) {
+		skel->children=(BONE**)arena_alloc(arena,sizeof(BONE*)*skel->children_enum);
+		for (j=0; j<skel->children_enum; j++)
+			skel->children[j]=skel->bonearray+children[j];
+	}
+
+	parser_indexbones(skel);
+
+	return skel;
+
+}
+
+
+int amcb_checktables(AMCBHEADER* hdr, char* data, unsigned long long size) {
+
+	AMCBBONE*	cbones;
+	int*		children;
+	int*		seen;
+	int			i,j,b,steps,nchild,ok;
+
+	if (hdr->bones_enum<0 || hdr->frames_enum<0 || hdr->children_enum<0 || hdr->names_len<0)
+		return 0;
+
+	/* Every table on its boundary and inside the file */
+	if ((hdr->off_bones|hdr->off_children|hdr->off_names|hdr->off_rootpos|hdr->off_rootorient|hdr->off_slab)&(AMCB_ALIGN-1))
+		return 0;
+	if (!amcb_span(hdr->off_bones,hdr->bones_enum,sizeof(AMCBBONE),size) ||
+		!amcb_span(hdr->off_names,hdr->names_len,1,size) ||
+		!amcb_span(hdr->off_rootpos,hdr->frames_enum,sizeof(POINT3D),size) ||
+		!amcb_span(hdr->off_rootorient,hdr->frames_enum,sizeof(POINT3D),size) ||
+		!amcb_span(hdr->off_slab,(unsigned long long)hdr->frames_enum*hdr->bones_enum,sizeof(POINT3D),size))
+		return 0;
+
+	/* Names are read with strlen, so the table must end on a terminator */
+	if (hdr->names_len && data[hdr->off_names+hdr->names_len-1])
+		return 0;
+
+	/* Every bone is somebody's child at most once, so the children table holds no more than bones_enum */
+	cbones=(AMCBBONE*)(data+hdr->off_bones);
+	nchild=hdr->children_enum;
+	for (i=0; i<hdr->bones_enum; i++) {
+		if (cbones[i].parent<-1 || cbones[i].parent>=hdr->bones_enum ||
+			cbones[i].children_enum<0 || cbones[i].children_enum>hdr->bones_enum ||
+			cbones[i].children_first<0 || cbones[i].children_first>hdr->bones_enum ||
+			cbones[i].name<0 || cbones[i].name>=hdr->names_len)
+			return 0;
+		nchild+=cbones[i].children_enum;
+		if (nchild>hdr->bones_enum)
+			return 0;
+	}
+	if (!amcb_span(hdr->off_children,nchild,sizeof(int),size))
+		return 0;
+
+	/* Each child entry names a bone whose parent lists it, once */
+	children=(int*)(data+hdr->off_children);
+	if (!(seen=(int*)calloc(hdr->bones_enum ? hdr->bones_enum : 1,sizeof(int))))
+		return 0;
+	ok=1;
+	for (j=0; ok && j<hdr->children_enum; j++) {
+		b=children[j];
+		ok=(b>=0 && b<hdr->bones_enum && !seen[b]++ && cbones[b].parent==-1);
+	}
+	for (i=0; ok && i<hdr->bones_enum; i++) {
+		if (cbones[i].children_first+cbones[i].children_enum>nchild) {
+			ok=0;
+			break;
+		}
+		for (j=0; ok && j<cbones[i].children_enum; j++) {
+			b=children[cbones[i].children_first+j];
+			ok=(b>=0 && b<hdr->bones_enum && !seen[b]++ && cbones[b].parent==i);
+		}
+	}
+	free(seen);
+
+	/* No bone is its own ancestor */
+	for (i=0; ok && i<hdr->bones_enum; i++)
+		for (b=cbones[i].parent, steps=0; ok && b!=-1; b=cbones[b].parent)
+			ok=(++steps<=hdr->bones_enum);
+
+	return ok;
+
+}
+
+
+int amcb_span(unsigned long long off, unsigned long long count, unsigned long long eltsize, unsigned long long size) {
+
+	return off<=size && count<=(size-off)/eltsize;
+
+}
+
+
+unsigned long long amcb_align(unsigned long long off) {
+
+	return (off+AMCB_ALIGN-1)&~(unsigned long long)(AMCB_ALIGN-1);
+
+}
+
+
+int amcb_writepad(FILE* fp, unsigned long long* pos, unsigned long long to) {
+
+	static const char zeros[AMCB_ALIGN]={0};
+
+	if (to>*pos && fwrite(zeros,1,(size_t)(to-*pos),fp)!=(size_t)(to-*pos))
+		return 0;
+	*pos=to;
+
+	return 1;
+
+}
+
+
+int amcb_write(char* cacheFilename, AMCBSTAMP* asf, AMCBSTAMP* amc, SKELETON* skel, MOCAP* mocap) {
+
+	char		tmpFilename[FILENAME_MAX+4];
+	FILE*		fp;
+	AMCBHEADER	hdr;
+	AMCBBONE*	cbones;
+	int*		children;
+	char*		names;
+	BONE*		bn;
+	unsigned long long pos;
+	int			i,j,nchild,namepos;
+	int			ok;
+	size_t		slabbytes;
+
+	memset(&hdr,0,sizeof(AMCBHEADER));
+	memcpy(hdr.magic,AMCB_MAGIC,4);
+	hdr.version=AMCB_VERSION;
+	hdr.byteorder=AMCB_BYTEORDER;
+	hdr.pointsize=sizeof(POINT3D);
+	hdr.asf=*asf;
+	hdr.amc=*amc;
+
+	hdr.bones_enum=skel->bonearray_enum;
+	hdr.frames_enum=mocap->frames_enum;
+	hdr.children_enum=skel->children_enum;
+	hdr.init_position=skel->init_position;
+	hdr.init_orientation=skel->init_orientation;
+
+	/* Flatten the bone tree into index based tables */
+	nchild=skel->children_enum;
+	hdr.names_len=0;
+	for (i=0; i<skel->bonearray_enum; i++) {
+		nchild+=skel->bonearray[i].children_enum;
+		hdr.names_len+=strlen(skel->bonearray[i].name ? skel->bonearray[i].name : "")+1;
+	}
+
+	cbones=(AMCBBONE*)calloc(skel->bonearray_enum ? skel->bonearray_enum : 1,sizeof(AMCBBONE));
+	children=(int*)malloc(sizeof(int)*(nchild ? nchild : 1));
+	names=(char*)malloc(hdr.names_len ? hdr.names_len : 1);
+
+	for (j=0; j<skel->children_enum; j++)
+		children[j]=skel->children[j]-skel->bonearray;
+	nchild=skel->children_enum;
+	namepos=0;
+	for (i=0; i<skel->bonearray_enum; i++) {
+		bn=skel->bonearray+i;
+		cbones[i].id=bn->id;
+		cbones[i].parent=bn->parent ? bn->parent-skel->bonearray : -1;
+		cbones[i].xyzflags=bn->xyzflags;
+		cbones[i].direction=bn->direction;
+		cbones[i].asfdirection=bn->asfdirection;
+		cbones[i].length=bn->length;
+		cbones[i].axis=bn->axis;
+		cbones[i].children_enum=bn->children_enum;
+		cbones[i].children_first=nchild;
+		for (j=0; j<bn->children_enum; j++)
+			children[nchild++]=bn->children[j]-skel->bonearray;
+		cbones[i].name=namepos;
+		strcpy(names+namepos,bn->name ? bn->name : "");
+		namepos+=strlen(names+namepos)+1;
+	}
+
+	/* Lay the tables out one after the other */
+	slabbytes=sizeof(POINT3D)*(size_t)mocap->frames_enum*mocap->bones_enum;
+	hdr.off_bones=amcb_align(sizeof(AMCBHEADER));
+	hdr.off_children=amcb_align(hdr.off_bones+sizeof(AMCBBONE)*skel->bonearray_enum);
+	hdr.off_names=amcb_align(hdr.off_children+sizeof(int)*nchild);
+	hdr.off_rootpos=amcb_align(hdr.off_names+hdr.names_len);
+	hdr.off_rootorient=amcb_align(hdr.off_rootpos+sizeof(POINT3D)*mocap->frames_enum);
+	hdr.off_slab=amcb_align(hdr.off_rootorient+sizeof(POINT3D)*mocap->frames_enum);
+	hdr.filesize=hdr.off_slab+slabbytes;
+
+	/* Write to a temporary file and rename so a reader never sees half a cache */
+	sprintf(tmpFilename,"%s.tmp",cacheFilename);
+	ok=0;
+	if ((fp=fopen(tmpFilename,"wb"))) {
+		pos=0;
+		ok=fwrite(&hdr,sizeof(AMCBHEADER),1,fp)==1;
+		pos=sizeof(AMCBHEADER);
+		ok=ok && amcb_writepad(fp,&pos,hdr.off_bones) && (!skel->bonearray_enum || fwrite(cbones,sizeof(AMCBBONE)*skel->bonearray_enum,1,fp)==1);
+		pos+=sizeof(AMCBBONE)*skel->bonearray_enum;
+		ok=ok && amcb_writepad(fp,&pos,hdr.off_children) && (!nchild || fwrite(children,sizeof(int)*nchild,1,fp)==1);
+		pos+=sizeof(int)*nchild;
+		ok=ok && amcb_writepad(fp,&pos,hdr.off_names) && (!hdr.names_len || fwrite(names,hdr.names_len,1,fp)==1);
+		pos+=hdr.names_len;
+		ok=ok && amcb_writepad(fp,&pos,hdr.off_rootpos) && (!mocap->frames_enum || fwrite(mocap->root_pos,sizeof(POINT3D)*mocap->frames_enum,1,fp)==1);
+		pos+=sizeof(POINT3D)*mocap->frames_enum;
+		ok=ok && amcb_writepad(fp,&pos,hdr.off_rootorient) && (!mocap->frames_enum || fwrite(mocap->root_orient,sizeof(POINT3D)*mocap->frames_enum,1,fp)==1);
+		pos+=sizeof(POINT3D)*mocap->frames_enum;
+		ok=ok && amcb_writepad(fp,&pos,hdr.off_slab) && (!slabbytes || fwrite(mocap->bones_slab,slabbytes,1,fp)==1);
+		ok=(fclose(fp)==0) && ok;
+
+		if (ok) {
+			/* Windows won't rename over an existing file */
+			remove(cacheFilename);
+			ok=!rename(tmpFilename,cacheFilename);
+		}
+		if (!ok)
+			remove(tmpFilename);
+	}
+
+	free(cbones);
+	free(children);
+	free(names);
+
+	return ok;
+
+}
@@ -0,0 +1,49 @@
+#ifndef COLLOMOSSE_MOCAP_AMCB_INCLUDED
+#define COLLOMOSSE_MOCAP_AMCB_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  AMCB.H                                               *
+*  Binary motion cache (.amcb sidecar files)            *
+*                                                       *
+*  Stores a parsed skeleton and motion slab next to the *
+*  AMC file so later runs can map it instead of parsing *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "parser.h"
+#include "mapfile.h"
+
+/* Bump whenever the file layout or the parsers' output changes - older caches are then rebuilt */
+#define AMCB_VERSION		(3)
+
+/* Seconds either side of a write within which an mtime can't be trusted (FAT stores two second times) */
+#define AMCB_RACYSECS		(2)
+
+/* Return codes for amcb_load */
+#define AMCB_OK				(0)
+#define AMCB_BADSKEL		(1)		/* Cache stale/missing and the ASF file failed to parse */
+#define AMCB_BADMOCAP		(2)		/* Cache stale/missing and the AMC file failed to parse */
+
+/* Identifies the exact version of a source file a cache was built from */
+typedef struct _amcbstamp {
+
+	unsigned long long	size;		/* File length in bytes */
+	long long			mtime;		/* Last modification time (nanoseconds, whole seconds on WIN32) */
+	long long			racy;		/* Non zero if stamped so soon after a write that the mtime alone proves nothing */
+	unsigned long long	hash;		/* FNV-1a hash of the whole file, 0 until computed */
+
+} AMCBSTAMP;
+
+
+int		amcb_load(char* asfFilename, char* amcFilename, SKELETON** skel, MOCAP** mocap);	/* Load from the sidecar if it is up to date, otherwise parse and rewrite it */
+int		amcb_read(char* cacheFilename, char* asfFilename, char* amcFilename, SKELETON** skel, MOCAP** mocap);	/* Map a sidecar - 0 if missing, stale or corrupt */
+int		amcb_write(char* cacheFilename, AMCBSTAMP* asf, AMCBSTAMP* amc, SKELETON* skel, MOCAP* mocap);	/* Write a sidecar for a pair parsed after taking these stamps (with hash) - 0 on failure */
+void	amcb_filename(char* amcFilename, char* cacheFilename, int len);	/* Sidecar name for an AMC file e.g. walk.amc -> walk.amcb */
+int		amcb_stamp(char* filename, AMCBSTAMP* stamp, int withhash);		/* Size and mtime (and hash if asked) of a file - 0 on failure */
+int		amcb_checkstamp(char* filename, AMCBSTAMP* cached);				/* Non zero if a source file still matches its stamp */
+
+#endif
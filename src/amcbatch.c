@@ -0,0 +1,84 @@
+/*******************************************************\
+*                                                       *
+*  AMCBATCH.C                                           *
+*  Batch ingestion of ASF/AMC datasets                  *
+*                                                       *
+*  Parses every pair in a directory or manifest with    *
+*  batch.c and reports the throughput of each file and  *
+*  of the whole dataset                                 *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "batch.h"
+#include "threadpool.h"
+
+#define EXITCODE_SUCCESS	(0)
+#define EXITCODE_BADSYNTAX	(1)
+#define EXITCODE_BADINPUT	(2)
+#define EXITCODE_FAILURES	(3)
+
+#define BYTES_PER_MB		(1024.0*1024.0)
+
+
+int main (int argc, char** argv) {
+
+	struct stat	st;
+	BATCH*		batch;
+	BATCHITEM*	item;
+	int			threads=0;
+	int			failed=0;
+	int			i;
+
+	if (argc<2 || argc>3) {
+		printf("Use AMCBATCH <directory or manifest file> [threads, default one per CPU]\n");
+		return (EXITCODE_BADSYNTAX);
+	}
+
+	if (argc==3)
+		threads=atoi(argv[2]);
+
+	if (stat(argv[1],&st)) {
+		printf("FATAL:  Cannot open %s\n",argv[1]);
+		return (EXITCODE_BADINPUT);
+	}
+	batch=(st.st_mode & S_IFDIR) ? batch_fromDirectory(argv[1]) : batch_fromManifest(argv[1]);
+	if (!batch) {
+		printf("FATAL:  Cannot read %s\n",argv[1]);
+		return (EXITCODE_BADINPUT);
+	}
+
+	batch_load(batch,threads,0);
+
+	for (i=0; i<batch->items_enum; i++) {
+		item=batch->items+i;
+		switch (item->status) {
+			case BATCH_OK:
+				printf("%-40s %7d frames %8.2f MB %9.3f ms %8.2f MB/s\n",item->amcFilename,item->frames_enum,
+					item->bytes/BYTES_PER_MB,item->seconds*1000.0,item->seconds>0 ? item->bytes/BYTES_PER_MB/item->seconds : 0);
+				break;
+			case BATCH_BADSKEL:
+				printf("%-40s FAILED - cannot parse %s\n",item->amcFilename,item->asfFilename);
+				failed++;
+				break;
+			default:
+				printf("%-40s FAILED - cannot parse AMC file\n",item->amcFilename);
+				failed++;
+				break;
+		}
+	}
+
+	printf("\n%d pairs (%d failed), %d distinct skeletons\n",batch->items_enum,failed,batch->skeletons_enum);
+	printf("%.2f MB in %.3f s on %d threads - %.2f MB/s\n",batch->bytes/BYTES_PER_MB,batch->seconds,
+		threads>0 ? threads : threadpool_cpucount(),batch->seconds>0 ? batch->bytes/BYTES_PER_MB/batch->seconds : 0);
+
+	batch_free(batch);
+
+	return failed ? (EXITCODE_FAILURES) : (EXITCODE_SUCCESS);
+
+}
@@ -0,0 +1,325 @@
+/*******************************************************\
+*                                                       *
+*  AMCBENCH.C                                           *
+*  Benchmark for the AMC loaders                        *
+*                                                       *
+*  Times parser_loadMocap (fgets) against               *
+*  parser_loadMocapMapped (mmap) and                    *
+*  parser_loadMocapParallel (mmap, all cores) on an AMC *
+*  file and on a synthetic file made by repeating its   *
+*  frames                                               *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "parser.h"
+#include "mapfile.h"
+#include "timer.h"
+#include "threadpool.h"
+#include "amci.h"
+
+#define EXITCODE_SUCCESS	(0)
+#define EXITCODE_BADSYNTAX	(1)
+#define EXITCODE_BADSKEL	(2)
+#define EXITCODE_BADMOCAP	(3)
+#define EXITCODE_MISMATCH	(4)
+
+#define BENCH_RUNS			(5)			/* Each loader is timed this many times, the best run is reported */
+#define BENCH_SCALE			(100)		/* Default number of copies of the clip in the synthetic file */
+#define BENCH_WINDOW		(600)		/* Frames loaded through the frame offset index */
+#define BENCH_SYNTHFILE		"amcbench_synthetic.amc"
+
+typedef MOCAP* (*LOADER)(char*, SKELETON*);
+
+double	bench_loader(LOADER loader, char* amcfile, SKELETON* skel, MOCAP** result);	/* Best of BENCH_RUNS wall time in seconds */
+int		bench_compare(MOCAP* a, MOCAP* b, int bones);								/* Non zero if both clips hold identical data */
+int		bench_synthesize(char* amcfile, char* outfile, int copies);					/* Write copies of amcfile's frames back to back */
+int		bench_run(char* label, char* amcfile, SKELETON* skel);						/* Time and cross check the loaders on one file */
+MOCAP*	bench_loadparallel(char* amcfile, SKELETON* skel);							/* parser_loadMocapParallel on every CPU */
+double	bench_stream(char* amcfile, SKELETON* skel, MOCAP* expect, int* same);		/* Time a pass of parser_nextFrame, checking each frame against 'expect' */
+double	bench_window(char* amcfile, SKELETON* skel, MOCAP* expect, double* tindex, int* same);	/* Time amci_loadrange on BENCH_WINDOW frames from the middle of the clip */
+
+
+int main (int argc, char** argv) {
+
+	SKELETON*	skel;
+	int			copies=BENCH_SCALE;
+	int			ok;
+
+	if (argc<3 || argc>4) {
+		printf("Use AMCBENCH <asf file> <amc file> [synthetic scale, default %d]\n",BENCH_SCALE);
+		return (EXITCODE_BADSYNTAX);
+	}
+
+	if (argc==4)
+		copies=atoi(argv[3]);
+
+	if (!(skel=parser_loadSkeleton(argv[1]))) {
+		printf("FATAL:  Failed to load skeleton from file\n");
+		return (EXITCODE_BADSKEL);
+	}
+
+	if (!(ok=bench_run(argv[2],argv[2],skel))) {
+		parser_free_skeleton(skel);
+		return (EXITCODE_MISMATCH);
+	}
+
+	if (copies>1) {
+		if (!bench_synthesize(argv[2],BENCH_SYNTHFILE,copies)) {
+			printf("FATAL:  Failed to write synthetic file %s\n",BENCH_SYNTHFILE);
+			parser_free_skeleton(skel);
+			return (EXITCODE_BADMOCAP);
+		}
+		printf("\nSynthetic file (%dx):\n",copies);
+		ok=bench_run(BENCH_SYNTHFILE,BENCH_SYNTHFILE,skel);
+		remove(BENCH_SYNTHFILE);
+	}
+
+	parser_free_skeleton(skel);
+
+	return ok ? (EXITCODE_SUCCESS) : (EXITCODE_MISMATCH);
+}
+
+
+int bench_run(char* label, char* amcfile, SKELETON* skel) {
+
+	MOCAP*	fgetsmo;
+	MOCAP*	mappedmo;
+	MOCAP*	parallelmo;
+	double	tfgets, tmapped, tparallel, tstream, tindex, twindow;
+	int		same, streamsame, windowsame;
+
+	tfgets=bench_loader(parser_loadMocap,amcfile,skel,&fgetsmo);
+	tmapped=bench_loader(parser_loadMocapMapped,amcfile,skel,&mappedmo);
+	tparallel=bench_loader(bench_loadparallel,amcfile,skel,&parallelmo);
+
+	if (!fgetsmo || !mappedmo || !parallelmo) {
+		printf("FATAL:  Failed to load mocap data from %s\n",amcfile);
+		return 0;
+	}
+
+	same=bench_compare(fgetsmo,mappedmo,skel->bonearray_enum) && bench_compare(fgetsmo,parallelmo,skel->bonearray_enum);
+	tstream=bench_stream(amcfile,skel,fgetsmo,&streamsame);
+	twindow=bench_window(amcfile,skel,fgetsmo,&tindex,&windowsame);
+
+	printf("%s: %d frames\n",label,fgetsmo->frames_enum);
+	printf("  fgets    loader  %10.3f ms\n",tfgets*1000.0);
+	printf("  mapped   loader  %10.3f ms  (%.2fx)\n",tmapped*1000.0,tfgets/tmapped);
+	printf("  parallel loader  %10.3f ms  (%.2fx, %d threads)\n",tparallel*1000.0,tfgets/tparallel,threadpool_cpucount());
+	printf("  stream   pass    %10.3f ms  (%.2fx, one frame in memory)\n",tstream*1000.0,tfgets/tstream);
+	printf("  index    scan    %10.3f ms  (once, then kept in the .amci sidecar)\n",tindex*1000.0);
+	printf("  indexed  window  %10.3f ms  (%d frames)\n",twindow*1000.0,BENCH_WINDOW<fgetsmo->frames_enum ? BENCH_WINDOW : fgetsmo->frames_enum);
+	printf("  results %s\n",(same && streamsame && windowsame) ? "identical" : "DIFFER");
+
+	parser_free_mocap(fgetsmo);
+	parser_free_mocap(mappedmo);
+	parser_free_mocap(parallelmo);
+
+	return same && streamsame && windowsame;
+
+}
+
+
+MOCAP* bench_loadparallel(char* amcfile, SKELETON* skel) {
+
+	return parser_loadMocapParallel(amcfile,skel,0);
+
+}
+
+
+double bench_stream(char* amcfile, SKELETON* skel, MOCAP* expect, int* same) {
+
+	AMCSTREAM*	stream;
+	AMCFRAME	frame;
+	double		t;
+	int			i=0;
+
+	*same=0;
+	if (!(stream=parser_openMocapStream(amcfile,skel)))
+		return 0;
+
+	frame.bones_orient=(POINT3D*)malloc(sizeof(POINT3D)*skel->bonearray_enum);
+
+	/* Frames come back in file order, which matches the loaded clip for a well formed file */
+	*same=1;
+	t=timer_seconds();
+	while (parser_nextFrame(stream,&frame)) {
+		if (i>=expect->frames_enum || frame.frame!=i+1 ||
+			memcmp(&(frame.root_pos),expect->root_pos+i,sizeof(POINT3D)) ||
+			memcmp(&(frame.root_orient),expect->root_orient+i,sizeof(POINT3D)) ||
+			memcmp(frame.bones_orient,expect->bones_orient[i],sizeof(POINT3D)*skel->bonearray_enum))
+			*same=0;
+		i++;
+	}
+	t=timer_seconds()-t;
+
+	if (i!=expect->frames_enum)
+		*same=0;
+
+	free(frame.bones_orient);
+	parser_closeMocapStream(stream);
+
+	return t;
+
+}
+
+
+double bench_loader(LOADER loader, char* amcfile, SKELETON* skel, MOCAP** result) {
+
+	double	best=-1, t;
+	int		i;
+
+	*result=NULL;
+	for (i=0; i<BENCH_RUNS; i++) {
+		if (*result)
+			parser_free_mocap(*result);
+
+		t=timer_seconds();
+		*result=loader(amcfile,skel);
+		t=timer_seconds()-t;
+
+		if (best<0 || t<best)
+			best=t;
+	}
+
+	return best;
+
+}
+
+
+int bench_compare(MOCAP* a, MOCAP* b, int bones) {
+
+	int i;
+
+	if (a->frames_enum!=b->frames_enum)
+		return 0;
+
+	for (i=0; i<a->frames_enum; i++) {
+		if (memcmp(a->root_pos+i,b->root_pos+i,sizeof(POINT3D)) ||
+			memcmp(a->root_orient+i,b->root_orient+i,sizeof(POINT3D)) ||
+			memcmp(a->bones_orient[i],b->bones_orient[i],sizeof(POINT3D)*bones))
+			return 0;
+	}
+
+	return 1;
+
+}
+
+
+int bench_synthesize(char* amcfile, char* outfile, int copies) {
+
+	MAPPEDFILE*	mf;
+	FILE*		fp;
+	const char*	body;		/* first frame number line, everything before it is header */
+	const char*	end;
+	const char*	p;
+	const char*	eol;
+	int			frames;		/* frames in one copy of the clip */
+	int			copy, frm;
+
+	if (!(mf=mapfile_open(amcfile)))
+		return 0;
+	if (!(fp=fopen(outfile,"wb"))) {
+		mapfile_close(mf);
+		return 0;
+	}
+
+	/* Find the first frame number line and count the frames in the clip */
+	body=NULL;
+	frames=0;
+	end=mf->data+mf->size;
+	for (p=mf->data; p<end; p=eol+1) {
+		eol=(const char*)memchr(p,'\n',end-p);
+		if (!eol)
+			eol=end;
+		if (*p>='0' && *p<='9') {
+			if (!body)
+				body=p;
+			frames=atoi(p);
+		}
+	}
+
+	if (!body || frames<1) {
+		fclose(fp);
+		mapfile_close(mf);
+		return 0;
+	}
+
+	fwrite(mf->data,1,body-mf->data,fp);
+
+	/* Append the frames over and over, renumbering so the sequence stays continuous */
+	for (copy=0; copy<copies; copy++) {
+		for (p=body; p<end; p=eol+1) {
+			eol=(const char*)memchr(p,'\n',end-p);
+			if (!eol)
+				eol=end;
+			if (*p>='0' && *p<='9') {
+				frm=atoi(p)+copy*frames;
+				fprintf(fp,"%d\n",frm);
+			}
+			else {
+				fwrite(p,1,eol-p,fp);
+				fputc('\n',fp);
+			}
+			if (eol==end)
+				break;
+		}
+	}
+
+	fclose(fp);
+	mapfile_close(mf);
+
+	return 1;
+
+}
+
+
+double bench_window(char* amcfile, SKELETON* skel, MOCAP* expect, double* tindex, int* same) {
+
+	AMCINDEX*	idx;
+	MOCAP*		window;
+	MOCAP		view;
+	double		start, best=0, t;
+	int			first, run;
+
+	*same=0;
+
+	/* Built in memory rather than with amci_open so no sidecar is left behind */
+	start=timer_seconds();
+	idx=amci_build(amcfile);
+	*tindex=timer_seconds()-start;
+	if (!idx)
+		return 0;
+
+	first=expect->frames_enum>BENCH_WINDOW ? (expect->frames_enum-BENCH_WINDOW)/2+1 : 1;
+	for (run=0; run<BENCH_RUNS; run++) {
+		start=timer_seconds();
+		window=amci_loadrange(idx,amcfile,skel,first,BENCH_WINDOW,1);
+		t=timer_seconds()-start;
+		if (!window) {
+			amci_free(idx);
+			return 0;
+		}
+		if (!run || t<best)
+			best=t;
+
+		/* Compare against the matching frames of the full load */
+		view=*expect;
+		view.frames_enum=window->frames_enum;
+		view.root_pos+=first-1;
+		view.root_orient+=first-1;
+		view.bones_orient+=first-1;
+		*same=bench_compare(&view,window,skel->bonearray_enum);
+		parser_free_mocap(window);
+	}
+
+	amci_free(idx);
+
+	return best;
+
+}
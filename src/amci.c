@@ -0,0 +1,220 @@
+/*******************************************************\
+*                                                       *
+*  AMCI.C                                               *
+*  Frame offset index (.amci sidecar files)             *
+*                                                       *
+*  Records where each frame starts in an AMC file so a  *
+*  range or strided subset of frames can be loaded by   *
+*  seeking instead of parsing from the top              *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "amci.h"
+
+#define AMCI_MAGIC			"AMCI"
+#define AMCI_BYTEORDER		(0x01020304)	/* Reads back differently on a machine of the other endianness */
+
+/* File header - long long offsets[frames_enum] follow straight after */
+typedef struct _amciheader {
+
+	char		magic[4];
+	int			version;
+	int			byteorder;
+	int			frames_enum;
+	AMCBSTAMP	amc;					/* Source file the index was built from */
+
+} AMCIHEADER;
+
+
+AMCINDEX* amci_open(char* amcFilename) {
+
+	char		indexFilename[FILENAME_MAX];
+	AMCINDEX*	idx;
+
+	amci_filename(amcFilename,indexFilename,FILENAME_MAX);
+
+	if ((idx=amci_read(indexFilename,amcFilename)))
+		return idx;
+
+	/* Missing or stale - scan the AMC file */
+	if (!(idx=amci_build(amcFilename)))
+		return NULL;
+
+	/* Failing to write (e.g. read only directory) just means scanning again next time */
+	amci_write(indexFilename,amcFilename,idx);
+
+	return idx;
+
+}
+
+
+void amci_filename(char* amcFilename, char* indexFilename, int len) {
+
+	/* Same rules as the .amcb cache, walk.amcb -> walk.amci */
+	amcb_filename(amcFilename,indexFilename,len);
+	indexFilename[strlen(indexFilename)-1]='i';
+
+}
+
+
+AMCINDEX* amci_read(char* indexFilename, char* amcFilename) {
+
+	MAPPEDFILE*	mf;
+	AMCIHEADER*	hdr;
+	AMCINDEX*	idx;
+
+	if (!(mf=mapfile_open(indexFilename)))
+		return NULL;
+
+	/* Only the header is touched here - offsets are paged in as frames are looked up */
+	hdr=(AMCIHEADER*)mf->data;
+	if (mf->size<sizeof(AMCIHEADER) ||
+		memcmp(hdr->magic,AMCI_MAGIC,4) ||
+		hdr->version!=AMCI_VERSION ||
+		hdr->byteorder!=AMCI_BYTEORDER ||
+		hdr->frames_enum<0 ||
+		mf->size!=sizeof(AMCIHEADER)+sizeof(long long)*(size_t)hdr->frames_enum ||
+		!amcb_checkstamp(amcFilename,&(hdr->amc))) {
+		mapfile_close(mf);
+		return NULL;
+	}
+
+	idx=(AMCINDEX*)calloc(1,sizeof(AMCINDEX));
+	idx->frames_enum=hdr->frames_enum;
+	idx->offsets=(long long*)(mf->data+sizeof(AMCIHEADER));
+	idx->backing=mf;
+
+	return idx;
+
+}
+
+
+AMCINDEX* amci_build(char* amcFilename) {
+
+	AMCINDEX*	idx;
+	long long*	offsets;
+	int			frames;
+
+	if (!(offsets=parser_indexMocap(amcFilename,&frames)))
+		return NULL;
+
+	idx=(AMCINDEX*)calloc(1,sizeof(AMCINDEX));
+	idx->frames_enum=frames;
+	idx->offsets=offsets;
+
+	return idx;
+
+}
+
+
+int amci_write(char* indexFilename, char* amcFilename, AMCINDEX* idx) {
+
+	char		tmpFilename[FILENAME_MAX+4];
+	FILE*		fp;
+	AMCIHEADER	hdr;
+	int			ok;
+
+	memset(&hdr,0,sizeof(AMCIHEADER));
+	memcpy(hdr.magic,AMCI_MAGIC,4);
+	hdr.version=AMCI_VERSION;
+	hdr.byteorder=AMCI_BYTEORDER;
+	hdr.frames_enum=idx->frames_enum;
+	if (!amcb_stamp(amcFilename,&(hdr.amc),1))
+		return 0;
+
+	/* Write to a temporary file and rename so a reader never sees half an index */
+	sprintf(tmpFilename,"%s.tmp",indexFilename);
+	if (!(fp=fopen(tmpFilename,"wb")))
+		return 0;
+
+	ok=fwrite(&hdr,sizeof(AMCIHEADER),1,fp)==1;
+	ok=ok && (!idx->frames_enum || fwrite(idx->offsets,sizeof(long long)*idx->frames_enum,1,fp)==1);
+	ok=(fclose(fp)==0) && ok;
+
+	if (ok) {
+		/* Windows won't rename over an existing file */
+		remove(indexFilename);
+		ok=!rename(tmpFilename,indexFilename);
+	}
+	if (!ok)
+		remove(tmpFilename);
+
+	return ok;
+
+}
+
+
+MOCAP* amci_loadrange(AMCINDEX* idx, char* amcFilename, SKELETON* skel, int first, int count, int stride) {
+
+	AMCSTREAM*	stream;
+	AMCFRAME	frame;
+	MOCAP*		mocap;
+	int			i,f;
+
+	if (first<1 || count<0 || stride<1)
+		return NULL;
+
+	/* Clip the window to the frames in the file */
+	if (first>idx->frames_enum)
+		count=0;
+	else if (count>(idx->frames_enum-first)/stride+1)
+		count=(idx->frames_enum-first)/stride+1;
+
+	if (!(stream=parser_openMocapStream(amcFilename,skel)))
+		return NULL;
+
+	mocap=(MOCAP*)calloc(1,sizeof(MOCAP));
+	mocap->frames_enum=count;
+	mocap->frames_alloc=count ? count : 1;
+	mocap->bones_enum=skel->bonearray_enum;
+	mocap->root_pos=(POINT3D*)calloc(mocap->frames_alloc,sizeof(POINT3D));
+	mocap->root_orient=(POINT3D*)calloc(mocap->frames_alloc,sizeof(POINT3D));
+	mocap->bones_slab=(POINT3D*)calloc((size_t)mocap->frames_alloc*(mocap->bones_enum ? mocap->bones_enum : 1),sizeof(POINT3D));
+	mocap->bones_orient=(POINT3D**)malloc(sizeof(POINT3D*)*mocap->frames_alloc);
+	for (i=0; i<mocap->frames_alloc; i++)
+		mocap->bones_orient[i]=mocap->bones_slab+(size_t)i*mocap->bones_enum;
+
+	for (i=0; i<count; i++) {
+		f=first+i*stride;
+
+		/* Frames missing from the file stay zero, as they do in parser_loadMocap */
+		if (idx->offsets[f-1]==-1)
+			continue;
+
+		/* Consecutive frames are read straight on, anything else is a seek */
+		if (stream->pending!=f && !parser_seekMocapStream(stream,idx->offsets[f-1]))
+			break;
+
+		frame.bones_orient=mocap->bones_orient[i];
+		if (!parser_nextFrame(stream,&frame) || frame.frame!=f)
+			break;
+		mocap->root_pos[i]=frame.root_pos;
+		mocap->root_orient[i]=frame.root_orient;
+	}
+
+	parser_closeMocapStream(stream);
+
+	/* The index no longer matches the file */
+	if (i<count) {
+		parser_free_mocap(mocap);
+		return NULL;
+	}
+
+	return mocap;
+
+}
+
+
+void amci_free(AMCINDEX* idx) {
+
+	if (idx->backing)
+		mapfile_close(idx->backing);
+	else
+		free(idx->offsets);
+	free(idx);
+
+}
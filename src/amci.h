@@ -0,0 +1,43 @@
+#ifndef COLLOMOSSE_MOCAP_AMCI_INCLUDED
+#define COLLOMOSSE_MOCAP_AMCI_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  AMCI.H                                               *
+*  Frame offset index (.amci sidecar files)             *
+*                                                       *
+*  Records where each frame starts in an AMC file so a  *
+*  range or strided subset of frames can be loaded by   *
+*  seeking instead of parsing from the top              *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "parser.h"
+#include "mapfile.h"
+#include "amcb.h"
+
+/* Bump whenever the file layout changes - older indexes are then rebuilt */
+#define AMCI_VERSION		(2)
+
+/* Type for the frame offsets of one AMC file */
+typedef struct _amcindex {
+
+	int			frames_enum;	/* Highest frame number in the file */
+	long long*	offsets;		/* offsets[frame-1] - byte offset of the frame number line, -1 if the frame is missing */
+	MAPPEDFILE*	backing;		/* Sidecar the offsets are mapped from, NULL if they were built in memory */
+
+} AMCINDEX;
+
+
+AMCINDEX*	amci_open(char* amcFilename);								/* Map the sidecar if it is up to date, otherwise scan the AMC file and rewrite it */
+AMCINDEX*	amci_read(char* indexFilename, char* amcFilename);			/* Map a sidecar - NULL if missing, stale or corrupt */
+AMCINDEX*	amci_build(char* amcFilename);								/* Scan an AMC file for its frame offsets - NULL on failure */
+int			amci_write(char* indexFilename, char* amcFilename, AMCINDEX* idx);	/* Write a sidecar - 0 on failure */
+void		amci_filename(char* amcFilename, char* indexFilename, int len);	/* Sidecar name for an AMC file e.g. walk.amc -> walk.amci */
+MOCAP*		amci_loadrange(AMCINDEX* idx, char* amcFilename, SKELETON* skel, int first, int count, int stride);	/* Frames first, first+stride, ... (1 based, at most count of them) - NULL on failure */
+void		amci_free(AMCINDEX* idx);
+
+#endif
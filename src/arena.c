@@ -0,0 +1,123 @@
+/*******************************************************\
+*                                                       *
+*  ARENA.C                                              *
+*  Region (bump pointer) allocator                      *
+*                                                       *
+*  Hands out memory from a few large blocks that are    *
+*  all released together - used for skeletons, which   *
+*  are built once and freed as a whole                  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "arena.h"
+
+/* Header rounded up so the first allocation of a block is aligned */
+#define ARENA_HEADER		((sizeof(ARENABLOCK)+ARENA_ALIGN-1)&~(size_t)(ARENA_ALIGN-1))
+#define ARENA_ROUND(n)		(((n)+ARENA_ALIGN-1)&~(size_t)(ARENA_ALIGN-1))
+
+ARENABLOCK*	arena_newblock(ARENABLOCK* next, size_t size);	/* malloc a block able to hold 'size' bytes */
+
+
+ARENA* arena_create(size_t size) {
+
+	ARENABLOCK*	block;
+	ARENA*		arena;
+
+	if (!size)
+		size=ARENA_BLOCKSIZE;
+
+	/* The arena's own header is the first allocation of its first block */
+	size+=ARENA_ROUND(sizeof(ARENA));
+	if (!(block=arena_newblock(NULL,size)))
+		return NULL;
+
+	arena=(ARENA*)((char*)block+ARENA_HEADER);
+	block->used=ARENA_ROUND(sizeof(ARENA));
+	arena->current=block;
+	arena->nextsize=size*2;
+
+	return arena;
+
+}
+
+void* arena_alloc(ARENA* arena, size_t bytes) {
+
+	ARENABLOCK*	block=arena->current;
+	void*		p;
+
+	bytes=ARENA_ROUND(bytes);
+
+	if (block->size-block->used<bytes) {
+		/* Whatever is left of the current block is abandoned */
+		while (arena->nextsize<bytes)
+			arena->nextsize*=2;
+		if (!(block=arena_newblock(block,arena->nextsize)))
+			return NULL;
+		arena->current=block;
+		arena->nextsize*=2;
+	}
+
+	p=(char*)block+ARENA_HEADER+block->used;
+	block->used+=bytes;
+
+	return p;
+
+}
+
+void* arena_calloc(ARENA* arena, size_t count, size_t size) {
+
+	void* p;
+
+	if ((p=arena_alloc(arena,count*size)))
+		memset(p,0,count*size);
+
+	return p;
+
+}
+
+char* arena_strndup(ARENA* arena, const char* s, size_t len) {
+
+	char* p;
+
+	if ((p=(char*)arena_alloc(arena,len+1))) {
+		memcpy(p,s,len);
+		p[len]='\0';
+	}
+
+	return p;
+
+}
+
+void arena_destroy(ARENA* arena) {
+
+	ARENABLOCK*	block=arena->current;
+	ARENABLOCK*	next;
+
+	/* The arena itself goes with the last (first allocated) block */
+	while (block) {
+		next=block->next;
+		free(block);
+		block=next;
+	}
+
+}
+
+
+ARENABLOCK* arena_newblock(ARENABLOCK* next, size_t size) {
+
+	ARENABLOCK* block;
+
+	if (!(block=(ARENABLOCK*)malloc(ARENA_HEADER+size)))
+		return NULL;
+
+	block->next=next;
+	block->size=size;
+	block->used=0;
+
+	return block;
+
+}
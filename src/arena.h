@@ -0,0 +1,48 @@
+#ifndef COLLOMOSSE_MOCAP_ARENA_INCLUDED
+#define COLLOMOSSE_MOCAP_ARENA_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  ARENA.H                                              *
+*  Region (bump pointer) allocator                      *
+*                                                       *
+*  Hands out memory from a few large blocks that are    *
+*  all released together - used for skeletons, which   *
+*  are built once and freed as a whole                  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN			(16)		/* Every allocation starts on this boundary */
+#define ARENA_BLOCKSIZE		(16*1024)	/* Default size of the first block - later blocks double */
+
+/* One block of an arena, the memory handed out follows the header */
+typedef struct _arenablock {
+
+	struct _arenablock*	next;		/* Block allocated before this one, NULL for the first */
+	size_t				size;		/* Bytes after the header */
+	size_t				used;
+
+} ARENABLOCK;
+
+/* Type for representing an arena - it lives in its own first block */
+typedef struct _arena {
+
+	ARENABLOCK*	current;			/* Newest block, allocations are taken from here */
+	size_t		nextsize;			/* Size of the next block if current fills up */
+
+} ARENA;
+
+
+ARENA*	arena_create(size_t size);								/* New arena with room for 'size' bytes in its first block (0 for ARENA_BLOCKSIZE) */
+void*	arena_alloc(ARENA* arena, size_t bytes);				/* Uninitialised memory, valid until arena_destroy */
+void*	arena_calloc(ARENA* arena, size_t count, size_t size);	/* As arena_alloc, zeroed */
+char*	arena_strndup(ARENA* arena, const char* s, size_t len);	/* Null terminated copy of len chars of s */
+void	arena_destroy(ARENA* arena);							/* Free every block (and so everything allocated) at once */
+
+#endif
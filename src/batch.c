@@ -0,0 +1,508 @@
+/*******************************************************\
+*                                                       *
+*  BATCH.C                                              *
+*  Parallel ingestion of whole ASF/AMC datasets         *
+*                                                       *
+*  Parses every pair listed in a manifest or found in a *
+*  directory on the thread pool, parsing identical ASF  *
+*  files once and sharing the skeleton                  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "batch.h"
+#include "amcb.h"
+#include "threadpool.h"
+#include "timer.h"
+
+#ifndef WIN32
+	#include <dirent.h>
+#endif
+
+#define BATCH_LINELEN		(4096)		/* Longest manifest line */
+#define BATCH_INITIAL_ITEMS	(64)		/* Items allocated up front, doubled when full */
+
+/* One distinct ASF file name of a batch */
+typedef struct _batchasf {
+
+	char*		filename;
+	AMCBSTAMP	stamp;			/* Size and contents hash, to find copies under other names */
+	int			ok;				/* Stamp could be taken */
+	int			skeleton;		/* Index into BATCH::skeletons, -1 if the file is unreadable */
+	BATCH*		batch;
+
+} BATCHASF;
+
+/* Argument of an AMC parsing job */
+typedef struct _batchjob {
+
+	BATCH*		batch;
+	BATCHITEM*	item;			/* The pair to parse */
+	int			keep;
+
+} BATCHJOB;
+
+char*	batch_strdup(const char* s);										/* Heap copy of a string */
+char*	batch_join(const char* dir, const char* name);						/* dir/name, or name alone if it is an absolute path */
+int		batch_hasext(const char* name, const char* ext);					/* Non zero if name ends in ext (any case) */
+char**	batch_listdir(char* dirname, int* names_enum);						/* Names of the entries of a directory, NULL if unreadable */
+char*	batch_findasf(char** names, int names_enum, const char* amcname);	/* ASF file to use for an AMC file of a directory */
+int		batch_cmpname(const void* a, const void* b);						/* qsort order of file names */
+int		batch_cmpasfname(const void* a, const void* b);						/* qsort order of BATCHASF* by file name */
+int		batch_cmpasfstamp(const void* a, const void* b);					/* qsort order of BATCHASF* by contents */
+int		batch_cmpjobsize(const void* a, const void* b);						/* qsort order of BATCHJOB, largest AMC file first */
+int		batch_samefile(char* a, char* b);									/* Non zero if two files hold the same bytes */
+void	batch_stampjob(void* arg);											/* Thread pool job - stamp one BATCHASF */
+void	batch_skeljob(void* arg);											/* Thread pool job - parse one distinct ASF file */
+void	batch_mocapjob(void* arg);											/* Thread pool job - parse one AMC file */
+
+
+BATCH* batch_fromManifest(char* manifestFilename) {
+
+	FILE*	fp;
+	BATCH*	batch;
+	char	line[BATCH_LINELEN];
+	char	dir[BATCH_LINELEN];
+	char*	asf;
+	char*	amc;
+	char*	sep;
+	char*	p;
+	char*	asfpath;
+	char*	amcpath;
+
+	if (!(fp=fopen(manifestFilename,"rt")))
+		return NULL;
+
+	/* Relative names are relative to the manifest */
+	strncpy(dir,manifestFilename,BATCH_LINELEN-1);
+	dir[BATCH_LINELEN-1]='\0';
+	sep=strrchr(dir,'/');
+	if (!sep || strrchr(dir,'\\')>sep)
+		sep=strrchr(dir,'\\');
+	if (sep)
+		*sep='\0';
+	else
+		strcpy(dir,".");
+
+	batch=(BATCH*)calloc(1,sizeof(BATCH));
+
+	while (fgets(line,BATCH_LINELEN,fp)) {
+		/* Two whitespace separated names, blank lines and # comments skipped */
+		for (p=line; *p && isspace((unsigned char)*p); p++);
+		if (!*p || *p=='#')
+			continue;
+		for (asf=p; *p && !isspace((unsigned char)*p); p++);
+		if (*p)
+			*p++='\0';
+		for (; *p && isspace((unsigned char)*p); p++);
+		for (amc=p; *p && !isspace((unsigned char)*p); p++);
+		*p='\0';
+		if (!*amc) {
+			printf("WARNING: Manifest line without an AMC file [%s]\n",asf);
+			continue;
+		}
+
+		asfpath=batch_join(dir,asf);
+		amcpath=batch_join(dir,amc);
+		batch_add(batch,asfpath,amcpath);
+		free(asfpath);
+		free(amcpath);
+	}
+
+	fclose(fp);
+
+	return batch;
+
+}
+
+BATCH* batch_fromDirectory(char* dirname) {
+
+	BATCH*	batch;
+	char**	names;
+	char*	asf;
+	char*	asfpath;
+	char*	amcpath;
+	int		names_enum;
+	int		i;
+
+	if (!(names=batch_listdir(dirname,&names_enum)))
+		return NULL;
+
+	/* Sorted so a directory always gives the same batch */
+	qsort(names,names_enum,sizeof(char*),batch_cmpname);
+
+	batch=(BATCH*)calloc(1,sizeof(BATCH));
+	for (i=0; i<names_enum; i++) {
+		if (!batch_hasext(names[i],".amc"))
+			continue;
+		if (!(asf=batch_findasf(names,names_enum,names[i]))) {
+			printf("WARNING: No ASF file for %s\n",names[i]);
+			continue;
+		}
+		asfpath=batch_join(dirname,asf);
+		amcpath=batch_join(dirname,names[i]);
+		batch_add(batch,asfpath,amcpath);
+		free(asfpath);
+		free(amcpath);
+	}
+
+	for (i=0; i<names_enum; i++)
+		free(names[i]);
+	free(names);
+
+	return batch;
+
+}
+
+void batch_add(BATCH* batch, char* asfFilename, char* amcFilename) {
+
+	BATCHITEM* item;
+
+	if (batch->items_enum==batch->items_alloc) {
+		batch->items_alloc=batch->items_alloc ? batch->items_alloc*2 : BATCH_INITIAL_ITEMS;
+		batch->items=(BATCHITEM*)realloc(batch->items,sizeof(BATCHITEM)*batch->items_alloc);
+	}
+
+	item=batch->items+batch->items_enum++;
+	memset(item,0,sizeof(BATCHITEM));
+	item->asfFilename=batch_strdup(asfFilename);
+	item->amcFilename=batch_strdup(amcFilename);
+	item->status=BATCH_NOTLOADED;
+	item->skeleton=-1;
+
+}
+
+
+void batch_load(BATCH* batch, int threads, int keep) {
+
+	THREADPOOL*	pool;
+	BATCHASF*	asfs;
+	BATCHASF**	byname;
+	BATCHASF	key;
+	BATCHASF*	keyp=&key;
+	AMCBSTAMP	amcstamp;
+	BATCHJOB*	jobs;
+	int			asfs_enum;
+	double		start;
+	int			i,j;
+
+	start=timer_seconds();
+	pool=threadpool_create(threads);
+
+	/* Distinct ASF file names, each stamped (size and contents hash) on the pool */
+	asfs=(BATCHASF*)calloc(batch->items_enum ? batch->items_enum : 1,sizeof(BATCHASF));
+	byname=(BATCHASF**)malloc(sizeof(BATCHASF*)*(batch->items_enum ? batch->items_enum : 1));
+	for (i=0; i<batch->items_enum; i++) {
+		asfs[i].filename=batch->items[i].asfFilename;
+		asfs[i].batch=batch;
+		byname[i]=asfs+i;
+	}
+	qsort(byname,batch->items_enum,sizeof(BATCHASF*),batch_cmpasfname);
+	for (i=0, asfs_enum=0; i<batch->items_enum; i++) {
+		if (!asfs_enum || strcmp(byname[asfs_enum-1]->filename,byname[i]->filename))
+			byname[asfs_enum++]=byname[i];
+	}
+	for (i=0; i<asfs_enum; i++)
+		threadpool_submit(pool,batch_stampjob,byname[i]);
+	threadpool_wait(pool);
+
+	/* Files with the same contents share one skeleton, whatever they are called.  Equal stamps only
+	   make files candidates - the bytes are compared before sharing, as a hash can collide */
+	qsort(byname,asfs_enum,sizeof(BATCHASF*),batch_cmpasfstamp);
+	batch->skeletons_enum=0;
+	batch->bytes=0;
+	for (i=0; i<asfs_enum; i++) {
+		byname[i]->skeleton=-1;
+		if (!byname[i]->ok)
+			continue;
+		for (j=i-1; j>=0 && !batch_cmpasfstamp(byname+j,byname+i); j--) {
+			if (batch_samefile(byname[j]->filename,byname[i]->filename)) {
+				byname[i]->skeleton=byname[j]->skeleton;
+				break;
+			}
+		}
+		if (byname[i]->skeleton<0) {
+			byname[i]->skeleton=batch->skeletons_enum++;
+			batch->bytes+=byname[i]->stamp.size;
+		}
+	}
+
+	/* Parse each distinct skeleton once - from the first file given its index */
+	batch->skeletons=(SKELETON**)calloc(batch->skeletons_enum ? batch->skeletons_enum : 1,sizeof(SKELETON*));
+	for (i=0, j=0; i<asfs_enum; i++) {
+		if (byname[i]->ok && byname[i]->skeleton==j) {
+			threadpool_submit(pool,batch_skeljob,byname[i]);
+			j++;
+		}
+	}
+	threadpool_wait(pool);
+
+	/* Point every pair at its skeleton - the name lookup is a binary search of the sorted names */
+	qsort(byname,asfs_enum,sizeof(BATCHASF*),batch_cmpasfname);
+	jobs=(BATCHJOB*)calloc(batch->items_enum ? batch->items_enum : 1,sizeof(BATCHJOB));
+	for (i=0; i<batch->items_enum; i++) {
+		key.filename=batch->items[i].asfFilename;
+		batch->items[i].skeleton=(*(BATCHASF**)bsearch(&keyp,byname,asfs_enum,sizeof(BATCHASF*),batch_cmpasfname))->skeleton;
+		batch->items[i].bytes=amcb_stamp(batch->items[i].amcFilename,&amcstamp,0) ? amcstamp.size : 0;
+
+		jobs[i].batch=batch;
+		jobs[i].item=batch->items+i;
+		jobs[i].keep=keep;
+	}
+
+	/* Biggest files first, so the last jobs to start are short ones */
+	qsort(jobs,batch->items_enum,sizeof(BATCHJOB),batch_cmpjobsize);
+	for (i=0; i<batch->items_enum; i++)
+		threadpool_submit(pool,batch_mocapjob,jobs+i);
+	threadpool_destroy(pool);
+
+	for (i=0; i<batch->items_enum; i++) {
+		if (batch->items[i].status==BATCH_OK)
+			batch->bytes+=batch->items[i].bytes;
+	}
+	batch->seconds=timer_seconds()-start;
+
+	free(jobs);
+	free(byname);
+	free(asfs);
+
+}
+
+void batch_free(BATCH* batch) {
+
+	int i;
+
+	for (i=0; i<batch->items_enum; i++) {
+		free(batch->items[i].asfFilename);
+		free(batch->items[i].amcFilename);
+		if (batch->items[i].mocap)
+			parser_free_mocap(batch->items[i].mocap);
+	}
+	for (i=0; i<batch->skeletons_enum; i++) {
+		if (batch->skeletons[i])
+			parser_free_skeleton(batch->skeletons[i]);
+	}
+	free(batch->skeletons);
+	free(batch->items);
+	free(batch);
+
+}
+
+
+void batch_stampjob(void* arg) {
+
+	BATCHASF* asf=(BATCHASF*)arg;
+
+	asf->ok=amcb_stamp(asf->filename,&(asf->stamp),1);
+
+}
+
+void batch_skeljob(void* arg) {
+
+	BATCHASF* asf=(BATCHASF*)arg;
+
+	asf->batch->skeletons[asf->skeleton]=parser_loadSkeleton(asf->filename);
+
+}
+
+void batch_mocapjob(void* arg) {
+
+	BATCHJOB*	job=(BATCHJOB*)arg;
+	BATCHITEM*	item=job->item;
+	SKELETON*	skel;
+	double		start;
+
+	skel=(item->skeleton==-1) ? NULL : job->batch->skeletons[item->skeleton];
+	if (!skel) {
+		item->status=BATCH_BADSKEL;
+		return;
+	}
+
+	/* Files are parsed one per worker, so each uses the single threaded loader */
+	start=timer_seconds();
+	item->mocap=parser_loadMocapMapped(item->amcFilename,skel);
+	item->seconds=timer_seconds()-start;
+
+	if (!item->mocap) {
+		item->status=BATCH_BADMOCAP;
+		return;
+	}
+
+	item->status=BATCH_OK;
+	item->frames_enum=item->mocap->frames_enum;
+	if (!job->keep) {
+		parser_free_mocap(item->mocap);
+		item->mocap=NULL;
+	}
+
+}
+
+
+char* batch_strdup(const char* s) {
+
+	return strcpy((char*)malloc(strlen(s)+1),s);
+
+}
+
+char* batch_join(const char* dir, const char* name) {
+
+	char* path;
+
+	if (name[0]=='/' || name[0]=='\\' || (name[0] && name[1]==':'))
+		return batch_strdup(name);
+
+	path=(char*)malloc(strlen(dir)+strlen(name)+2);
+#ifdef WIN32
+	sprintf(path,"%s\\%s",dir,name);
+#else
+	sprintf(path,"%s/%s",dir,name);
+#endif
+
+	return path;
+
+}
+
+int batch_hasext(const char* name, const char* ext) {
+
+	size_t n=strlen(name), e=strlen(ext);
+
+	return n>e && !strcasecmp(name+n-e,ext);
+
+}
+
+char** batch_listdir(char* dirname, int* names_enum) {
+
+	char**	names;
+	int		alloc;
+#ifdef WIN32
+	WIN32_FIND_DATA	fd;
+	HANDLE			h;
+	char			pattern[FILENAME_MAX];
+
+	sprintf(pattern,"%.*s\\*",FILENAME_MAX-3,dirname);
+	if ((h=FindFirstFile(pattern,&fd))==INVALID_HANDLE_VALUE)
+		return NULL;
+#else
+	DIR*			d;
+	struct dirent*	de;
+
+	if (!(d=opendir(dirname)))
+		return NULL;
+#endif
+
+	alloc=BATCH_INITIAL_ITEMS;
+	names=(char**)malloc(sizeof(char*)*alloc);
+	*names_enum=0;
+
+#ifdef WIN32
+	do {
+		if (*names_enum==alloc)
+			names=(char**)realloc(names,sizeof(char*)*(alloc*=2));
+		names[(*names_enum)++]=batch_strdup(fd.cFileName);
+	} while (FindNextFile(h,&fd));
+	FindClose(h);
+#else
+	while ((de=readdir(d))) {
+		if (*names_enum==alloc)
+			names=(char**)realloc(names,sizeof(char*)*(alloc*=2));
+		names[(*names_enum)++]=batch_strdup(de->d_name);
+	}
+	closedir(d);
+#endif
+
+	return names;
+
+}
+
+char* batch_findasf(char** names, int names_enum, const char* amcname) {
+
+	char*	only=NULL;
+	int		asfs=0;
+	size_t	base, subject;
+	int		i;
+
+	/* walk.amc -> walk.asf, then the subject of a numbered take (01_02.amc -> 01.asf), then the directory's only ASF */
+	base=strlen(amcname)-4;
+	subject=strcspn(amcname,"_");
+	for (i=0; i<names_enum; i++) {
+		if (!batch_hasext(names[i],".asf"))
+			continue;
+		if (strlen(names[i])-4==base && !strncasecmp(names[i],amcname,base))
+			return names[i];
+		asfs++;
+		only=names[i];
+	}
+	for (i=0; subject<base && i<names_enum; i++) {
+		if (batch_hasext(names[i],".asf") && strlen(names[i])-4==subject && !strncasecmp(names[i],amcname,subject))
+			return names[i];
+	}
+
+	return (asfs==1) ? only : NULL;
+
+}
+
+
+int batch_cmpname(const void* a, const void* b) {
+
+	return strcmp(*(char**)a,*(char**)b);
+
+}
+
+int batch_cmpasfname(const void* a, const void* b) {
+
+	return strcmp((*(BATCHASF**)a)->filename,(*(BATCHASF**)b)->filename);
+
+}
+
+int batch_cmpasfstamp(const void* a, const void* b) {
+
+	BATCHASF* x=*(BATCHASF**)a;
+	BATCHASF* y=*(BATCHASF**)b;
+
+	/* Unreadable files last */
+	if (x->ok!=y->ok)
+		return x->ok ? -1 : 1;
+	if (x->stamp.size!=y->stamp.size)
+		return (x->stamp.size<y->stamp.size) ? -1 : 1;
+	if (x->stamp.hash!=y->stamp.hash)
+		return (x->stamp.hash<y->stamp.hash) ? -1 : 1;
+
+	return 0;
+
+}
+
+int batch_samefile(char* a, char* b) {
+
+	MAPPEDFILE*	x;
+	MAPPEDFILE*	y;
+	int			same;
+
+	if (!(x=mapfile_open(a)))
+		return 0;
+	if (!(y=mapfile_open(b))) {
+		mapfile_close(x);
+		return 0;
+	}
+
+	same=x->size==y->size && (!x->size || !memcmp(x->data,y->data,x->size));
+
+	mapfile_close(x);
+	mapfile_close(y);
+
+	return same;
+
+}
+
+int batch_cmpjobsize(const void* a, const void* b) {
+
+	unsigned long long x=((BATCHJOB*)a)->item->bytes;
+	unsigned long long y=((BATCHJOB*)b)->item->bytes;
+
+	return (x>y) ? -1 : (x<y);
+
+}
@@ -0,0 +1,60 @@
+#ifndef COLLOMOSSE_MOCAP_BATCH_INCLUDED
+#define COLLOMOSSE_MOCAP_BATCH_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  BATCH.H                                              *
+*  Parallel ingestion of whole ASF/AMC datasets         *
+*                                                       *
+*  Parses every pair listed in a manifest or found in a *
+*  directory on the thread pool, parsing identical ASF  *
+*  files once and sharing the skeleton                  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "parser.h"
+
+/* Status of a batch item */
+#define BATCH_OK			(0)
+#define BATCH_BADSKEL		(1)		/* The ASF file failed to parse */
+#define BATCH_BADMOCAP		(2)		/* The AMC file failed to parse */
+#define BATCH_NOTLOADED		(3)		/* batch_load hasn't been run */
+
+/* One ASF/AMC pair */
+typedef struct _batchitem {
+
+	char*		asfFilename;
+	char*		amcFilename;
+	int			status;
+	int			skeleton;		/* Index into BATCH::skeletons, shared by every pair with an identical ASF file */
+	MOCAP*		mocap;			/* NULL unless loaded with keep set */
+	int			frames_enum;
+	unsigned long long	bytes;	/* Size of the AMC file */
+	double		seconds;		/* Time spent parsing the AMC file */
+
+} BATCHITEM;
+
+/* Type for representing a dataset */
+typedef struct _batch {
+
+	int			items_enum;
+	int			items_alloc;
+	BATCHITEM*	items;
+	int			skeletons_enum;	/* Distinct ASF files by contents */
+	SKELETON**	skeletons;		/* NULL where the ASF file failed to parse */
+	double		seconds;		/* Wall time of batch_load */
+	unsigned long long	bytes;	/* Total size of the files parsed (each distinct ASF once) */
+
+} BATCH;
+
+
+BATCH*	batch_fromManifest(char* manifestFilename);	/* Pairs listed one per line as "<asf file> <amc file>" - NULL if unreadable */
+BATCH*	batch_fromDirectory(char* dirname);			/* Every AMC file in a directory with its ASF file - NULL if unreadable */
+void	batch_add(BATCH* batch, char* asfFilename, char* amcFilename);	/* Add one pair */
+void	batch_load(BATCH* batch, int threads, int keep);	/* Parse everything (threads<=0 for one per CPU), freeing each MOCAP straight away unless keep is set */
+void	batch_free(BATCH* batch);
+
+#endif
@@ -0,0 +1,244 @@
+/*******************************************************\
+*                                                       *
+*  CHANNELS.C                                           *
+*  Channel-major (struct of arrays) motion storage      *
+*                                                       *
+*  Keeps one contiguous float array per active degree  *
+*  of freedom instead of a POINT3D per bone per frame   *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "channels.h"
+
+/* Frames allocated per channel by channels_load before geometric growth kicks in */
+#define CHANNELS_INITIAL_FRAMES	(256)
+
+MOCAPCHANNELS*	channels_create(SKELETON* skel);					/* Empty channel set laid out for a skeleton */
+void			channels_setcapacity(MOCAPCHANNELS* ch, int frames);	/* Resize every channel to hold this many frames */
+void			channels_storeframe(MOCAPCHANNELS* ch, int frame, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient);	/* Scatter one frame into the channels */
+
+
+MOCAPCHANNELS* channels_create(SKELETON* skel) {
+
+	MOCAPCHANNELS* ch;
+	int i, axis;
+
+	ch=(MOCAPCHANNELS*)calloc(1,sizeof(MOCAPCHANNELS));
+	ch->bones_enum=skel->bonearray_enum;
+	ch->bonechannel=(int*)malloc(sizeof(int)*3*(ch->bones_enum ? ch->bones_enum : 1));
+
+	/* Number the root channels, then each active DOF in bone order */
+	ch->channels_enum=CHANNEL_ROOT_ENUM;
+	for (i=0; i<ch->bones_enum; i++) {
+		for (axis=0; axis<3; axis++) {
+			if (skel->bonearray[i].xyzflags & (DOF_FLAG_RX<<axis))
+				ch->bonechannel[i*3+axis]=ch->channels_enum++;
+			else
+				ch->bonechannel[i*3+axis]=-1;
+		}
+	}
+
+	ch->channelbone=(int*)malloc(sizeof(int)*ch->channels_enum);
+	ch->channelaxis=(int*)malloc(sizeof(int)*ch->channels_enum);
+	for (i=0; i<CHANNEL_ROOT_ENUM; i++) {
+		ch->channelbone[i]=-1;
+		ch->channelaxis[i]=i%3;
+	}
+	for (i=0; i<ch->bones_enum*3; i++) {
+		if (ch->bonechannel[i]>=0) {
+			ch->channelbone[ch->bonechannel[i]]=i/3;
+			ch->channelaxis[ch->bonechannel[i]]=i%3;
+		}
+	}
+
+	return ch;
+
+}
+
+void channels_setcapacity(MOCAPCHANNELS* ch, int frames) {
+
+	float*	data;
+	int		c;
+
+	if (frames<1)
+		frames=1;
+
+	/* Channels are laid end to end, so each one moves to its new stride */
+	data=(float*)malloc(sizeof(float)*(size_t)frames*ch->channels_enum);
+	if (ch->data) {
+		for (c=0; c<ch->channels_enum; c++)
+			memcpy(data+(size_t)c*frames,ch->data+(size_t)c*ch->frames_alloc,sizeof(float)*ch->frames_enum);
+		free(ch->data);
+	}
+	ch->data=data;
+	ch->frames_alloc=frames;
+
+}
+
+void channels_storeframe(MOCAPCHANNELS* ch, int frame, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient) {
+
+	int c;
+
+	ch->data[(size_t)CHANNEL_ROOT_TX*ch->frames_alloc+frame]=root_pos->x;
+	ch->data[(size_t)CHANNEL_ROOT_TY*ch->frames_alloc+frame]=root_pos->y;
+	ch->data[(size_t)CHANNEL_ROOT_TZ*ch->frames_alloc+frame]=root_pos->z;
+	ch->data[(size_t)CHANNEL_ROOT_RX*ch->frames_alloc+frame]=root_orient->x;
+	ch->data[(size_t)CHANNEL_ROOT_RY*ch->frames_alloc+frame]=root_orient->y;
+	ch->data[(size_t)CHANNEL_ROOT_RZ*ch->frames_alloc+frame]=root_orient->z;
+
+	for (c=CHANNEL_ROOT_ENUM; c<ch->channels_enum; c++)
+		ch->data[(size_t)c*ch->frames_alloc+frame]=(&(bones_orient[ch->channelbone[c]].x))[ch->channelaxis[c]];
+
+}
+
+
+MOCAPCHANNELS* channels_pack(MOCAP* mocap, SKELETON* skel) {
+
+	MOCAPCHANNELS* ch;
+	int f;
+
+	ch=channels_create(skel);
+	channels_setcapacity(ch,mocap->frames_enum);
+	ch->frames_enum=mocap->frames_enum;
+
+	for (f=0; f<mocap->frames_enum; f++)
+		channels_storeframe(ch,f,mocap->root_pos+f,mocap->root_orient+f,mocap->bones_orient[f]);
+
+	return ch;
+
+}
+
+MOCAPCHANNELS* channels_load(char* argFilename, SKELETON* skel) {
+
+	MOCAPCHANNELS*	ch;
+	AMCSTREAM*		stream;
+	AMCFRAME		frame;
+	int				c, capacity;
+
+	if (!(stream=parser_openMocapStream(argFilename,skel)))
+		return NULL;
+
+	ch=channels_create(skel);
+	channels_setcapacity(ch,CHANNELS_INITIAL_FRAMES);
+	frame.bones_orient=(POINT3D*)malloc(sizeof(POINT3D)*(skel->bonearray_enum ? skel->bonearray_enum : 1));
+
+	/* Frames are placed by their number, so gaps read as zero as parser_loadMocap leaves them.
+	 * A frame number repeated in the file keeps only its last block.
+	 */
+	while (parser_nextFrame(stream,&frame)) {
+		if (frame.frame>ch->frames_alloc) {
+			capacity=ch->frames_alloc*2;
+			if (capacity<frame.frame)
+				capacity=frame.frame;
+			channels_setcapacity(ch,capacity);
+		}
+		for (c=0; c<ch->channels_enum && ch->frames_enum<frame.frame-1; c++)
+			memset(ch->data+(size_t)c*ch->frames_alloc+ch->frames_enum,0,sizeof(float)*(frame.frame-1-ch->frames_enum));
+		channels_storeframe(ch,frame.frame-1,&(frame.root_pos),&(frame.root_orient),frame.bones_orient);
+		if (frame.frame>ch->frames_enum)
+			ch->frames_enum=frame.frame;
+	}
+
+	free(frame.bones_orient);
+	parser_closeMocapStream(stream);
+
+	/* Close up the spare room */
+	channels_setcapacity(ch,ch->frames_enum);
+
+	return ch;
+
+}
+
+void channels_free(MOCAPCHANNELS* ch) {
+
+	free(ch->data);
+	free(ch->bonechannel);
+	free(ch->channelbone);
+	free(ch->channelaxis);
+	free(ch);
+
+}
+
+
+float* channels_get(MOCAPCHANNELS* ch, int channel) {
+
+	return ch->data+(size_t)channel*ch->frames_alloc;
+
+}
+
+int channels_bone(MOCAPCHANNELS* ch, int bone, int axis) {
+
+	return ch->bonechannel[bone*3+axis];
+
+}
+
+void channels_expandframe(MOCAPCHANNELS* ch, int frame, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient) {
+
+	int c;
+
+	root_pos->x=ch->data[(size_t)CHANNEL_ROOT_TX*ch->frames_alloc+frame];
+	root_pos->y=ch->data[(size_t)CHANNEL_ROOT_TY*ch->frames_alloc+frame];
+	root_pos->z=ch->data[(size_t)CHANNEL_ROOT_TZ*ch->frames_alloc+frame];
+	root_orient->x=ch->data[(size_t)CHANNEL_ROOT_RX*ch->frames_alloc+frame];
+	root_orient->y=ch->data[(size_t)CHANNEL_ROOT_RY*ch->frames_alloc+frame];
+	root_orient->z=ch->data[(size_t)CHANNEL_ROOT_RZ*ch->frames_alloc+frame];
+
+	/* DOFs the bone doesn't have are zero */
+	memset(bones_orient,0,sizeof(POINT3D)*ch->bones_enum);
+	for (c=CHANNEL_ROOT_ENUM; c<ch->channels_enum; c++)
+		(&(bones_orient[ch->channelbone[c]].x))[ch->channelaxis[c]]=ch->data[(size_t)c*ch->frames_alloc+frame];
+
+}
+
+MOCAP* channels_unpack(MOCAPCHANNELS* ch) {
+
+	MOCAP* mocap;
+	int f;
+
+	mocap=(MOCAP*)calloc(1,sizeof(MOCAP));
+	mocap->frames_enum=ch->frames_enum;
+	mocap->frames_alloc=ch->frames_enum ? ch->frames_enum : 1;
+	mocap->bones_enum=ch->bones_enum;
+	mocap->root_pos=(POINT3D*)malloc(sizeof(POINT3D)*mocap->frames_alloc);
+	mocap->root_orient=(POINT3D*)malloc(sizeof(POINT3D)*mocap->frames_alloc);
+	mocap->bones_slab=(POINT3D*)malloc(sizeof(POINT3D)*(size_t)mocap->frames_alloc*(ch->bones_enum ? ch->bones_enum : 1));
+	mocap->bones_orient=(POINT3D**)malloc(sizeof(POINT3D*)*mocap->frames_alloc);
+
+	for (f=0; f<ch->frames_enum; f++) {
+		mocap->bones_orient[f]=mocap->bones_slab+(size_t)f*ch->bones_enum;
+		channels_expandframe(ch,f,mocap->root_pos+f,mocap->root_orient+f,mocap->bones_orient[f]);
+	}
+
+	return mocap;
+
+}
+
+
+void channels_range(MOCAPCHANNELS* ch, int channel, float* min, float* max) {
+
+	float*	v=channels_get(ch,channel);
+	float	lo, hi;
+	int		f;
+
+	lo=hi=ch->frames_enum ? v[0] : 0;
+	for (f=1; f<ch->frames_enum; f++) {
+		if (v[f]<lo)
+			lo=v[f];
+		if (v[f]>hi)
+			hi=v[f];
+	}
+
+	*min=lo;
+	*max=hi;
+
+}
+
+size_t channels_bytes(MOCAPCHANNELS* ch) {
+
+	return sizeof(float)*(size_t)ch->frames_enum*ch->channels_enum;
+
+}
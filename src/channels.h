@@ -0,0 +1,55 @@
+#ifndef COLLOMOSSE_MOCAP_CHANNELS_INCLUDED
+#define COLLOMOSSE_MOCAP_CHANNELS_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  CHANNELS.H                                           *
+*  Channel-major (struct of arrays) motion storage      *
+*                                                       *
+*  Keeps one contiguous float array per active degree  *
+*  of freedom instead of a POINT3D per bone per frame   *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "parser.h"
+
+/* The root always has six channels, numbered first */
+#define CHANNEL_ROOT_TX		(0)
+#define CHANNEL_ROOT_TY		(1)
+#define CHANNEL_ROOT_TZ		(2)
+#define CHANNEL_ROOT_RX		(3)
+#define CHANNEL_ROOT_RY		(4)
+#define CHANNEL_ROOT_RZ		(5)
+#define CHANNEL_ROOT_ENUM	(6)
+
+/* Type for representing a motion capture set channel by channel.
+ * Only the rx/ry/rz channels flagged in BONE::xyzflags are stored - the others are always zero.
+ */
+typedef struct _mocapchannels {
+
+	int		frames_enum;		/* Number of frames of animation */
+	int		bones_enum;			/* Number of bones in the skeleton */
+	int		channels_enum;		/* CHANNEL_ROOT_ENUM plus one per active bone DOF */
+	int		frames_alloc;		/* Room in each channel while loading */
+	float*	data;				/* Channel c holds data[c*frames_alloc] to data[c*frames_alloc+frames_enum-1] */
+	int*	bonechannel;		/* bonechannel[bone*3+axis] - channel of a bone's x/y/z rotation, -1 if inactive */
+	int*	channelbone;		/* channelbone[channel] - bone a channel belongs to, -1 for the root channels */
+	int*	channelaxis;		/* channelaxis[channel] - 0,1,2 for x,y,z */
+
+} MOCAPCHANNELS;
+
+
+MOCAPCHANNELS*	channels_pack(MOCAP* mocap, SKELETON* skel);			/* Channel-major copy of a loaded clip */
+MOCAPCHANNELS*	channels_load(char* argFilename, SKELETON* skel);		/* Read an AMC file straight into channels (never holds a MOCAP) */
+void			channels_free(MOCAPCHANNELS* ch);
+float*			channels_get(MOCAPCHANNELS* ch, int channel);			/* The frames_enum values of one channel, contiguous */
+int				channels_bone(MOCAPCHANNELS* ch, int bone, int axis);	/* Channel of a bone's x/y/z rotation, -1 if the bone doesn't have that DOF */
+void			channels_expandframe(MOCAPCHANNELS* ch, int frame, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient);	/* Rebuild one frame as POINT3Ds (bones_orient[bones_enum]) */
+MOCAP*			channels_unpack(MOCAPCHANNELS* ch);						/* Full MOCAP rebuilt from the channels */
+void			channels_range(MOCAPCHANNELS* ch, int channel, float* min, float* max);	/* Smallest and largest value of a channel */
+size_t			channels_bytes(MOCAPCHANNELS* ch);						/* Bytes used by the channel data */
+
+#endif
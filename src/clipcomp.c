@@ -0,0 +1,193 @@
+/*******************************************************\
+*                                                       *
+*  CLIPCOMP.C                                           *
+*  Report on compressing a clip with compress.c         *
+*                                                       *
+*  Prints the size of the clip as a MOCAP, as channels  *
+*  and compressed, the largest angular and positional   *
+*  error against the source AMC, and decode speed.      *
+*  Also times loading straight into channels against    *
+*  parser_loadMocap and checks they agree               *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "parser.h"
+#include "channels.h"
+#include "compress.h"
+#include "timer.h"
+
+#define EXITCODE_SUCCESS	(0)
+#define EXITCODE_BADSYNTAX	(1)
+#define EXITCODE_BADSKEL	(2)
+#define EXITCODE_BADMOCAP	(3)
+#define EXITCODE_BADCLIP	(4)
+
+#define CLIP_RANDOMREADS	(100000)	/* Random frames decoded for the access timing */
+
+double	clip_error(float a, float b);		/* Absolute difference */
+int		clip_compare(MOCAPCHANNELS* ch, MOCAP* mocap);	/* 0 if the channels hold exactly the clip, otherwise the first frame that differs (1 based) */
+
+
+int main (int argc, char** argv) {
+
+	SKELETON*			skel;
+	MOCAP*				mocap;
+	MOCAPCHANNELS*		ch;
+	MOCAPCHANNELS*		loaded;
+	MOCAPCOMPRESSED*	cc;
+	POINT3D				pos, orient;
+	POINT3D*			bones;
+	POINT3D*			rangepos;
+	POINT3D*			rangeorient;
+	POINT3D*			rangebones;
+	double				poserr=0, angerr=0, e;
+	double				start, randomtime, rangetime, mocaptime, loadtime;
+	size_t				mocapbytes;
+	unsigned int		seed=1;
+	int					f, b, i, n;
+
+	if (argc!=3) {
+		printf("Use CLIPCOMP <asf file> <amc file>\n");
+		return (EXITCODE_BADSYNTAX);
+	}
+
+	if (!(skel=parser_loadSkeleton(argv[1]))) {
+		printf("FATAL:  Failed to load skeleton from file\n");
+		return (EXITCODE_BADSKEL);
+	}
+	start=timer_seconds();
+	if (!(mocap=parser_loadMocap(argv[2],skel))) {
+		printf("FATAL:  Failed to load motion capture data from file\n");
+		parser_free_skeleton(skel);
+		return (EXITCODE_BADMOCAP);
+	}
+	mocaptime=timer_seconds()-start;
+
+	/* The same file read straight into channels, without ever holding a MOCAP */
+	start=timer_seconds();
+	if (!(loaded=channels_load(argv[2],skel))) {
+		printf("FATAL:  Failed to load motion capture data into channels\n");
+		parser_free_mocap(mocap);
+		parser_free_skeleton(skel);
+		return (EXITCODE_BADMOCAP);
+	}
+	loadtime=timer_seconds()-start;
+	if ((f=clip_compare(loaded,mocap))) {
+		printf("FATAL:  channels_load and parser_loadMocap differ at frame %d\n",f);
+		return (EXITCODE_BADCLIP);
+	}
+	channels_free(loaded);
+
+	ch=channels_pack(mocap,skel);
+	if (!(cc=compress_clip(ch))) {
+		printf("FATAL:  Clip has more than %d channels\n",COMPRESS_MAXCHANNELS);
+		channels_free(ch);
+		parser_free_mocap(mocap);
+		parser_free_skeleton(skel);
+		return (EXITCODE_BADCLIP);
+	}
+
+	n=mocap->frames_enum;
+	bones=(POINT3D*)malloc(sizeof(POINT3D)*(cc->bones_enum ? cc->bones_enum : 1));
+	rangepos=(POINT3D*)malloc(sizeof(POINT3D)*(n ? n : 1));
+	rangeorient=(POINT3D*)malloc(sizeof(POINT3D)*(n ? n : 1));
+	rangebones=(POINT3D*)malloc(sizeof(POINT3D)*(size_t)(n ? n : 1)*(cc->bones_enum ? cc->bones_enum : 1));
+
+	/* Error of every frame against the parsed AMC, and random access against a full range decode */
+	start=timer_seconds();
+	compress_decoderange(cc,0,n,rangepos,rangeorient,rangebones);
+	rangetime=timer_seconds()-start;
+
+	for (f=0; f<n; f++) {
+		compress_decodeframe(cc,f,&pos,&orient,bones);
+		if (memcmp(&pos,rangepos+f,sizeof(POINT3D)) || memcmp(&orient,rangeorient+f,sizeof(POINT3D)) ||
+			memcmp(bones,rangebones+(size_t)f*cc->bones_enum,sizeof(POINT3D)*cc->bones_enum)) {
+			printf("FATAL:  Frame %d decodes differently on its own and in a range\n",f+1);
+			return (EXITCODE_BADCLIP);
+		}
+
+		if ((e=clip_error(pos.x,mocap->root_pos[f].x))>poserr) poserr=e;
+		if ((e=clip_error(pos.y,mocap->root_pos[f].y))>poserr) poserr=e;
+		if ((e=clip_error(pos.z,mocap->root_pos[f].z))>poserr) poserr=e;
+		if ((e=clip_error(orient.x,mocap->root_orient[f].x))>angerr) angerr=e;
+		if ((e=clip_error(orient.y,mocap->root_orient[f].y))>angerr) angerr=e;
+		if ((e=clip_error(orient.z,mocap->root_orient[f].z))>angerr) angerr=e;
+		for (b=0; b<cc->bones_enum; b++) {
+			if ((e=clip_error(bones[b].x,mocap->bones_orient[f][b].x))>angerr) angerr=e;
+			if ((e=clip_error(bones[b].y,mocap->bones_orient[f][b].y))>angerr) angerr=e;
+			if ((e=clip_error(bones[b].z,mocap->bones_orient[f][b].z))>angerr) angerr=e;
+		}
+	}
+
+	start=timer_seconds();
+	for (i=0; n && i<CLIP_RANDOMREADS; i++) {
+		seed=seed*1103515245+12345;
+		compress_decodeframe(cc,(int)((seed>>8)%(unsigned int)n),&pos,&orient,bones);
+	}
+	randomtime=timer_seconds()-start;
+
+	mocapbytes=sizeof(POINT3D)*(size_t)n*(2+cc->bones_enum);
+	printf("%d frames, %d bones, %d channels\n",n,cc->bones_enum,ch->channels_enum);
+	printf("MOCAP        %10lu bytes\n",(unsigned long)mocapbytes);
+	printf("channels     %10lu bytes  %5.2f:1\n",(unsigned long)channels_bytes(ch),(double)mocapbytes/channels_bytes(ch));
+	printf("compressed   %10lu bytes  %5.2f:1  (%5.2f:1 against channels)\n",(unsigned long)compress_bytes(cc),
+		(double)mocapbytes/compress_bytes(cc),(double)channels_bytes(ch)/compress_bytes(cc));
+	printf("load         %10.3f ms parser_loadMocap, %10.3f ms channels_load (identical)\n",mocaptime*1e3,loadtime*1e3);
+	printf("max error    %10.6f degrees, %10.6f units of root translation\n",angerr,poserr);
+	printf("decode       %10.3f us per random frame, %10.3f us per frame in sequence\n",
+		randomtime*1e6/CLIP_RANDOMREADS,n ? rangetime*1e6/n : 0);
+
+	free(bones);
+	free(rangepos);
+	free(rangeorient);
+	free(rangebones);
+	compress_free(cc);
+	channels_free(ch);
+	parser_free_mocap(mocap);
+	parser_free_skeleton(skel);
+
+	return (EXITCODE_SUCCESS);
+
+}
+
+
+double clip_error(float a, float b) {
+
+	return (a>b) ? (double)a-b : (double)b-a;
+
+}
+
+int clip_compare(MOCAPCHANNELS* ch, MOCAP* mocap) {
+
+	MOCAP*	unpacked;
+	int		f, b, axis, c, differ=0;
+
+	if (ch->frames_enum!=mocap->frames_enum || ch->bones_enum!=mocap->bones_enum)
+		return 1;
+
+	/* Every frame rebuilt from the channels, bit for bit */
+	unpacked=channels_unpack(ch);
+	for (f=0; f<mocap->frames_enum && !differ; f++)
+		if (memcmp(unpacked->root_pos+f,mocap->root_pos+f,sizeof(POINT3D)) ||
+			memcmp(unpacked->root_orient+f,mocap->root_orient+f,sizeof(POINT3D)) ||
+			memcmp(unpacked->bones_orient[f],mocap->bones_orient[f],sizeof(POINT3D)*mocap->bones_enum))
+			differ=f+1;
+	parser_free_mocap(unpacked);
+
+	/* And each DOF where channels_bone says it is, so the lookup agrees with the frames */
+	for (f=0; f<mocap->frames_enum && !differ; f++)
+		for (b=0; b<mocap->bones_enum; b++)
+			for (axis=0; axis<3; axis++)
+				if ((c=channels_bone(ch,b,axis))!=-1 &&
+					channels_get(ch,c)[f]!=(&(mocap->bones_orient[f][b].x))[axis])
+					differ=f+1;
+
+	return differ;
+
+}
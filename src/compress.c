@@ -0,0 +1,276 @@
+/*******************************************************\
+*                                                       *
+*  COMPRESS.C                                           *
+*  Quantized, delta coded in-memory motion clips        *
+*                                                       *
+*  Each channel is quantized to 16 bits over its own    *
+*  range and stored as a key frame plus 8 or 16 bit     *
+*  deltas in short blocks, so any frame decodes fast    *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "compress.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+	#include <emmintrin.h>
+	#define COMPRESS_SSE2
+#endif
+
+#define QUANT_LEVELS	(65535.0f)		/* Largest quantized value */
+
+unsigned short	compress_quantize(MOCAPCOMPRESSED* cc, int channel, float v);			/* Nearest quantization step to a value */
+void	compress_blockfirst(MOCAPCOMPRESSED* cc, int block, unsigned short* acc);		/* Load a block's key frame into acc */
+void	compress_blockstep(MOCAPCOMPRESSED* cc, int block, int delta, unsigned short* acc);	/* Apply one frame of deltas to acc */
+void	compress_expand(MOCAPCOMPRESSED* cc, unsigned short* acc, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient);	/* Dequantize acc into POINT3Ds */
+
+
+MOCAPCOMPRESSED* compress_clip(MOCAPCHANNELS* ch) {
+
+	MOCAPCOMPRESSED*	cc;
+	unsigned short*		q;			/* quantized channel values of the frame being coded */
+	unsigned short*		prev;		/* and of the frame before it */
+	unsigned char*		out;
+	float				lo, hi;
+	int					c, b, f, first, last;
+	int					delta, width;
+
+	if (ch->channels_enum>COMPRESS_MAXCHANNELS)
+		return NULL;
+
+	cc=(MOCAPCOMPRESSED*)calloc(1,sizeof(MOCAPCOMPRESSED));
+	cc->frames_enum=ch->frames_enum;
+	cc->bones_enum=ch->bones_enum;
+	cc->channels_enum=ch->channels_enum;
+	cc->channels_stride=(ch->channels_enum+7)&~7;
+	cc->blocks_enum=(ch->frames_enum+COMPRESS_BLOCKFRAMES-1)/COMPRESS_BLOCKFRAMES;
+
+	/* Each channel gets 65536 steps spread over its own range */
+	cc->chmin=(float*)calloc(cc->channels_stride,sizeof(float));
+	cc->chscale=(float*)calloc(cc->channels_stride,sizeof(float));
+	cc->channelbone=(int*)malloc(sizeof(int)*cc->channels_enum);
+	cc->channelaxis=(int*)malloc(sizeof(int)*cc->channels_enum);
+	for (c=0; c<cc->channels_enum; c++) {
+		channels_range(ch,c,&lo,&hi);
+		cc->chmin[c]=lo;
+		cc->chscale[c]=(hi-lo)/QUANT_LEVELS;
+		cc->channelbone[c]=ch->channelbone[c];
+		cc->channelaxis[c]=ch->channelaxis[c];
+	}
+
+	cc->blockoffset=(size_t*)malloc(sizeof(size_t)*(cc->blocks_enum+1));
+	cc->blockwidth=(unsigned char*)malloc(cc->blocks_enum ? cc->blocks_enum : 1);
+	q=(unsigned short*)calloc(cc->channels_stride,sizeof(unsigned short));
+	prev=(unsigned short*)calloc(cc->channels_stride,sizeof(unsigned short));
+
+	/* First pass - pick the narrowest delta that holds every change in each block */
+	cc->data_len=0;
+	for (b=0; b<cc->blocks_enum; b++) {
+		first=b*COMPRESS_BLOCKFRAMES;
+		last=first+COMPRESS_BLOCKFRAMES;
+		if (last>cc->frames_enum)
+			last=cc->frames_enum;
+
+		width=1;
+		for (c=0; c<cc->channels_enum && width==1; c++) {
+			for (f=first+1; f<last; f++) {
+				delta=(int)compress_quantize(cc,c,channels_get(ch,c)[f])-(int)compress_quantize(cc,c,channels_get(ch,c)[f-1]);
+				if (delta<-128 || delta>127) {
+					width=2;
+					break;
+				}
+			}
+		}
+
+		cc->blockwidth[b]=(unsigned char)width;
+		cc->blockoffset[b]=cc->data_len;
+		cc->data_len+=sizeof(unsigned short)*cc->channels_stride+(size_t)width*cc->channels_stride*(last-first-1);
+	}
+	cc->blockoffset[cc->blocks_enum]=cc->data_len;
+
+	/* Second pass - write the key frames and deltas */
+	cc->data=(unsigned char*)calloc(cc->data_len ? cc->data_len : 1,1);
+	for (b=0; b<cc->blocks_enum; b++) {
+		first=b*COMPRESS_BLOCKFRAMES;
+		last=first+COMPRESS_BLOCKFRAMES;
+		if (last>cc->frames_enum)
+			last=cc->frames_enum;
+		out=cc->data+cc->blockoffset[b];
+
+		for (c=0; c<cc->channels_enum; c++)
+			q[c]=compress_quantize(cc,c,channels_get(ch,c)[first]);
+		memcpy(out,q,sizeof(unsigned short)*cc->channels_stride);
+		out+=sizeof(unsigned short)*cc->channels_stride;
+
+		for (f=first+1; f<last; f++) {
+			memcpy(prev,q,sizeof(unsigned short)*cc->channels_stride);
+			for (c=0; c<cc->channels_enum; c++)
+				q[c]=compress_quantize(cc,c,channels_get(ch,c)[f]);
+
+			/* Deltas wrap modulo 2^16, exactly like the unsigned sums that decode them */
+			if (cc->blockwidth[b]==1) {
+				for (c=0; c<cc->channels_stride; c++)
+					((signed char*)out)[c]=(signed char)(q[c]-prev[c]);
+			}
+			else {
+				for (c=0; c<cc->channels_stride; c++)
+					((unsigned short*)out)[c]=(unsigned short)(q[c]-prev[c]);
+			}
+			out+=cc->blockwidth[b]*cc->channels_stride;
+		}
+	}
+
+	free(q);
+	free(prev);
+
+	return cc;
+
+}
+
+void compress_free(MOCAPCOMPRESSED* cc) {
+
+	free(cc->chmin);
+	free(cc->chscale);
+	free(cc->channelbone);
+	free(cc->channelaxis);
+	free(cc->blockoffset);
+	free(cc->blockwidth);
+	free(cc->data);
+	free(cc);
+
+}
+
+size_t compress_bytes(MOCAPCOMPRESSED* cc) {
+
+	return sizeof(MOCAPCOMPRESSED)+cc->data_len+
+		(sizeof(float)*2)*cc->channels_stride+(sizeof(int)*2)*cc->channels_enum+
+		(sizeof(size_t)+1)*(cc->blocks_enum+1);
+
+}
+
+
+unsigned short compress_quantize(MOCAPCOMPRESSED* cc, int channel, float v) {
+
+	float s;
+
+	if (cc->chscale[channel]<=0)
+		return 0;
+
+	s=(v-cc->chmin[channel])/cc->chscale[channel]+0.5f;
+	if (s<0)
+		s=0;
+	if (s>QUANT_LEVELS)
+		s=QUANT_LEVELS;
+
+	return (unsigned short)s;
+
+}
+
+
+void compress_decodeframe(MOCAPCOMPRESSED* cc, int frame, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient) {
+
+	unsigned short	acc[COMPRESS_MAXCHANNELS];
+	int				b, j;
+
+	/* Key frame of the block, then at most COMPRESS_BLOCKFRAMES-1 vector adds */
+	b=frame/COMPRESS_BLOCKFRAMES;
+	compress_blockfirst(cc,b,acc);
+	for (j=1; j<=frame%COMPRESS_BLOCKFRAMES; j++)
+		compress_blockstep(cc,b,j,acc);
+
+	compress_expand(cc,acc,root_pos,root_orient,bones_orient);
+
+}
+
+void compress_decoderange(MOCAPCOMPRESSED* cc, int first, int count, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient) {
+
+	unsigned short	acc[COMPRESS_MAXCHANNELS];
+	int				f, b, j;
+
+	/* Random access to the first frame, then one delta step per frame (a new key at each block) */
+	for (f=first; f<first+count; f++) {
+		b=f/COMPRESS_BLOCKFRAMES;
+		j=f%COMPRESS_BLOCKFRAMES;
+		if (f==first) {
+			compress_blockfirst(cc,b,acc);
+			while (j--)
+				compress_blockstep(cc,b,f%COMPRESS_BLOCKFRAMES-j,acc);
+		}
+		else if (!j)
+			compress_blockfirst(cc,b,acc);
+		else
+			compress_blockstep(cc,b,j,acc);
+
+		compress_expand(cc,acc,root_pos+(f-first),root_orient+(f-first),bones_orient+(size_t)(f-first)*cc->bones_enum);
+	}
+
+}
+
+
+void compress_blockfirst(MOCAPCOMPRESSED* cc, int block, unsigned short* acc) {
+
+	memcpy(acc,cc->data+cc->blockoffset[block],sizeof(unsigned short)*cc->channels_stride);
+
+}
+
+void compress_blockstep(MOCAPCOMPRESSED* cc, int block, int delta, unsigned short* acc) {
+
+	unsigned char*	d;
+	int				width=cc->blockwidth[block];
+	int				c;
+#ifdef COMPRESS_SSE2
+	__m128i			a, v;
+#endif
+
+	d=cc->data+cc->blockoffset[block]+sizeof(unsigned short)*cc->channels_stride+(size_t)width*cc->channels_stride*(delta-1);
+
+#ifdef COMPRESS_SSE2
+	/* Eight channels per add - 8 bit deltas are sign extended by unpacking into the high byte and shifting down */
+	for (c=0; c<cc->channels_stride; c+=8) {
+		a=_mm_loadu_si128((__m128i*)(acc+c));
+		if (width==1) {
+			v=_mm_loadl_epi64((__m128i*)(d+c));
+			v=_mm_srai_epi16(_mm_unpacklo_epi8(v,v),8);
+		}
+		else {
+			v=_mm_loadu_si128((__m128i*)(d+c*2));
+		}
+		_mm_storeu_si128((__m128i*)(acc+c),_mm_add_epi16(a,v));
+	}
+#else
+	if (width==1) {
+		for (c=0; c<cc->channels_stride; c++)
+			acc[c]=(unsigned short)(acc[c]+((signed char*)d)[c]);
+	}
+	else {
+		for (c=0; c<cc->channels_stride; c++)
+			acc[c]=(unsigned short)(acc[c]+((unsigned short*)d)[c]);
+	}
+#endif
+
+}
+
+void compress_expand(MOCAPCOMPRESSED* cc, unsigned short* acc, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient) {
+
+	float	v[COMPRESS_MAXCHANNELS];
+	int		c;
+
+	for (c=0; c<cc->channels_enum; c++)
+		v[c]=cc->chmin[c]+(float)acc[c]*cc->chscale[c];
+
+	root_pos->x=v[CHANNEL_ROOT_TX];
+	root_pos->y=v[CHANNEL_ROOT_TY];
+	root_pos->z=v[CHANNEL_ROOT_TZ];
+	root_orient->x=v[CHANNEL_ROOT_RX];
+	root_orient->y=v[CHANNEL_ROOT_RY];
+	root_orient->z=v[CHANNEL_ROOT_RZ];
+
+	/* DOFs the bone doesn't have are zero */
+	memset(bones_orient,0,sizeof(POINT3D)*cc->bones_enum);
+	for (c=CHANNEL_ROOT_ENUM; c<cc->channels_enum; c++)
+		(&(bones_orient[cc->channelbone[c]].x))[cc->channelaxis[c]]=v[c];
+
+}
@@ -0,0 +1,56 @@
+#ifndef COLLOMOSSE_MOCAP_COMPRESS_INCLUDED
+#define COLLOMOSSE_MOCAP_COMPRESS_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  COMPRESS.H                                           *
+*  Quantized, delta coded in-memory motion clips        *
+*                                                       *
+*  Each channel is quantized to 16 bits over its own    *
+*  range and stored as a key frame plus 8 or 16 bit     *
+*  deltas in short blocks, so any frame decodes fast    *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "channels.h"
+
+#define COMPRESS_BLOCKFRAMES	(16)		/* Frames per block - at most this many deltas are summed to decode a frame */
+#define COMPRESS_MAXCHANNELS	(1024)		/* Largest clip (in channels) that can be compressed */
+
+/* Type for representing a compressed clip.
+ * Block b covers frames b*COMPRESS_BLOCKFRAMES onwards and holds, at data+blockoffset[b]:
+ *   unsigned short key[channels_stride]			quantized values of its first frame
+ *   delta[frames in block-1][channels_stride]		change from the previous frame, blockwidth[b] bytes each
+ * Channels are padded to channels_stride (a multiple of 8) so whole vectors can be summed at once.
+ */
+typedef struct _mocapcompressed {
+
+	int				frames_enum;
+	int				bones_enum;
+	int				channels_enum;		/* As MOCAPCHANNELS */
+	int				channels_stride;	/* channels_enum rounded up to a multiple of 8 */
+	int				blocks_enum;
+
+	float*			chmin;				/* Value represented by a quantized 0, per channel */
+	float*			chscale;			/* Value of one quantization step, per channel */
+	int*			channelbone;		/* As MOCAPCHANNELS */
+	int*			channelaxis;
+
+	size_t*			blockoffset;		/* Where each block starts in data */
+	unsigned char*	blockwidth;			/* Bytes per delta in each block (1 or 2) */
+	unsigned char*	data;
+	size_t			data_len;
+
+} MOCAPCOMPRESSED;
+
+
+MOCAPCOMPRESSED*	compress_clip(MOCAPCHANNELS* ch);	/* Quantize and delta code a clip, NULL if it has too many channels */
+void	compress_free(MOCAPCOMPRESSED* cc);
+void	compress_decodeframe(MOCAPCOMPRESSED* cc, int frame, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient);	/* One frame as POINT3Ds (bones_orient[bones_enum]) */
+void	compress_decoderange(MOCAPCOMPRESSED* cc, int first, int count, POINT3D* root_pos, POINT3D* root_orient, POINT3D* bones_orient);	/* 'count' frames from 'first', bones_orient holds count*bones_enum */
+size_t	compress_bytes(MOCAPCOMPRESSED* cc);	/* Total memory used by the compressed clip */
+
+#endif
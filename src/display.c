@@ -1,241 +1,582 @@
-/*******************************************************\
-*                                                       *
-*  DISPLAY.C                                            *
-*  Outline solution to begin the coursework with        *
-*                                                       *
-*  Currently just draws a teapot                        *
-*  Written as a resource for CM20219 coursework         *
-*                                                       *
-*  Benjamin Bourdin, bb247, University of Bath          *
-*  December  2008                                       *
-*                                                       *
-\*******************************************************/
-
-
-#include "display.h"
-
-
-/* Global variables */
-SKELETON* gSkel;			/* Holds skeleton data - available to any function */
-MOCAP*	  gMo;				/* Hold motion data - available to any function */
-int		  gDelay=0;			/* Holds delay information - available to any function */
-int currentFrame = 0;       /* Frame counter */
-int initialPose = 0;		/* Boolean for displaying skeleton in initial position (if user presses 'f' key) */
-int referenceFrame = 0;
-
-
-/* Global variables for the camera position */
-float rCamera = 70, thetaCamera = PI/4, phiCamera = -PI/2;
-
-/* Entry point from MAIN.C */
-void dorender(int argc, char** argv, SKELETON* skel, MOCAP* mo, int delay) {
-
-
-	/* Create GLUT window */
-   glutInit(&argc, argv);
-   glutInitDisplayMode (GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
-   glutInitWindowSize (600, 600);
-   glutCreateWindow ("Mocap Viewer");
-
-   /* Setup GLUT callbacks */
-   glutReshapeFunc (reshape);
-   glutKeyboardFunc (keyboard);
-   glutDisplayFunc (display);
-   glutIdleFunc (idle);
-
-   /* Initialise any OpenGL state */
-   init();
-
-	/* Set global variables */
-   gSkel=skel;
-   gMo=mo;
-   gDelay=delay;
-
-   /* Kick off the GLUT main loop */
-   /* This call will never return */
-   glutMainLoop();
-   
-
-}
-
-
-/* Keyboard callback from GLUT */
-void keyboard(unsigned char key, int x, int y)
-{
-	switch(key) {
-
-			/* If the ESCAPE key is pressed we have to force an exit.
-			 * There is no graceful way to exit the GLUT loop unfortunately.
-			 */
-			case 0x1b:  /* 0x1b (27 decimal) is the ASCII code for the ESCAPE */
-						parser_free_skeleton(gSkel);
-						parser_free_mocap(gMo);
-						exit(0);
-						break;
-
-			case 'f':	/* If the 'f' key is pressed enable intial pose view*/
-						if (initialPose)
-							initialPose = 0;
-						else
-							initialPose = 1;
-
-						break;
-
-
-			/* If the 'r' key is pressed change boolean referenceFrames to true
-			 * and display the reference frames for each joint
-			 */
-			case 'r':
-						if (referenceFrame)
-							referenceFrame = 0;
-						else
-							referenceFrame = 1;
-
-						break;
-
-
-
-			/* Keyboard input to handle camera position. 
-			 * 'q' and 'e' are used to zoom in and out. They modify the R (distance from origin) in our polar coordinates.
-			 * 'a' and 'd' modify the angle phi (angle between the X-axis and the Y-axis) used to rotate right and left.
-			 * 'w' and 's' modify the theta angle (angle between the Z-axis and R) used to rotate up and down.
-			 */
-
-			case 'e':
-						rCamera-=2;
-						if(rCamera < 1)
-							rCamera = 1;
-						break;
-
-			case 'q':
-						rCamera+=2;
-						break;
-
-			case 'a':
-						phiCamera-=CAMERA_SENS;
-						break;
-
-			case 'd':
-						phiCamera+=CAMERA_SENS;
-						break;
-
-			case 'w':
-						thetaCamera-=CAMERA_SENS;
-						if (thetaCamera < 0)
-							thetaCamera+=CAMERA_SENS;
-						break;
-
-			case 's':
-						thetaCamera+=CAMERA_SENS;
-						if (thetaCamera > PI/2)
-							thetaCamera-=CAMERA_SENS;
-						break;
-	}
-}
-
-/* Called back when GLUT idling */
-void idle() {
-	
-	Sleep(gDelay);
-	
-	if (currentFrame < gMo->frames_enum-1) {
-		currentFrame++;
-	} else {
-		currentFrame = 0;
-	}
-
-    glutPostRedisplay();
-}
-
-/* Called back by GLUT when the window is resized */
-void reshape(int w, int h)
-{
-
-   glViewport(0, 0, w, h);
-   glMatrixMode(GL_PROJECTION);
-   glLoadIdentity();
-   
-   gluPerspective(60,(GLfloat)w/(GLfloat)h,0.01,1000.0);
-   glMatrixMode(GL_MODELVIEW);
-   glLoadIdentity();
-
-}
-
-/* Called by us in dorender() to init any OpenGL state */
-/* It is good practice to keep this in a separate function from dorender() */
-void init(void)
-{  
-
-	GLfloat mat_specular[] = {1, 1, 1, 1};
-	GLfloat light_position[] = {0, 0.5, 0.5, 0.0};
-
-	glClearColor (0.0, 0.0, 0.0, 0.0);
-
-	/* Material */
-	glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, mat_specular);
-	glMateriali(GL_FRONT_AND_BACK, GL_SHININESS, 96);
-	glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
-
-	glEnable(GL_COLOR_MATERIAL);
-
-	/* Lighting */
-	glEnable(GL_LIGHTING);
-	glEnable(GL_LIGHT0);
-	glLightfv(GL_LIGHT0, GL_POSITION, light_position);
-
-
-	/* OpenGL Rendering engine parameters */
-	glShadeModel (GL_SMOOTH);
-	glPolygonMode (GL_FRONT_AND_BACK, GL_FILL);
-	glHint(GL_PERSPECTIVE_CORRECTION_HINT,GL_NICEST);
-	glEnable(GL_DEPTH_TEST);
-
-}
-
-
-/* Called when GLUT wants to repaint the screen (we do all our rendering/geometry here) */
-void display(void)
-{
-	float xCamera, yCamera, zCamera;	/* Camera coordinates */
-	float xRoot, yRoot, zRoot;			/* Root position */
-	
-	/* Clear frame buffer and set up MODELVIEW matrix */
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);	
-    glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-
-	/* Calculate the camera position using polar coordinates */
-	xCamera = rCamera*sin(thetaCamera)*cos(phiCamera);
-	yCamera = rCamera*sin(thetaCamera)*sin(phiCamera);
-	zCamera = rCamera*cos(thetaCamera);
-
-	/* Calculate root postion */
-	xRoot = gMo->root_pos[currentFrame].x;
-	yRoot = -gMo->root_pos[currentFrame].z;
-	zRoot = gMo->root_pos[currentFrame].y;
-
-	if(initialPose) {
-
-		/* Place the camera and draw the skeleton in its initial position */
-		gluLookAt(xCamera, yCamera, zCamera, 0, 0, 0, 0, 0, 1);
-		drawInitialPose(gSkel, referenceFrame);
-
-	} else {
-
-		/* Place camera at specified position and draw the skeleton under mocap data */
-		gluLookAt(xCamera+xRoot, yCamera+yRoot, zCamera+zRoot, xRoot, yRoot, zRoot, 0, 0, 1);
-		drawSkeleton(gSkel, gMo, currentFrame, referenceFrame);
-	}
-
-
-	drawFloor(140, 140);
-	
-	if(referenceFrame)
-		drawReferenceFrame(20);
-	
-	/* Ensure any queued up OpenGL calls are run and swap buffers */
-	glFlush();
-	glutSwapBuffers();
-
-}
-
+/*******************************************************\
+*                                                       *
+*  DISPLAY.C                                            *
+*  Outline solution to begin the coursework with        *
+*                                                       *
+*  Currently just draws a teapot                        *
+*  Written as a resource for CM20219 coursework         *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "display.h"
+
+
+/* Global variables */
+SKELETON* gSkel;			/* Holds skeleton data - available to any function */
+MOCAP*	  gMo;				/* Hold motion data - available to any function */
+int		  gDelay=0;			/* Holds delay information - available to any function */
+int currentFrame = 0;       /* Frame of gMo to show when it isn't sampled from gTrack */
+int initialPose = 0;		/* Boolean for displaying skeleton in initial position (if user presses 'f' key) */
+int referenceFrame = 0;
+RIG*	  gRig;				/* Compiled skeleton the poses are worked out on */
+
+/* Global variables for the pose producer thread - it owns the clip (gMo, gStream, gFollow, gTrack) and GLUT only draws */
+POSEBUF*  gPoses;			/* Poses on their way from the producer to display() */
+THREAD	  gProducer;
+MUTEX	  gClockLock;		/* Guards gClock, initialPose, gRequest and gQuit, which the keyboard changes under the producer */
+CONDVAR	  gWake;			/* Signalled with gClockLock held when a key is pressed, so the producer stops waiting */
+int		  gRequest = 0;		/* Bumped by every key press, so the producer poses again even when clip time stands still */
+int		  gDrawnRequest = 0;	/* gRequest of the pose last drawn */
+double	  gProducedFrame = -1;	/* Clip time and gRequest of the last pose published (producer only) */
+int		  gProducedRequest = -1;
+volatile int gQuit = 0;		/* Tells the producer to stop */
+
+/* Global variables for timing playback */
+PLAYCLOCK* gClock;			/* Which (fractional) frame to show at any instant */
+POSETRACK* gTrack = NULL;	/* Quaternions of a fully loaded clip, to pose the skeleton between frames */
+TRACKPOSE* gSample = NULL;	/* gTrack at the time being drawn */
+int		  gStreamFrame = 0;	/* Frame of the stream held in gFrame (0 based) */
+
+/* Global variables for streamed playback (see dorenderstream) */
+AMCSTREAM* gStream = NULL;	/* Open AMC stream, NULL when playing a fully loaded MOCAP */
+AMCFRAME  gFrame;			/* The one frame held in memory */
+MOCAP	  gFrameMo;			/* One frame MOCAP view of gFrame handed to the draw functions */
+
+/* Global variables for follow mode (see dorenderfollow) */
+AMCFOLLOW* gFollow = NULL;	/* AMC file being followed as it grows, NULL otherwise */
+FILEWATCH* gWatch = NULL;	/* Tells us when there is something new to parse */
+
+
+/* Global variables for the GL resources */
+GLRESCOUNT gFrameCount;		/* What the last frame made and uploaded - all of it should be done once in init() */
+int		  gFrameWarned = 0;	/* Only say once that frames are making or uploading resources */
+
+/* Global variables for the camera position */
+float rCamera = 70, thetaCamera = PI/4, phiCamera = -PI/2;
+
+/* Entry point from MAIN.C */
+void dorender(int argc, char** argv, SKELETON* skel, MOCAP* mo, int delay) {
+
+
+	/* Create GLUT window */
+   glutInit(&argc, argv);
+   glutInitDisplayMode (GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
+   glutInitWindowSize (600, 600);
+   glutCreateWindow ("Mocap Viewer");
+
+   /* Setup GLUT callbacks */
+   glutReshapeFunc (reshape);
+   glutKeyboardFunc (keyboard);
+   glutDisplayFunc (display);
+   glutIdleFunc (idle);
+
+   /* Initialise any OpenGL state */
+   init();
+
+	/* Set global variables */
+   gSkel=skel;
+   gMo=mo;
+   gDelay=delay;
+   gRig=rig_compile(skel);
+   gPoses=posebuf_create(gRig);
+
+   /* Streamed and followed clips have no known end; a loaded clip loops, and can be posed between its frames */
+   gClock=playclock_create((delay>0) ? 1000.0/delay : 0, (gStream || gFollow) ? 0 : mo->frames_enum);
+   if (!gStream && !gFollow) {
+	   gTrack=track_create(gRig,mo);
+	   gSample=track_createpose(gTrack);
+   }
+
+   /* The first pose is ready before the first display, then a thread of its own works out the rest */
+   mutex_init(&gClockLock);
+   condvar_init(&gWake);
+   producePose();
+#ifdef WIN32
+   gProducer=CreateThread(NULL,0,producer,NULL,0,NULL);
+#else
+   pthread_create(&gProducer,NULL,producer,NULL);
+#endif
+
+   /* Kick off the GLUT main loop */
+   /* This call will never return */
+   glutMainLoop();
+   
+
+}
+
+
+/* Entry point from MAIN.C for clips too long to load - only the current frame is held in memory */
+void dorenderstream(int argc, char** argv, SKELETON* skel, AMCSTREAM* stream, int delay) {
+
+	gStream=stream;
+	gFrame.bones_orient=(POINT3D*)calloc(skel->bonearray_enum,sizeof(POINT3D));
+	parser_nextFrame(gStream,&gFrame);
+	parser_frameview(&gFrame,&gFrameMo);
+
+	dorender(argc,argv,skel,&gFrameMo,delay);
+
+}
+
+
+/* Entry point from MAIN.C for live capture - the AMC file is still being written while we play it */
+void dorenderfollow(int argc, char** argv, SKELETON* skel, AMCFOLLOW* follow, FILEWATCH* watch, int delay) {
+
+	gFollow=follow;
+	gWatch=watch;
+
+	/* Whatever was written before we started */
+	parser_followMocap(gFollow);
+	if (gFollow->frames_ready)
+		currentFrame=gFollow->frames_ready-1;
+
+	dorender(argc,argv,skel,gFollow->mocap,delay);
+
+}
+
+
+/* Keyboard callback from GLUT */
+void keyboard(unsigned char key, int x, int y)
+{
+	switch(key) {
+
+			/* If the ESCAPE key is pressed we have to force an exit.
+			 * There is no graceful way to exit the GLUT loop unfortunately.
+			 */
+			case 0x1b:  /* 0x1b (27 decimal) is the ASCII code for the ESCAPE */
+						/* Stop the producer before freeing anything it works on */
+						mutex_lock(&gClockLock);
+						gQuit=1;
+						condvar_broadcast(&gWake);
+						mutex_unlock(&gClockLock);
+#ifdef WIN32
+						WaitForSingleObject(gProducer,INFINITE);
+						CloseHandle(gProducer);
+#else
+						pthread_join(gProducer,NULL);
+#endif
+						if (gStream) {
+							parser_closeMocapStream(gStream);
+							free(gFrame.bones_orient);
+						}
+						else if (gFollow) {
+							filewatch_close(gWatch);
+							parser_closeMocapFollow(gFollow);
+						}
+						else {
+							parser_free_mocap(gMo);
+						}
+						if (gTrack) {
+							track_freepose(gSample);
+							track_free(gTrack);
+						}
+						playclock_free(gClock);
+						condvar_destroy(&gWake);
+						mutex_destroy(&gClockLock);
+						posebuf_free(gPoses);
+						drawShutdown();
+						rig_free(gRig);
+						parser_free_skeleton(gSkel);
+						exit(0);
+						break;
+
+			case 'f':	/* If the 'f' key is pressed enable intial pose view*/
+						mutex_lock(&gClockLock);
+						if (initialPose)
+							initialPose = 0;
+						else
+							initialPose = 1;
+						mutex_unlock(&gClockLock);
+
+						break;
+
+
+			/* If the 'r' key is pressed change boolean referenceFrames to true
+			 * and display the reference frames for each joint
+			 */
+			case 'r':
+						if (referenceFrame)
+							referenceFrame = 0;
+						else
+							referenceFrame = 1;
+
+						break;
+
+
+
+			/* Keyboard input to handle camera position. 
+			 * 'q' and 'e' are used to zoom in and out. They modify the R (distance from origin) in our polar coordinates.
+			 * 'a' and 'd' modify the angle phi (angle between the X-axis and the Y-axis) used to rotate right and left.
+			 * 'w' and 's' modify the theta angle (angle between the Z-axis and R) used to rotate up and down.
+			 */
+
+			case 'e':
+						rCamera-=2;
+						if(rCamera < 1)
+							rCamera = 1;
+						break;
+
+			case 'q':
+						rCamera+=2;
+						break;
+
+			case 'a':
+						phiCamera-=CAMERA_SENS;
+						break;
+
+			case 'd':
+						phiCamera+=CAMERA_SENS;
+						break;
+
+			case 'w':
+						thetaCamera-=CAMERA_SENS;
+						if (thetaCamera < 0)
+							thetaCamera+=CAMERA_SENS;
+						break;
+
+			case 's':
+						thetaCamera+=CAMERA_SENS;
+						if (thetaCamera > PI/2)
+							thetaCamera-=CAMERA_SENS;
+						break;
+
+
+			/* Playback - every key works on the one clock, so the clip carries on from wherever it was left.
+			 * SPACE pauses, ',' and '.' step a frame, '<' and '>' a second, '+' and '-' double and halve the speed
+			 * and '1' goes back to normal speed.  A followed file always shows its newest frame, so only pauses.
+			 */
+			case ' ':
+						mutex_lock(&gClockLock);
+						playclock_pause(gClock, !gClock->paused);
+						mutex_unlock(&gClockLock);
+						break;
+
+			case ',':
+			case '.':
+			case '<':
+			case '>':
+						if (gFollow)
+							break;
+						mutex_lock(&gClockLock);
+						playclock_pause(gClock, 1);
+						playclock_seek(gClock, playclock_frame(gClock)+((key==',' || key=='<') ? -1 : 1)*((key=='<' || key=='>') ? gClock->fps : 1));
+						mutex_unlock(&gClockLock);
+						break;
+
+			case '+':
+			case '=':
+						mutex_lock(&gClockLock);
+						if (!gFollow && fabs(gClock->speed) < SPEED_MAX)
+							playclock_setspeed(gClock, gClock->speed*2);
+						mutex_unlock(&gClockLock);
+						break;
+
+			case '-':
+						mutex_lock(&gClockLock);
+						if (!gFollow && fabs(gClock->speed) > 1/SPEED_MAX)
+							playclock_setspeed(gClock, gClock->speed/2);
+						mutex_unlock(&gClockLock);
+						break;
+
+			case '1':
+						mutex_lock(&gClockLock);
+						playclock_setspeed(gClock, 1);
+						mutex_unlock(&gClockLock);
+						break;
+	}
+
+	/* Show the change even while paused - the camera straight away, and the skeleton once the producer
+	   has posed it again, which idle waits for */
+	mutex_lock(&gClockLock);
+	gRequest++;
+	condvar_broadcast(&gWake);
+	mutex_unlock(&gClockLock);
+	glutIdleFunc(idle);
+	glutPostRedisplay();
+}
+
+/* Bring the frame held from the stream up to target - streams only read forwards, so going back starts again */
+int seekStream(int target) {
+
+	if (!gStream)
+		return 1;
+
+	if (target < gStreamFrame) {
+		parser_rewindMocapStream(gStream);
+		parser_nextFrame(gStream,&gFrame);
+		gStreamFrame=0;
+	}
+
+	/* Any frames the display was too slow to show are read and dropped */
+	while (gStreamFrame < target) {
+		if (!parser_nextFrame(gStream,&gFrame)) {
+			/* Off the end - loop round to the start */
+			parser_rewindMocapStream(gStream);
+			parser_nextFrame(gStream,&gFrame);
+			gStreamFrame=0;
+			return 0;
+		}
+		gStreamFrame++;
+	}
+
+	return 1;
+
+}
+
+/* Called back when GLUT idling - never blocks, just draws whatever the producer has finished */
+void idle() {
+
+	double wait;
+
+	if (posebuf_pending(gPoses)) {
+		glutPostRedisplay();
+		return;
+	}
+
+	/* Nothing new yet, so rather than spin here sleep in a GLUT timer until the pose can next have changed.
+	   Once paused and showing the answer to the last key press there is nothing more to come */
+	glutIdleFunc(NULL);
+	if (gClock->paused && gDrawnRequest == gRequest)
+		return;
+
+	wait = poseWait();
+	if (wait < 0 || (gDrawnRequest != gRequest && wait > POSE_REFRESH))
+		wait = POSE_REFRESH;
+	glutTimerFunc(wait*1000 < 1 ? 1 : (unsigned int)ceil(wait*1000), wakeIdle, 0);
+}
+
+/* Called back by the GLUT timer idle() set */
+void wakeIdle(int value) {
+
+	(void)value;
+	glutIdleFunc(idle);
+}
+
+/* Seconds until the pose could next change, -1 if only a key press can change it */
+double poseWait() {
+
+	double frame, rate, wait;
+	int paused;
+
+	mutex_lock(&gClockLock);
+	frame = playclock_frame(gClock);
+	rate = gClock->fps*gClock->speed;
+	paused = gClock->paused;
+	mutex_unlock(&gClockLock);
+
+	/* A followed file grows whatever the clock is doing, and poses between frames move all the time */
+	if (gFollow || (gTrack && !paused))
+		return POSE_REFRESH;
+	if (paused)
+		return -1;
+
+	/* A stream only moves on when the clock reaches its next whole frame */
+	wait = (rate > 0) ? floor(frame)+1-frame : frame-floor(frame);
+	if (wait <= 0)
+		wait = 1;
+	return wait/fabs(rate);
+}
+
+/* Pose producer thread - keeps publishing as the clock moves, whether or not display() has taken the last
+   pose, so the one drawn is never older than a refresh.  In between it sleeps until the pose can next change */
+#ifdef WIN32
+DWORD WINAPI producer(LPVOID arg) {
+#else
+void* producer(void* arg) {
+#endif
+
+	double wait;
+
+	(void)arg;
+
+	while (!gQuit) {
+		producePose();
+		wait = poseWait();
+
+		/* A key press since the pose just made is answered straight away */
+		mutex_lock(&gClockLock);
+		if (!gQuit && gRequest == gProducedRequest) {
+			if (wait < 0)
+				condvar_wait(&gWake, &gClockLock);
+			else
+				condvar_timedwait(&gWake, &gClockLock, wait);
+		}
+		mutex_unlock(&gClockLock);
+	}
+
+	return 0;
+
+}
+
+int producePose() {
+
+	POSESLOT* slot;
+	double frame;		/* Clip time to pose */
+	int request, posed, target, changed;
+
+	/* A followed file is only parsed when it has been written to or replaced, and then shows its newest frame.
+	   Starting again can leave fewer frames than before, so any change in the count moves to the newest */
+	if (gFollow && (changed=filewatch_changed(gWatch))) {
+		if (changed==FILEWATCH_REPLACED)
+			parser_reopenMocapFollow(gFollow);
+		if (parser_followMocap(gFollow)!=0 && gFollow->frames_ready)
+			currentFrame=gFollow->frames_ready-1;
+	}
+
+	/* Everything the keyboard can change, read in one go */
+	mutex_lock(&gClockLock);
+	frame = playclock_frame(gClock);
+	request = gRequest;
+	posed = !initialPose && (gFollow ? gFollow->frames_ready>0 : 1);
+	mutex_unlock(&gClockLock);
+
+	/* Stream reads happen with the lock released, so a key press never waits on the disk */
+	target = (int)frame;
+	if (!seekStream(target)) {
+		/* Off the end - loop round to the start */
+		mutex_lock(&gClockLock);
+		playclock_seek(gClock, 0);
+		mutex_unlock(&gClockLock);
+	}
+	if (!gTrack)
+		frame = gFollow ? gFollow->frames_ready-1 : gStreamFrame;
+
+	if (frame == gProducedFrame && request == gProducedRequest)
+		return 0;
+
+	/* Pose the skeleton, between frames if the whole clip is loaded */
+	slot = posebuf_back(gPoses);
+	if (!posed) {
+		fk_initialpose(gRig, slot->pose);
+	} else if (gTrack) {
+		track_sample(gTrack, frame, TRACK_SLERP, gSample);
+		track_pose(gRig, gSample, slot->pose);
+		slot->root = gSample->root_pos;
+	} else {
+		fk_pose(gRig, gMo, currentFrame, slot->pose);
+		slot->root = gMo->root_pos[currentFrame];
+	}
+	slot->frame = frame;
+	slot->posed = posed;
+	slot->request = request;
+	posebuf_publish(gPoses);
+
+	gProducedFrame = frame;
+	gProducedRequest = request;
+	return 1;
+
+}
+
+/* Called back by GLUT when the window is resized */
+void reshape(int w, int h)
+{
+
+   glViewport(0, 0, w, h);
+   glMatrixMode(GL_PROJECTION);
+   glLoadIdentity();
+   
+   gluPerspective(60,(GLfloat)w/(GLfloat)h,0.01,1000.0);
+   glMatrixMode(GL_MODELVIEW);
+   glLoadIdentity();
+
+}
+
+/* Called by us in dorender() to init any OpenGL state */
+/* It is good practice to keep this in a separate function from dorender() */
+void init(void)
+{  
+
+	GLfloat mat_specular[] = {1, 1, 1, 1};
+	GLfloat light_position[] = {0, 0.5, 0.5, 0.0};
+
+	glClearColor (0.0, 0.0, 0.0, 0.0);
+
+	/* Material */
+	glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, mat_specular);
+	glMateriali(GL_FRONT_AND_BACK, GL_SHININESS, 96);
+	glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
+
+	glEnable(GL_COLOR_MATERIAL);
+
+	/* Lighting */
+	glEnable(GL_LIGHTING);
+	glEnable(GL_LIGHT0);
+	glLightfv(GL_LIGHT0, GL_POSITION, light_position);
+
+
+	/* OpenGL Rendering engine parameters */
+	glShadeModel (GL_SMOOTH);
+	glPolygonMode (GL_FRONT_AND_BACK, GL_FILL);
+	glHint(GL_PERSPECTIVE_CORRECTION_HINT,GL_NICEST);
+	glEnable(GL_DEPTH_TEST);
+
+	/* Swap on the display's refresh so drawing goes no faster than it can be seen */
+	glres_swapinterval(1);
+
+	/* Meshes and textures, built once for every frame to draw with, then count each frame on its own */
+	drawInit();
+	glres_endframe(NULL);
+
+}
+
+
+/* Called when GLUT wants to repaint the screen (we do all our rendering/geometry here) */
+void display(void)
+{
+	float xCamera, yCamera, zCamera;	/* Camera coordinates */
+	float xRoot, yRoot, zRoot;			/* Root position */
+	POSESLOT* slot;						/* Newest pose from the producer, never waited for */
+	
+	/* Clear frame buffer and set up MODELVIEW matrix */
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);	
+    glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	/* Calculate the camera position using polar coordinates */
+	xCamera = rCamera*sin(thetaCamera)*cos(phiCamera);
+	yCamera = rCamera*sin(thetaCamera)*sin(phiCamera);
+	zCamera = rCamera*cos(thetaCamera);
+
+	slot = posebuf_latest(gPoses);
+	gDrawnRequest = slot->request;
+
+	if(!slot->posed) {
+
+		/* Place the camera and draw the skeleton in its initial position */
+		gluLookAt(xCamera, yCamera, zCamera, 0, 0, 0, 0, 0, 1);
+		drawSkeleton(gRig, slot->pose, referenceFrame);
+
+	} else {
+
+		/* Calculate root postion */
+		xRoot = slot->root.x;
+		yRoot = -slot->root.z;
+		zRoot = slot->root.y;
+
+		/* Place camera at specified position and draw the skeleton under mocap data */
+		gluLookAt(xCamera+xRoot, yCamera+yRoot, zCamera+zRoot, xRoot, yRoot, zRoot, 0, 0, 1);
+		drawSkeleton(gRig, slot->pose, referenceFrame);
+	}
+
+
+	drawFloor(140, 140);
+	
+	if(referenceFrame)
+		drawReferenceFrame(20);
+	
+	/* Ensure any queued up OpenGL calls are run and swap buffers */
+	glFlush();
+	glutSwapBuffers();
+
+	/* The render loop should only ever stream instances - anything made or uploaded here is a leak */
+	glres_endframe(&gFrameCount);
+	if ((gFrameCount.allocations || gFrameCount.uploads) && !gFrameWarned) {
+		printf("WARNING:  A frame made %d GL resources and uploaded %d (%ld bytes)\n", gFrameCount.allocations, gFrameCount.uploads, gFrameCount.upload_bytes);
+		gFrameWarned = 1;
+	}
+
+}
+
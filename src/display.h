@@ -1,43 +1,63 @@
-#ifndef COLLOMOSSE_MOCAP_DISPLAY_INCLUDED
-#define COLLOMOSSE_MOCAP_DISPLAY_INCLUDED
-
-/*******************************************************\
-*                                                       *
-*  DISPLAY.H                                            *
-*  Outline solution to begin the coursework with        *
-*                                                       *
-*  Currently just draws a teapot                        *
-*  Written as a resource for CM20219 coursework         *
-*                                                       *
-*  (c) John Collomosse, University of Bath              *
-*  September 2008                                       *
-*                                                       *
-\*******************************************************/
-
-
-#ifdef WIN32
-	#include "windows.h"
-	#define strcasecmp stricmp
-#endif
-
-#include "GL/gl.h"
-#include "GL/glut.h"
-
-#include <math.h>
-
-#include "parser.h"
-#include "draw.h"
-
-#define CAMERA_SENS 0.07		/* This is the camera sensibility or the incremental step for the camera angles */
-#define PI 3.14159				/* Defines the pi constant used for angles */
-
-void dorender(int argc, char** argv, SKELETON* skel, MOCAP* mo, int delay);
-
-/* GLUT callbacks */
-void keyboard(unsigned char key, int x, int y);
-void reshape(int w, int h);
-void init(void);
-void display(void);
-void idle(void);
-
+#ifndef COLLOMOSSE_MOCAP_DISPLAY_INCLUDED
+#define COLLOMOSSE_MOCAP_DISPLAY_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  DISPLAY.H                                            *
+*  Outline solution to begin the coursework with        *
+*                                                       *
+*  Currently just draws a teapot                        *
+*  Written as a resource for CM20219 coursework         *
+*                                                       *
+*  (c) John Collomosse, University of Bath              *
+*  September 2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#ifdef WIN32
+	#include "windows.h"
+	#define strcasecmp stricmp
+#endif
+
+#include "GL/gl.h"
+#include "GL/glut.h"
+
+#include <math.h>
+
+#include "parser.h"
+#include "filewatch.h"
+#include "draw.h"
+#include "track.h"
+#include "playclock.h"
+#include "posebuf.h"
+#include "threadpool.h"
+
+#define CAMERA_SENS 0.07		/* This is the camera sensibility or the incremental step for the camera angles */
+#define SPEED_MAX 16.0			/* Fastest (and 1/SPEED_MAX slowest) playback the + and - keys reach */
+#define POSE_REFRESH (1.0/60)	/* Seconds between poses when they change all the time (between frames, or a followed file) */
+#define PI 3.14159				/* Defines the pi constant used for angles */
+
+void dorender(int argc, char** argv, SKELETON* skel, MOCAP* mo, int delay);	/* delay>0 plays a frame every delay ms, else at the capture rate */
+void dorenderstream(int argc, char** argv, SKELETON* skel, AMCSTREAM* stream, int delay);	/* As dorender but reads frames as they are played */
+void dorenderfollow(int argc, char** argv, SKELETON* skel, AMCFOLLOW* follow, FILEWATCH* watch, int delay);	/* As dorender but shows the newest frame of a file still being written */
+
+/* GLUT callbacks */
+void keyboard(unsigned char key, int x, int y);
+void reshape(int w, int h);
+void init(void);
+void display(void);
+void idle(void);
+void wakeIdle(int value);	/* GLUT timer - idle() again once the pose can have changed */
+double poseWait(void);		/* Seconds until the pose could next change, -1 if only a key press can change it */
+int seekStream(int target);	/* Read the stream up to frame target (producer thread, gClockLock not held) - 0 if it ran off the end and went back to the start */
+
+/* Pose producer thread - works out poses into gPoses while GLUT draws them */
+#ifdef WIN32
+DWORD WINAPI producer(LPVOID arg);
+#else
+void* producer(void* arg);
+#endif
+int producePose(void);			/* Publish the pose at the clip's current time - 0 if nothing has changed since the last one */
+
 #endif
\ No newline at end of file
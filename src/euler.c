@@ -0,0 +1,273 @@
+/*******************************************************\
+*                                                       *
+*  EULER.C                                              *
+*  Rotations from many triples of Euler angles at once  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <math.h>
+#include "euler.h"
+#include "simd.h"
+
+/* sin and cos on [-45, 45] degrees (as radians) - minimax polynomials good to a float ulp or so */
+#define SIN_C1	(-1.6666654611e-1f)
+#define SIN_C2	(8.3321608736e-3f)
+#define SIN_C3	(-1.9515295891e-4f)
+#define COS_C1	(4.166664568298827e-2f)
+#define COS_C2	(-1.388731625493765e-3f)
+#define COS_C3	(2.443315711809948e-5f)
+
+
+/* Internal prototypes */
+
+void	euler_sincos(const POINT3D*, int, int, double, double*, double*);	/* Sines and cosines of a block of triples, [triple*3+axis], angles scaled first */
+void	euler_sincosv(SIMDVEC, SIMDVEC*, SIMDVEC*);						/* sin and cos of SIMD_WIDTH angles in degrees */
+void	euler_product(const double*, const double*, double[3][3]);		/* Rz.Ry.Rx from the sines and cosines of x, y and z */
+
+
+void euler_matrices(const POINT3D* angles, int n, int mode, MAT3* out) {
+
+	double	s[3*EULER_BLOCK], c[3*EULER_BLOCK];
+	double	d[3][3];
+	int		b, i, k, r, j;
+
+	for (b=0; b<n; b+=EULER_BLOCK) {
+		k=(n-b<EULER_BLOCK) ? n-b : EULER_BLOCK;
+		euler_sincos(angles+b,k,mode,1,s,c);
+
+		/* Worked out in double and only rounded to float at the end */
+		for (i=0; i<k; i++) {
+			euler_product(s+i*3,c+i*3,d);
+			for (r=0; r<3; r++)
+				for (j=0; j<3; j++)
+					out[b+i].m[r][j]=(float)d[r][j];
+		}
+	}
+
+}
+
+void euler_matrixd(double x, double y, double z, double m[3][3]) {
+
+	double s[3], c[3];
+
+	s[0]=sin(x);	c[0]=cos(x);
+	s[1]=sin(y);	c[1]=cos(y);
+	s[2]=sin(z);	c[2]=cos(z);
+	euler_product(s,c,m);
+
+}
+
+void euler_product(const double* s, const double* c, double m[3][3]) {
+
+	double sx=s[0], cx=c[0];
+	double sy=s[1], cy=c[1];
+	double sz=s[2], cz=c[2];
+
+	/* Rz.Ry.Rx multiplied out */
+	m[0][0]=cz*cy;	m[0][1]=cz*sy*sx-sz*cx;	m[0][2]=cz*sy*cx+sz*sx;
+	m[1][0]=sz*cy;	m[1][1]=sz*sy*sx+cz*cx;	m[1][2]=sz*sy*cx-cz*sx;
+	m[2][0]=-sy;	m[2][1]=cy*sx;			m[2][2]=cy*cx;
+
+}
+
+void euler_quats(const POINT3D* angles, int n, int mode, QUAT* out) {
+
+	double	s[3*EULER_BLOCK], c[3*EULER_BLOCK];
+	double	sx, cx, sy, cy, sz, cz;
+	QUAT*	q;
+	int		b, i, k;
+
+	for (b=0; b<n; b+=EULER_BLOCK) {
+		k=(n-b<EULER_BLOCK) ? n-b : EULER_BLOCK;
+		euler_sincos(angles+b,k,mode,0.5,s,c);
+
+		/* qz.qy.qx with q = cos(a/2) + sin(a/2) about the axis */
+		for (i=0; i<k; i++) {
+			sx=s[i*3];	cx=c[i*3];
+			sy=s[i*3+1];	cy=c[i*3+1];
+			sz=s[i*3+2];	cz=c[i*3+2];
+			q=out+b+i;
+			q->w=(float)(cz*cy*cx+sz*sy*sx);
+			q->x=(float)(cz*cy*sx-sz*sy*cx);
+			q->y=(float)(cz*sy*cx+sz*cy*sx);
+			q->z=(float)(sz*cy*cx-cz*sy*sx);
+		}
+	}
+
+}
+
+void euler_rotatevectors(const POINT3D* angles, int n, int mode, POINT3D* v) {
+
+	double	s[3*EULER_BLOCK], c[3*EULER_BLOCK];
+	double	x, y, z;
+	POINT3D* p;
+	int		b, i, k;
+
+	for (b=0; b<n; b+=EULER_BLOCK) {
+		k=(n-b<EULER_BLOCK) ? n-b : EULER_BLOCK;
+		euler_sincos(angles+b,k,mode,1,s,c);
+
+		/*
+		 * One axis at a time, rounding to float in between, as the three matrix_transform_affine calls of
+		 * rotateVector.  The terms those 4x4 products multiplied by zero can only change the sign of a zero
+		 * result, and their final +0 turns any zero into +0, so adding 0.0 gives the very same bits
+		 */
+		for (i=0; i<k; i++) {
+			p=v+b+i;
+
+			x=p->x;	y=p->y;	z=p->z;
+			p->x=(float)(c[i*3+2]*x-s[i*3+2]*y+0.0);
+			p->y=(float)(s[i*3+2]*x+c[i*3+2]*y+0.0);
+			p->z=(float)(z+0.0);
+
+			x=p->x;	y=p->y;	z=p->z;
+			p->x=(float)(c[i*3+1]*x+s[i*3+1]*z+0.0);
+			p->y=(float)(y+0.0);
+			p->z=(float)(-s[i*3+1]*x+c[i*3+1]*z+0.0);
+
+			x=p->x;	y=p->y;	z=p->z;
+			p->x=(float)(x+0.0);
+			p->y=(float)(c[i*3]*y-s[i*3]*z+0.0);
+			p->z=(float)(s[i*3]*y+c[i*3]*z+0.0);
+		}
+	}
+
+}
+
+void euler_apply(const MAT3* m, const POINT3D* in, int n, POINT3D* out) {
+
+	double	x, y, z;
+	int		i;
+
+	for (i=0; i<n; i++) {
+		x=in[i].x;	y=in[i].y;	z=in[i].z;
+		out[i].x=(float)(m[i].m[0][0]*x+m[i].m[0][1]*y+m[i].m[0][2]*z);
+		out[i].y=(float)(m[i].m[1][0]*x+m[i].m[1][1]*y+m[i].m[1][2]*z);
+		out[i].z=(float)(m[i].m[2][0]*x+m[i].m[2][1]*y+m[i].m[2][2]*z);
+	}
+
+}
+
+void euler_applyquat(const QUAT* q, const POINT3D* in, int n, POINT3D* out) {
+
+	double	x, y, z, tx, ty, tz;
+	int		i;
+
+	/* v + w.t + u x t with t = 2(u x v) - no matrix needed */
+	for (i=0; i<n; i++) {
+		x=in[i].x;	y=in[i].y;	z=in[i].z;
+		tx=2*((double)q[i].y*z-(double)q[i].z*y);
+		ty=2*((double)q[i].z*x-(double)q[i].x*z);
+		tz=2*((double)q[i].x*y-(double)q[i].y*x);
+		out[i].x=(float)(x+q[i].w*tx+(q[i].y*tz-q[i].z*ty));
+		out[i].y=(float)(y+q[i].w*ty+(q[i].z*tx-q[i].x*tz));
+		out[i].z=(float)(z+q[i].w*tz+(q[i].x*ty-q[i].y*tx));
+	}
+
+}
+
+void euler_sincos(const POINT3D* angles, int n, int mode, double scale, double* s, double* c) {
+
+	double	r[3*EULER_BLOCK];
+	float	a[3*EULER_BLOCK], fs[3*EULER_BLOCK], fc[3*EULER_BLOCK];
+	const float* deg=(const float*)angles;	/* POINT3D is three floats */
+	int		i;
+
+	/* Only need agree with fk_pose to within a float, so the polynomials do, a vector at a time */
+	if (mode==EULER_EXACT) {
+		euler_sincosdeg(deg,3*n,(float)scale,fs,fc);
+		for (i=0; i<3*n; i++) {
+			s[i]=fs[i];
+			c[i]=fc[i];
+		}
+		return;
+	}
+
+	/* Loaded skeletons must come out exactly as rotateVector left them, libm and all.  Radians first, so the
+	   sin and cos loop below has nothing else in it.  rotationX/Y/Z rounded the radians to a float, which is
+	   kept in an array of floats for every compiler to honour */
+	for (i=0; i<3*n; i++)
+		a[i]=(float)(deg[i]*PI/180.);
+	for (i=0; i<3*n; i++)
+		r[i]=a[i]*scale;
+
+	for (i=0; i<3*n; i++) {
+		s[i]=sin(r[i]);
+		c[i]=cos(r[i]);
+	}
+
+}
+
+void euler_sincosdeg(const float* deg, int n, float scale, float* s, float* c) {
+
+	SIMDVEC	vs, vc;
+	float	tail[SIMD_WIDTH], ts[SIMD_WIDTH], tc[SIMD_WIDTH];
+	int		i, j;
+
+	for (i=0; i+SIMD_WIDTH<=n; i+=SIMD_WIDTH) {
+		euler_sincosv(V_MUL(V_LOAD(deg+i),V_SET1(scale)),&vs,&vc);
+		V_STORE(s+i,vs);
+		V_STORE(c+i,vc);
+	}
+
+	/* Whatever is left over goes through one last vector, padded with zeros */
+	if (i<n) {
+		for (j=0; j<SIMD_WIDTH; j++)
+			tail[j]=(i+j<n) ? deg[i+j] : 0.0f;
+		euler_sincosv(V_MUL(V_LOAD(tail),V_SET1(scale)),&vs,&vc);
+		V_STORE(ts,vs);
+		V_STORE(tc,vc);
+		for (j=0; i+j<n; j++) {
+			s[i+j]=ts[j];
+			c[i+j]=tc[j];
+		}
+	}
+
+}
+
+void euler_sincosv(SIMDVEC deg, SIMDVEC* s, SIMDVEC* c) {
+
+	SIMDVEC	r, r2, ps, pc;
+
+#ifdef SIMD_SCALAR
+	int		q;
+
+	/* Nearest multiple of 90 degrees, then the polynomials on what is left */
+	q=(int)floor(deg/90.0f+0.5f);
+	r=(deg-(float)q*90.0f)*(float)EULER_DEG2RAD;
+	r2=r*r;
+	ps=r+r*r2*(SIN_C1+r2*(SIN_C2+r2*SIN_C3));
+	pc=1.0f-0.5f*r2+r2*r2*(COS_C1+r2*(COS_C2+r2*COS_C3));
+
+	switch (q&3) {
+		case 0:	*s=ps;	*c=pc;	break;
+		case 1:	*s=pc;	*c=-ps;	break;
+		case 2:	*s=-ps;	*c=-pc;	break;
+		default:*s=-pc;	*c=ps;	break;
+	}
+#else
+	SIMDVECI	q;
+
+	/* Nearest multiple of 90 degrees (the default rounding mode), then the polynomials on what is left */
+	q=V_ROUND(V_MUL(deg,V_SET1(1.0f/90.0f)));
+	r=V_MUL(V_SUB(deg,V_MUL(V_FROMINT(q),V_SET1(90.0f))),V_SET1((float)EULER_DEG2RAD));
+	r2=V_MUL(r,r);
+	ps=V_ADD(V_SET1(SIN_C2),V_MUL(r2,V_SET1(SIN_C3)));
+	ps=V_ADD(V_SET1(SIN_C1),V_MUL(r2,ps));
+	ps=V_ADD(r,V_MUL(V_MUL(r,r2),ps));
+	pc=V_ADD(V_SET1(COS_C2),V_MUL(r2,V_SET1(COS_C3)));
+	pc=V_ADD(V_SET1(COS_C1),V_MUL(r2,pc));
+	pc=V_ADD(V_SUB(V_SET1(1.0f),V_MUL(V_SET1(0.5f),r2)),V_MUL(V_MUL(r2,r2),pc));
+
+	/* Odd quadrants swap sin and cos, the sign bits come from bit 1 of q and q+1 */
+	*s=V_SELECT(VI_CMPEQ(VI_AND(q,VI_SET1(1)),VI_SET1(1)),pc,ps);
+	*c=V_SELECT(VI_CMPEQ(VI_AND(q,VI_SET1(1)),VI_SET1(1)),ps,pc);
+	*s=V_FLIP(*s,VI_SHL(VI_AND(q,VI_SET1(2)),30));
+	*c=V_FLIP(*c,VI_SHL(VI_AND(VI_ADD(q,VI_SET1(1)),VI_SET1(2)),30));
+#endif
+
+}
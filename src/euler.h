@@ -0,0 +1,56 @@
+#ifndef COLLOMOSSE_MOCAP_EULER_INCLUDED
+#define COLLOMOSSE_MOCAP_EULER_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  EULER.H                                              *
+*  Rotations from many triples of Euler angles at once  *
+*                                                       *
+*  Works out the sine and cosine of each angle once,    *
+*  for a whole block of triples, then builds matrices   *
+*  or quaternions from them or rotates vectors by them  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "parser.h"
+
+/* How angles in degrees become radians */
+#define EULER_ASF		(0)		/* With PI from parser.h (3.141) and through a float, as rotationX/Y/Z always have - directions of loaded skeletons */
+#define EULER_EXACT		(1)		/* With pi to double precision, as glRotatef - the K and R of forward kinematics */
+
+/* Degrees to radians in EULER_EXACT */
+#define EULER_DEG2RAD	(3.14159265358979323846/180.0)
+
+/* Triples worked on together - the sines and cosines of a block sit on the stack */
+#define EULER_BLOCK		(64)
+
+/* Type for a 3x3 rotation - m[row][column], so v'=m.v */
+typedef struct _mat3 {
+
+	float	m[3][3];
+
+} MAT3;
+
+/* Type for a rotation as a unit quaternion w+xi+yj+zk */
+typedef struct _quat {
+
+	float	w;
+	float	x;
+	float	y;
+	float	z;
+
+} QUAT;
+
+
+void	euler_matrices(const POINT3D* angles, int n, int mode, MAT3* out);			/* out[i] = Rz(z).Ry(y).Rx(x) of angles[i] (degrees) */
+void	euler_matrixd(double x, double y, double z, double m[3][3]);				/* m = Rz(z).Ry(y).Rx(x) in double, angles in radians */
+void	euler_quats(const POINT3D* angles, int n, int mode, QUAT* out);				/* The same rotations as quaternions qz.qy.qx */
+void	euler_rotatevectors(const POINT3D* angles, int n, int mode, POINT3D* v);	/* v[i] = Rx.Ry.Rz.v[i], rounded to float after each axis - rotateVector exactly */
+void	euler_apply(const MAT3* m, const POINT3D* in, int n, POINT3D* out);			/* out[i] = m[i].in[i] (in and out may be the same array) */
+void	euler_applyquat(const QUAT* q, const POINT3D* in, int n, POINT3D* out);		/* out[i] = q[i].in[i].q[i]* (in and out may be the same array) */
+void	euler_sincosdeg(const float* deg, int n, float scale, float* s, float* c);	/* s[i], c[i] = sin, cos of deg[i]*scale degrees, SIMD_WIDTH at a time - to a float ulp or so */
+
+#endif
@@ -0,0 +1,167 @@
+/*******************************************************\
+*                                                       *
+*  FILEWATCH.C                                          *
+*  Notification of writes to a file                     *
+*                                                       *
+*  Tells the follow mode viewer when the AMC file it    *
+*  plays has grown or been replaced, without blocking   *
+*  the GLUT loop                                        *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "filewatch.h"
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+
+#ifdef __linux__
+int		filewatch_events(FILEWATCH*, const char*, int);	/* What a buffer of inotify events says happened to the file */
+#else
+int		filewatch_stat(FILEWATCH*);		/* Poll size, modification time and inode - FILEWATCH_WRITTEN or FILEWATCH_REPLACED if they moved */
+#endif
+
+
+FILEWATCH* filewatch_open(char* argFilename) {
+
+	FILEWATCH* fw;
+#ifdef __linux__
+	char* dir;
+	int ok;
+#endif
+
+	fw=(FILEWATCH*)calloc(1,sizeof(FILEWATCH));
+	fw->filename=(char*)malloc(strlen(argFilename)+1);
+	strcpy(fw->filename,argFilename);
+	fw->name=strrchr(fw->filename,'/');
+#ifdef WIN32
+	if (strrchr(fw->filename,'\\')>fw->name)
+		fw->name=strrchr(fw->filename,'\\');
+#endif
+	fw->name=fw->name ? fw->name+1 : fw->filename;
+
+#ifdef __linux__
+	/*
+	 * Watch the directory rather than the file.  A watch on the file follows its inode, so a writer that
+	 * saves to a temporary file and renames it over ours would leave us watching a file nobody can open
+	 */
+	dir=(char*)malloc(strlen(fw->filename)+2);
+	if (fw->name==fw->filename)
+		strcpy(dir,".");
+	else {
+		memcpy(dir,fw->filename,fw->name-fw->filename);
+		dir[fw->name-fw->filename]=0;
+	}
+	ok=((fw->fd=inotify_init1(IN_NONBLOCK|IN_CLOEXEC))!=-1 &&
+		inotify_add_watch(fw->fd,dir,IN_MODIFY|IN_CLOSE_WRITE|IN_ATTRIB|IN_CREATE|IN_MOVED_TO)!=-1);
+	free(dir);
+	if (!ok) {
+		if (fw->fd!=-1)
+			close(fw->fd);
+		free(fw->filename);
+		free(fw);
+		return NULL;
+	}
+#else
+	if (filewatch_stat(fw)==-1) {
+		free(fw->filename);
+		free(fw);
+		return NULL;
+	}
+#endif
+
+	return fw;
+
+}
+
+int filewatch_changed(FILEWATCH* fw) {
+
+#ifdef __linux__
+	/* Drain every queued event - one parse catches up with all of them */
+	char	events[4096];
+	int		changed=0, got;
+	ssize_t	n;
+
+	while ((n=read(fw->fd,events,sizeof(events)))>0)
+		if ((got=filewatch_events(fw,events,(int)n))>changed)
+			changed=got;
+
+	return changed;
+#else
+	/* A file that has gone for now (-1) hasn't changed yet */
+	int changed=filewatch_stat(fw);
+
+	return (changed>0) ? changed : 0;
+#endif
+
+}
+
+void filewatch_close(FILEWATCH* fw) {
+
+#ifdef __linux__
+	close(fw->fd);
+#endif
+	free(fw->filename);
+	free(fw);
+
+}
+
+
+#ifdef __linux__
+
+int filewatch_events(FILEWATCH* fw, const char* events, int len) {
+
+	const struct inotify_event* ev;
+	int changed=0;
+	int i;
+
+	/* Events for everything in the directory come through - only those naming our file count */
+	for (i=0; i+(int)sizeof(struct inotify_event)<=len; i+=sizeof(struct inotify_event)+ev->len) {
+		ev=(const struct inotify_event*)(events+i);
+		if (!ev->len || strcmp(ev->name,fw->name))
+			continue;
+		if (ev->mask&(IN_CREATE|IN_MOVED_TO))
+			changed=FILEWATCH_REPLACED;
+		else if (!changed)
+			changed=FILEWATCH_WRITTEN;
+	}
+
+	return changed;
+
+}
+
+#else
+
+int filewatch_stat(FILEWATCH* fw) {
+
+	struct stat st;
+	int changed=0;
+
+	if (stat(fw->filename,&st))
+		return -1;
+
+	/* A new inode under a name seen before is another file.  Windows has no inode numbers (always 0),
+	   but there a file can't be renamed over while the follower holds it open */
+	if (fw->mtime && (long long)st.st_ino!=fw->ino)
+		changed=FILEWATCH_REPLACED;
+	else if ((long long)st.st_size!=fw->size || (long long)st.st_mtime!=fw->mtime)
+		changed=FILEWATCH_WRITTEN;
+	fw->size=(long long)st.st_size;
+	fw->mtime=(long long)st.st_mtime;
+	fw->ino=(long long)st.st_ino;
+
+	return changed;
+
+}
+
+#endif
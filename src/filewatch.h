@@ -0,0 +1,41 @@
+#ifndef COLLOMOSSE_MOCAP_FILEWATCH_INCLUDED
+#define COLLOMOSSE_MOCAP_FILEWATCH_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  FILEWATCH.H                                          *
+*  Notification of writes to a file                     *
+*                                                       *
+*  Tells the follow mode viewer when the AMC file it    *
+*  plays has grown or been replaced, without blocking   *
+*  the GLUT loop                                        *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+/* What filewatch_changed saw */
+#define FILEWATCH_WRITTEN	(1)		/* The file was written to */
+#define FILEWATCH_REPLACED	(2)		/* Another file took its name, e.g. written elsewhere then renamed over it - reopen it */
+
+/* Type for watching one file - inotify on its directory on Linux, size/time polling elsewhere */
+typedef struct _filewatch {
+
+#ifdef __linux__
+	int			fd;			/* Non-blocking inotify instance */
+#endif
+	char*		filename;
+	char*		name;		/* The file's name within its directory, in filename */
+	long long	size;		/* Size, modification time and inode last seen (polling only) */
+	long long	mtime;
+	long long	ino;
+
+} FILEWATCH;
+
+
+FILEWATCH*	filewatch_open(char* argFilename);	/* Start watching a file, NULL on failure */
+int			filewatch_changed(FILEWATCH* fw);	/* FILEWATCH_WRITTEN or FILEWATCH_REPLACED if either happened since the last call, else 0 - never blocks */
+void		filewatch_close(FILEWATCH* fw);		/* Stop watching and free */
+
+#endif
@@ -0,0 +1,173 @@
+/*******************************************************\
+*                                                       *
+*  FK.C                                                 *
+*  Forward kinematics on the CPU                        *
+*                                                       *
+*  Works out the world frame of every bone and joint    *
+*  of a compiled skeleton without touching OpenGL       *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "fk.h"
+
+
+void	fk_rotation(MAT4*, MAT3*);						/* The 3x3 rotation part of a frame */
+void	fk_multiply(MAT3*, MAT3*, MAT3*);				/* a.b */
+void	fk_transform(MAT3*, POINT3D*, POINT3D*, POINT3D*);	/* r.v+t */
+
+
+FKPOSE* fk_createpose(RIG* rig) {
+
+	FKPOSE* pose;
+	int n=rig->bones_enum ? rig->bones_enum : 1;
+
+	pose=(FKPOSE*)calloc(1,sizeof(FKPOSE));
+	pose->bones_enum=rig->bones_enum;
+	pose->entries=(MAT4*)calloc(n,sizeof(MAT4));
+	pose->bones=(MAT4*)calloc(n,sizeof(MAT4));
+	pose->joints=(POINT3D*)calloc(n,sizeof(POINT3D));
+	pose->locals=(MAT3*)calloc(n,sizeof(MAT3));
+	pose->rotations=(MAT3*)calloc(rig->bonearray_enum ? rig->bonearray_enum : 1,sizeof(MAT3));
+
+	return pose;
+
+}
+
+void fk_freepose(FKPOSE* pose) {
+
+	free(pose->entries);
+	free(pose->bones);
+	free(pose->joints);
+	free(pose->locals);
+	free(pose->rotations);
+	free(pose);
+
+}
+
+void fk_pose(RIG* rig, MOCAP* mocap, int frame, FKPOSE* pose) {
+
+	MAT3	r;
+	int		i;
+
+	/* Root - T(root_pos) then Rz.Ry.Rx(root_orient) */
+	rig_rotation(&r,mocap->root_orient[frame].x,mocap->root_orient[frame].y,mocap->root_orient[frame].z);
+
+	/* Every bone's R at once - the sines and cosines of the frame in one go */
+	euler_matrices(mocap->bones_orient[frame],rig->bonearray_enum,EULER_EXACT,pose->rotations);
+
+	/* parent.T.K'(parent) then K.R = parent.T.(K'(parent).K).R - link is the middle product */
+	for (i=0; i<rig->bones_enum; i++)
+		fk_multiply(pose->locals+i,&(rig->bones[i].link),pose->rotations+rig->bones[i].bone);
+
+	fk_chain(rig,&r,mocap->root_pos+frame,pose);
+
+}
+
+void fk_chain(RIG* rig, MAT3* root, POINT3D* root_pos, FKPOSE* pose) {
+
+	RIGBONE*	rb;
+	POINT3D*	origin;			/* Where the bone starts - the parent's joint */
+	MAT3		parent;			/* Rotation of the parent's frame */
+	MAT3		b;
+	int			i;
+
+	fk_mat3to4(root,root_pos,&(pose->root));
+
+	/* Parents come first, so their frames are always ready */
+	for (i=0; i<rig->bones_enum; i++) {
+		rb=rig->bones+i;
+		if (rb->parent<0) {
+			parent=*root;
+			origin=root_pos;
+		}
+		else {
+			fk_rotation(pose->bones+rb->parent,&parent);
+			origin=pose->joints+rb->parent;
+		}
+
+		fk_multiply(&b,&parent,pose->locals+i);
+		fk_mat3to4(&b,origin,pose->bones+i);
+		fk_transform(&b,&(rb->offset),origin,pose->joints+i);
+
+		if (pose->entries) {
+			if (rb->parent<0)
+				pose->entries[i]=pose->root;
+			else {
+				fk_multiply(&b,&parent,&(rig->bones[rb->parent].axisinv));
+				fk_mat3to4(&b,origin,pose->entries+i);
+			}
+		}
+	}
+
+}
+
+void fk_initialpose(RIG* rig, FKPOSE* pose) {
+
+	RIGBONE*	rb;
+	POINT3D*	origin;
+	MAT3		r;
+	int			i;
+
+	rig_rotation(&r,rig->init_orientation.x,rig->init_orientation.y,rig->init_orientation.z);
+	fk_mat3to4(&r,&(rig->init_position),&(pose->root));
+
+	/* Every bone keeps the root's orientation and is only moved along by its parents' offsets */
+	for (i=0; i<rig->bones_enum; i++) {
+		rb=rig->bones+i;
+		origin=(rb->parent<0) ? &(rig->init_position) : pose->joints+rb->parent;
+		fk_mat3to4(&r,origin,pose->bones+i);
+		fk_transform(&r,&(rb->offset),origin,pose->joints+i);
+		if (pose->entries)
+			pose->entries[i]=pose->bones[i];
+	}
+
+}
+
+void fk_mat3to4(MAT3* r, POINT3D* t, MAT4* out) {
+
+	int i, j;
+
+	for (i=0; i<3; i++) {
+		for (j=0; j<3; j++)
+			MAT4_AT(out,i,j)=r->m[i][j];
+		MAT4_AT(out,3,i)=0;
+	}
+	MAT4_AT(out,0,3)=t ? t->x : 0;
+	MAT4_AT(out,1,3)=t ? t->y : 0;
+	MAT4_AT(out,2,3)=t ? t->z : 0;
+	MAT4_AT(out,3,3)=1;
+
+}
+
+
+void fk_rotation(MAT4* a, MAT3* r) {
+
+	int i, j;
+
+	for (i=0; i<3; i++)
+		for (j=0; j<3; j++)
+			r->m[i][j]=MAT4_AT(a,i,j);
+
+}
+
+void fk_multiply(MAT3* out, MAT3* a, MAT3* b) {
+
+	int i, j;
+
+	for (i=0; i<3; i++)
+		for (j=0; j<3; j++)
+			out->m[i][j]=a->m[i][0]*b->m[0][j]+a->m[i][1]*b->m[1][j]+a->m[i][2]*b->m[2][j];
+
+}
+
+void fk_transform(MAT3* r, POINT3D* v, POINT3D* t, POINT3D* out) {
+
+	out->x=r->m[0][0]*v->x+r->m[0][1]*v->y+r->m[0][2]*v->z+t->x;
+	out->y=r->m[1][0]*v->x+r->m[1][1]*v->y+r->m[1][2]*v->z+t->y;
+	out->z=r->m[2][0]*v->x+r->m[2][1]*v->y+r->m[2][2]*v->z+t->z;
+
+}
@@ -0,0 +1,52 @@
+#ifndef COLLOMOSSE_MOCAP_FK_INCLUDED
+#define COLLOMOSSE_MOCAP_FK_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  FK.H                                                 *
+*  Forward kinematics on the CPU                        *
+*                                                       *
+*  Works out the world frame of every bone and joint    *
+*  of a compiled skeleton without touching OpenGL       *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "rig.h"
+
+/* Element (row, column) of a MAT4 */
+#define MAT4_AT(a,row,col)	((a)->m[(col)*4+(row)])
+
+/* Type for a 4x4 matrix in OpenGL's column major order, ready for glMultMatrixf */
+typedef struct _mat4 {
+
+	float	m[16];
+
+} MAT4;
+
+/* Type for the pose of a rig at one instant - every array is indexed like RIG::bones.
+ * Frames are in the AMC file's coordinates (drawSkeleton stands them up the Z axis).
+ */
+typedef struct _fkpose {
+
+	int			bones_enum;
+	MAT4		root;			/* Root frame - T(root_pos).R(root_orient) */
+	MAT4*		entries;		/* Frame each bone starts from - its parent's frame moved to the joint with K' taken out (the root frame for children of the root) */
+	MAT4*		bones;			/* entries.K.R - the frame the bone is drawn in */
+	POINT3D*	joints;			/* Position of the joint at the end of each bone - bones.T */
+	MAT3*		locals;			/* link.R - each bone's rotation within its parent's frame, as fk_chain composes them */
+	MAT3*		rotations;		/* [SKELETON::bonearray index] R of every bone at the frame, made in one batch */
+
+} FKPOSE;
+
+
+FKPOSE*	fk_createpose(RIG* rig);								/* Room for a pose of this rig */
+void	fk_freepose(FKPOSE* pose);
+void	fk_pose(RIG* rig, MOCAP* mocap, int frame, FKPOSE* pose);	/* Pose at a frame (0 based) - the K.R.T.K' chain of the old recursive renderer */
+void	fk_chain(RIG* rig, MAT3* root, POINT3D* root_pos, FKPOSE* pose);	/* Pose from the root's frame and pose->locals already filled in */
+void	fk_initialpose(RIG* rig, FKPOSE* pose);					/* The skeleton's initial pose - T only, no K or R */
+void	fk_mat3to4(MAT3* r, POINT3D* t, MAT4* out);				/* Rotation and translation as a 4x4 (t may be NULL) */
+
+#endif
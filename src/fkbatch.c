@@ -0,0 +1,267 @@
+/*******************************************************\
+*                                                       *
+*  FKBATCH.C                                            *
+*  Forward kinematics for many frames at once           *
+*                                                       *
+*  Evaluates joint positions of several frames side by  *
+*  side with SIMD (AVX2, SSE2 or plain C)               *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "fkbatch.h"
+#include "simd.h"
+
+void	fkbatch_euler(const float*, const float*, SIMDVEC*);	/* Rz.Ry.Rx from the sines and cosines of SIMD_WIDTH triples of Euler angles (rows of lanes) */
+void	fkbatch_gather(MOCAP*, int, int, int, float*);		/* Euler angles of one bone (or the root, -1) of a run of frames into rows of lanes */
+void	fkbatch_range(RIG*, MOCAP*, FKBATCH*, int, int, POINT3D*);	/* Joints of a run of frames into the clip's joint array */
+void	fkbatch_rangekernel(void*, void*, int, int);		/* FRAMEKERNEL running fkbatch_range on an FKBATCHCLIP */
+void*	fkbatch_newscratch(void*);							/* FRAMESCRATCH making a worker's FKBATCH */
+void	fkbatch_freescratch(void*);
+
+/* What a range of one clip needs to know */
+typedef struct _fkbatchclip {
+
+	RIG*		rig;
+	MOCAP*		mocap;
+	POINT3D*	joints;
+
+} FKBATCHCLIP;
+
+
+FKBATCH* fkbatch_create(RIG* rig) {
+
+	FKBATCH* batch;
+	int n=rig->bones_enum ? rig->bones_enum : 1;
+
+	batch=(FKBATCH*)calloc(1,sizeof(FKBATCH));
+	batch->bones_enum=rig->bones_enum;
+	batch->rootrot=(float*)calloc(9*FKBATCH_LANES,sizeof(float));
+	batch->rootpos=(float*)calloc(3*FKBATCH_LANES,sizeof(float));
+	batch->rot=(float*)calloc((size_t)n*9*FKBATCH_LANES,sizeof(float));
+	batch->joints=(float*)calloc((size_t)n*3*FKBATCH_LANES,sizeof(float));
+	batch->angles=(float*)calloc(3*FKBATCH_LANES,sizeof(float));
+
+	return batch;
+
+}
+
+void fkbatch_free(FKBATCH* batch) {
+
+	free(batch->rootrot);
+	free(batch->rootpos);
+	free(batch->rot);
+	free(batch->joints);
+	free(batch->angles);
+	free(batch);
+
+}
+
+void fkbatch_joints(RIG* rig, MOCAP* mocap, int first, int count, FKBATCH* batch) {
+
+	RIGBONE*	rb;
+	SIMDVEC		r[9], lr[9], b[9];
+	SIMDVEC		link, off, acc;
+	float		s[3*FKBATCH_LANES], c[3*FKBATCH_LANES];
+	float*		prot;			/* Parent's frame rotation and origin, rows of lanes */
+	float*		ppos;
+	float*		brot;
+	float*		bpos;
+	int			i, j, k, lane, v;
+
+	batch->frames_enum=count;
+
+	/* Root - its rotation and position, a lane per frame (lanes past count repeat the last frame) */
+	fkbatch_gather(mocap,first,count,-1,batch->angles);
+	euler_sincosdeg(batch->angles,3*FKBATCH_LANES,1.0f,s,c);
+	for (v=0; v<FKBATCH_LANES; v+=SIMD_WIDTH) {
+		fkbatch_euler(s+v,c+v,r);
+		for (k=0; k<9; k++)
+			V_STORE(batch->rootrot+k*FKBATCH_LANES+v,r[k]);
+	}
+	for (lane=0; lane<FKBATCH_LANES; lane++) {
+		i=first+((lane<count) ? lane : count-1);
+		batch->rootpos[lane]=mocap->root_pos[i].x;
+		batch->rootpos[FKBATCH_LANES+lane]=mocap->root_pos[i].y;
+		batch->rootpos[2*FKBATCH_LANES+lane]=mocap->root_pos[i].z;
+	}
+
+	/* Same chain as fk_pose - parent.(K'(parent).K).R then T - with every lane a different frame */
+	for (i=0; i<rig->bones_enum; i++) {
+		rb=rig->bones+i;
+		prot=(rb->parent<0) ? batch->rootrot : batch->rot+rb->parent*9*FKBATCH_LANES;
+		ppos=(rb->parent<0) ? batch->rootpos : batch->joints+rb->parent*3*FKBATCH_LANES;
+		brot=batch->rot+i*9*FKBATCH_LANES;
+		bpos=batch->joints+i*3*FKBATCH_LANES;
+
+		fkbatch_gather(mocap,first,count,rb->bone,batch->angles);
+		euler_sincosdeg(batch->angles,3*FKBATCH_LANES,1.0f,s,c);
+
+		for (v=0; v<FKBATCH_LANES; v+=SIMD_WIDTH) {
+			fkbatch_euler(s+v,c+v,r);
+
+			/* link.R - link is the same in every lane */
+			for (j=0; j<3; j++) {
+				for (k=0; k<3; k++) {
+					link=V_SET1(rb->link.m[j][0]);
+					acc=V_MUL(link,r[k]);
+					link=V_SET1(rb->link.m[j][1]);
+					acc=V_ADD(acc,V_MUL(link,r[3+k]));
+					link=V_SET1(rb->link.m[j][2]);
+					lr[j*3+k]=V_ADD(acc,V_MUL(link,r[6+k]));
+				}
+			}
+
+			/* parent.link.R */
+			for (j=0; j<3; j++) {
+				for (k=0; k<3; k++) {
+					acc=V_MUL(V_LOAD(prot+(j*3)*FKBATCH_LANES+v),lr[k]);
+					acc=V_ADD(acc,V_MUL(V_LOAD(prot+(j*3+1)*FKBATCH_LANES+v),lr[3+k]));
+					b[j*3+k]=V_ADD(acc,V_MUL(V_LOAD(prot+(j*3+2)*FKBATCH_LANES+v),lr[6+k]));
+					V_STORE(brot+(j*3+k)*FKBATCH_LANES+v,b[j*3+k]);
+				}
+			}
+
+			/* Joint at the end of the bone - b.offset plus the parent's joint */
+			for (j=0; j<3; j++) {
+				acc=V_LOAD(ppos+j*FKBATCH_LANES+v);
+				off=V_SET1(rb->offset.x);
+				acc=V_ADD(acc,V_MUL(b[j*3],off));
+				off=V_SET1(rb->offset.y);
+				acc=V_ADD(acc,V_MUL(b[j*3+1],off));
+				off=V_SET1(rb->offset.z);
+				V_STORE(bpos+j*FKBATCH_LANES+v,V_ADD(acc,V_MUL(b[j*3+2],off)));
+			}
+		}
+	}
+
+}
+
+void fkbatch_clip(RIG* rig, MOCAP* mocap, FKBATCH* batch, POINT3D* joints) {
+
+	fkbatch_range(rig,mocap,batch,0,mocap->frames_enum,joints);
+
+}
+
+int fkbatch_clips(RIG* rig, MOCAP** mocaps, int mocaps_enum, POINT3D** joints, THREADPOOL* pool) {
+
+	FRAMESCHED*		sched;
+	FKBATCHCLIP*	clips;
+	int				i, ok=1;
+
+	if (!(clips=(FKBATCHCLIP*)malloc(sizeof(FKBATCHCLIP)*(mocaps_enum ? mocaps_enum : 1))))
+		return 0;
+	/* Ranges start on a whole batch, so only the last range of a clip has a part filled batch */
+	if (!(sched=framesched_create(pool,FKBATCH_GRAIN,fkbatch_newscratch,fkbatch_freescratch,rig))) {
+		free(clips);
+		return 0;
+	}
+
+	for (i=0; i<mocaps_enum; i++) {
+		clips[i].rig=rig;
+		clips[i].mocap=mocaps[i];
+		clips[i].joints=joints[i];
+		if (!framesched_submit(sched,0,mocaps[i]->frames_enum,fkbatch_rangekernel,clips+i))
+			ok=0;
+	}
+	if (!framesched_wait(sched))
+		ok=0;
+
+	framesched_free(sched);
+	free(clips);
+
+	return ok;
+
+}
+
+void fkbatch_range(RIG* rig, MOCAP* mocap, FKBATCH* batch, int first, int count, POINT3D* joints) {
+
+	POINT3D*	out;
+	int			f, n, i, lane;
+
+	for (f=first; f<first+count; f+=FKBATCH_LANES) {
+		n=first+count-f;
+		if (n>FKBATCH_LANES)
+			n=FKBATCH_LANES;
+		fkbatch_joints(rig,mocap,f,n,batch);
+
+		/* Back to a POINT3D per joint per frame */
+		for (lane=0; lane<n; lane++) {
+			out=joints+(size_t)(f+lane)*rig->bones_enum;
+			for (i=0; i<rig->bones_enum; i++) {
+				out[i].x=FKBATCH_JOINT(batch,i,0,lane);
+				out[i].y=FKBATCH_JOINT(batch,i,1,lane);
+				out[i].z=FKBATCH_JOINT(batch,i,2,lane);
+			}
+		}
+	}
+
+}
+
+void fkbatch_rangekernel(void* ctx, void* scratch, int first, int count) {
+
+	FKBATCHCLIP* clip=(FKBATCHCLIP*)ctx;
+
+	fkbatch_range(clip->rig,clip->mocap,(FKBATCH*)scratch,first,count,clip->joints);
+
+}
+
+void* fkbatch_newscratch(void* rig) {
+
+	return fkbatch_create((RIG*)rig);
+
+}
+
+void fkbatch_freescratch(void* batch) {
+
+	fkbatch_free((FKBATCH*)batch);
+
+}
+
+const char* fkbatch_isa(void) {
+
+	return SIMD_ISA;
+
+}
+
+
+void fkbatch_gather(MOCAP* mocap, int first, int count, int bone, float* angles) {
+
+	POINT3D*	a;
+	int			lane;
+
+	for (lane=0; lane<FKBATCH_LANES; lane++) {
+		a=(bone<0) ? mocap->root_orient+first+((lane<count) ? lane : count-1) :
+					 mocap->bones_orient[first+((lane<count) ? lane : count-1)]+bone;
+		angles[lane]=a->x;
+		angles[FKBATCH_LANES+lane]=a->y;
+		angles[2*FKBATCH_LANES+lane]=a->z;
+	}
+
+}
+
+void fkbatch_euler(const float* s, const float* c, SIMDVEC* m) {
+
+	SIMDVEC sx, cx, sy, cy, sz, cz, t;
+
+	sx=V_LOAD(s);	cx=V_LOAD(c);
+	sy=V_LOAD(s+FKBATCH_LANES);	cy=V_LOAD(c+FKBATCH_LANES);
+	sz=V_LOAD(s+2*FKBATCH_LANES);	cz=V_LOAD(c+2*FKBATCH_LANES);
+
+	/* Rz.Ry.Rx multiplied out, as rig_rotation */
+	m[0]=V_MUL(cz,cy);
+	t=V_MUL(cz,sy);
+	m[1]=V_SUB(V_MUL(t,sx),V_MUL(sz,cx));
+	m[2]=V_ADD(V_MUL(t,cx),V_MUL(sz,sx));
+	m[3]=V_MUL(sz,cy);
+	t=V_MUL(sz,sy);
+	m[4]=V_ADD(V_MUL(t,sx),V_MUL(cz,cx));
+	m[5]=V_SUB(V_MUL(t,cx),V_MUL(cz,sx));
+	m[6]=V_SUB(V_SET1(0),sy);
+	m[7]=V_MUL(cy,sx);
+	m[8]=V_MUL(cy,cx);
+
+}
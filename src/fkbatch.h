@@ -0,0 +1,50 @@
+#ifndef COLLOMOSSE_MOCAP_FKBATCH_INCLUDED
+#define COLLOMOSSE_MOCAP_FKBATCH_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  FKBATCH.H                                            *
+*  Forward kinematics for many frames at once           *
+*                                                       *
+*  Evaluates joint positions of several frames side by  *
+*  side with SIMD (AVX2, SSE2 or plain C)               *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "fk.h"
+#include "framesched.h"
+
+/* Frames evaluated together - one per lane of an AVX2 vector, or two SSE2 vectors */
+#define FKBATCH_LANES	(8)
+
+/* Frames per range when a clip is shared between threads - a whole number of batches */
+#define FKBATCH_GRAIN	(8*FKBATCH_LANES)
+
+/* Joint position component (0 x, 1 y, 2 z) of a rig bone in one lane of a batch */
+#define FKBATCH_JOINT(batch,bone,axis,lane)	((batch)->joints[((bone)*3+(axis))*FKBATCH_LANES+(lane)])
+
+/* Type for FKBATCH_LANES poses of a rig stored structure of arrays - every value has a row of lanes */
+typedef struct _fkbatch {
+
+	int		bones_enum;
+	int		frames_enum;	/* Lanes filled by the last fkbatch_joints */
+	float*	rootrot;		/* [9 (row major)][lane] Root frame rotation */
+	float*	rootpos;		/* [3][lane] */
+	float*	rot;			/* [rig bone][9][lane] Rotation of each bone's frame (FKPOSE::bones) */
+	float*	joints;			/* [rig bone][3][lane] Joint positions (FKPOSE::joints) - see FKBATCH_JOINT */
+	float*	angles;			/* [3][lane] Euler angles being converted */
+
+} FKBATCH;
+
+
+FKBATCH*	fkbatch_create(RIG* rig);
+void		fkbatch_free(FKBATCH* batch);
+void		fkbatch_joints(RIG* rig, MOCAP* mocap, int first, int count, FKBATCH* batch);	/* Joints of frames first to first+count-1 (count<=FKBATCH_LANES), lane l holding frame first+l */
+void		fkbatch_clip(RIG* rig, MOCAP* mocap, FKBATCH* batch, POINT3D* joints);			/* Joints of every frame - joints[frame*rig->bones_enum+rig bone] */
+int			fkbatch_clips(RIG* rig, MOCAP** mocaps, int mocaps_enum, POINT3D** joints, THREADPOOL* pool);	/* fkbatch_clip of clips of one skeleton on every worker of the pool (0 if out of memory) */
+const char*	fkbatch_isa(void);																/* Instruction set the kernel was built for */
+
+#endif
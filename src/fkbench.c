@@ -0,0 +1,218 @@
+/*******************************************************\
+*                                                       *
+*  FKBENCH.C                                            *
+*  Benchmark for forward kinematics                     *
+*                                                       *
+*  Times fk_pose a frame at a time against the batched  *
+*  SIMD kernel of fkbatch.c on a whole clip and checks  *
+*  that both give the same joint positions, then times  *
+*  the kernel spread over a pool of threads and posing  *
+*  from quaternion tracks between frames                *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parser.h"
+#include "rig.h"
+#include "fk.h"
+#include "fkbatch.h"
+#include "track.h"
+#include "threadpool.h"
+#include "timer.h"
+
+#define EXITCODE_SUCCESS	(0)
+#define EXITCODE_BADSYNTAX	(1)
+#define EXITCODE_BADSKEL	(2)
+#define EXITCODE_BADMOCAP	(3)
+
+#define BENCH_MINSECONDS	(0.5)	/* Each kernel is run over the clip until at least this long has passed */
+#define BENCH_CLIPS			(4)		/* Copies of the clip per thread in the batch of clips test */
+
+
+/* Internal prototypes */
+
+double	bench_clips(RIG*, MOCAP**, int, POINT3D**, int);	/* Frames per second of fkbatch_clips on a pool of some threads */
+
+
+int main (int argc, char** argv) {
+
+	SKELETON*	skel;
+	MOCAP*		mocap;
+	RIG*		rig;
+	FKPOSE*		pose;
+	FKBATCH*	batch;
+	POSETRACK*	track;
+	TRACKPOSE*	sample;
+	FKPOSE*		tpose;
+	POINT3D*	joints;
+	POINT3D*	j;
+	POINT3D**	batchjoints;
+	MOCAP**		clips;
+	char		isa[16];
+	double		start, elapsed, posefps, batchfps, onefps, err, e;
+	int			f, i, runs, threads, clips_enum, mode;
+
+	if (argc!=3 && argc!=4) {
+		printf("Use FKBENCH <asf file> <amc file> [threads]\n");
+		return (EXITCODE_BADSYNTAX);
+	}
+
+	if (!(skel=parser_loadSkeleton(argv[1]))) {
+		printf("FATAL:  Failed to load skeleton from file\n");
+		return (EXITCODE_BADSKEL);
+	}
+	if (!(mocap=parser_loadMocap(argv[2],skel)) || !mocap->frames_enum) {
+		printf("FATAL:  Failed to load motion capture data from file\n");
+		parser_free_skeleton(skel);
+		return (EXITCODE_BADMOCAP);
+	}
+
+	rig=rig_compile(skel);
+	pose=fk_createpose(rig);
+	batch=fkbatch_create(rig);
+	joints=(POINT3D*)malloc(sizeof(POINT3D)*(size_t)mocap->frames_enum*(rig->bones_enum ? rig->bones_enum : 1));
+
+	printf("%d frames, %d bones\n",mocap->frames_enum,rig->bones_enum);
+
+	/* One frame at a time */
+	runs=0;
+	start=timer_seconds();
+	do {
+		for (f=0; f<mocap->frames_enum; f++)
+			fk_pose(rig,mocap,f,pose);
+		runs++;
+		elapsed=timer_seconds()-start;
+	} while (elapsed<BENCH_MINSECONDS);
+	posefps=runs*(double)mocap->frames_enum/elapsed;
+	printf("fk_pose              %10.0f frames/s\n",posefps);
+
+	/* FKBATCH_LANES frames at a time */
+	runs=0;
+	start=timer_seconds();
+	do {
+		fkbatch_clip(rig,mocap,batch,joints);
+		runs++;
+		elapsed=timer_seconds()-start;
+	} while (elapsed<BENCH_MINSECONDS);
+	batchfps=runs*(double)mocap->frames_enum/elapsed;
+	sprintf(isa,"(%.12s)",fkbatch_isa());
+	printf("fkbatch_clip %-8s %10.0f frames/s  (x%.1f)\n",isa,batchfps,batchfps/posefps);
+
+	/* Largest difference in any joint coordinate */
+	err=0;
+	for (f=0; f<mocap->frames_enum; f++) {
+		fk_pose(rig,mocap,f,pose);
+		j=joints+(size_t)f*rig->bones_enum;
+		for (i=0; i<rig->bones_enum; i++) {
+			e=fabs(j[i].x-pose->joints[i].x)+fabs(j[i].y-pose->joints[i].y)+fabs(j[i].z-pose->joints[i].z);
+			if (e>err)
+				err=e;
+		}
+	}
+	printf("Largest joint difference %g\n",err);
+
+	/* Half way between every pair of frames from the quaternion track */
+	track=track_create(rig,mocap);
+	sample=track_createpose(track);
+	tpose=fk_createpose(rig);
+	for (mode=TRACK_NLERP; mode<=TRACK_SLERP; mode++) {
+		runs=0;
+		start=timer_seconds();
+		do {
+			for (f=0; f<mocap->frames_enum; f++) {
+				track_sample(track,f+0.5,mode,sample);
+				track_pose(rig,sample,tpose);
+			}
+			runs++;
+			elapsed=timer_seconds()-start;
+		} while (elapsed<BENCH_MINSECONDS);
+		printf("track_sample (%s) + track_pose %10.0f poses/s\n",(mode==TRACK_SLERP) ? "SLERP" : "NLERP",runs*(double)mocap->frames_enum/elapsed);
+	}
+
+	/* On whole frames the track must pose the rig as fk_pose does */
+	err=0;
+	for (f=0; f<mocap->frames_enum; f++) {
+		fk_pose(rig,mocap,f,pose);
+		track_sample(track,f,TRACK_SLERP,sample);
+		track_pose(rig,sample,tpose);
+		for (i=0; i<rig->bones_enum; i++) {
+			e=fabs(tpose->joints[i].x-pose->joints[i].x)+fabs(tpose->joints[i].y-pose->joints[i].y)+fabs(tpose->joints[i].z-pose->joints[i].z);
+			if (e>err)
+				err=e;
+		}
+	}
+	printf("Largest joint difference from fk_pose on whole frames %g\n",err);
+	fk_freepose(tpose);
+	track_freepose(sample);
+	track_free(track);
+
+	/* The same kernel on every core, first over the one clip then over a batch of copies of it */
+	threads=(argc==4 ? atoi(argv[3]) : 0);
+	if (threads<=0)
+		threads=threadpool_cpucount();
+	clips_enum=BENCH_CLIPS*threads;
+	clips=(MOCAP**)malloc(sizeof(MOCAP*)*clips_enum);
+	batchjoints=(POINT3D**)malloc(sizeof(POINT3D*)*clips_enum);
+	for (i=0; i<clips_enum; i++) {
+		clips[i]=mocap;
+		batchjoints[i]=(POINT3D*)malloc(sizeof(POINT3D)*(size_t)mocap->frames_enum*(rig->bones_enum ? rig->bones_enum : 1));
+	}
+
+	onefps=bench_clips(rig,clips,1,batchjoints,1);
+	batchfps=bench_clips(rig,clips,1,batchjoints,threads);
+	printf("fkbatch_clips 1 clip,   %3d threads %10.0f frames/s  (x%.1f of 1 thread)\n",threads,batchfps,batchfps/onefps);
+	onefps=bench_clips(rig,clips,clips_enum,batchjoints,1);
+	batchfps=bench_clips(rig,clips,clips_enum,batchjoints,threads);
+	printf("fkbatch_clips %d clips, %3d threads %10.0f frames/s  (x%.1f of 1 thread)\n",clips_enum,threads,batchfps,batchfps/onefps);
+
+	/* Threads must not change a single bit */
+	f=0;
+	for (i=0; i<clips_enum; i++)
+		if (memcmp(batchjoints[i],joints,sizeof(POINT3D)*(size_t)mocap->frames_enum*rig->bones_enum))
+			f++;
+	printf("%d of %d clips differ from fkbatch_clip\n",f,clips_enum);
+
+	for (i=0; i<clips_enum; i++)
+		free(batchjoints[i]);
+	free(batchjoints);
+	free(clips);
+
+	free(joints);
+	fkbatch_free(batch);
+	fk_freepose(pose);
+	rig_free(rig);
+	parser_free_mocap(mocap);
+	parser_free_skeleton(skel);
+
+	return (EXITCODE_SUCCESS);
+
+}
+
+double bench_clips(RIG* rig, MOCAP** clips, int clips_enum, POINT3D** joints, int threads) {
+
+	THREADPOOL*	pool;
+	double		start, elapsed;
+	int			i, runs=0, frames=0;
+
+	pool=threadpool_create(threads);
+	for (i=0; i<clips_enum; i++)
+		frames+=clips[i]->frames_enum;
+
+	start=timer_seconds();
+	do {
+		fkbatch_clips(rig,clips,clips_enum,joints,pool);
+		runs++;
+		elapsed=timer_seconds()-start;
+	} while (elapsed<BENCH_MINSECONDS);
+
+	threadpool_destroy(pool);
+
+	return runs*(double)frames/elapsed;
+
+}
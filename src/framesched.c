@@ -0,0 +1,176 @@
+/*******************************************************\
+*                                                       *
+*  FRAMESCHED.C                                         *
+*  Splits frame ranges of clips across the thread pool  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include "framesched.h"
+
+
+/* Internal prototypes */
+
+void	framesched_job(void* arg);			/* Splits a range down to the grain then runs it */
+void*	framesched_scratch(FRAMESCHED* s, void** own);	/* The calling worker's scratch, made on first use - own is set when the caller must free it */
+void	framesched_done(FRAMESCHED* s, int ran);		/* Count a range off, waking framesched_wait on the last */
+
+
+FRAMESCHED* framesched_create(THREADPOOL* pool, int grain, FRAMESCRATCH create, FRAMESCRATCHFREE destroy, void* scratchctx) {
+
+	FRAMESCHED*	s;
+
+	if (!pool)
+		return NULL;
+	if (!(s=(FRAMESCHED*)malloc(sizeof(FRAMESCHED))))
+		return NULL;
+	if (!(s->scratch=(void**)calloc(pool->threads_enum,sizeof(void*)))) {
+		free(s);
+		return NULL;
+	}
+
+	s->pool=pool;
+	s->grain=(grain>0 ? grain : FRAMESCHED_GRAIN);
+	s->create=create;
+	s->destroy=destroy;
+	s->scratchctx=scratchctx;
+
+	mutex_init(&(s->lock));
+	condvar_init(&(s->done));
+	s->pending=0;
+	s->failed=0;
+
+	return s;
+
+}
+
+void framesched_free(FRAMESCHED* s) {
+
+	int i;
+
+	if (!s)
+		return;
+	if (s->destroy)
+		for (i=0; i<s->pool->threads_enum; i++)
+			if (s->scratch[i])
+				s->destroy(s->scratch[i]);
+	condvar_destroy(&(s->done));
+	mutex_destroy(&(s->lock));
+	free(s->scratch);
+	free(s);
+
+}
+
+int framesched_submit(FRAMESCHED* s, int first, int count, FRAMEKERNEL kernel, void* ctx) {
+
+	FRAMERANGE*	r;
+
+	if (count<=0)
+		return 1;
+	if (!(r=(FRAMERANGE*)malloc(sizeof(FRAMERANGE))))
+		return 0;
+
+	r->sched=s;
+	r->kernel=kernel;
+	r->ctx=ctx;
+	r->first=first;
+	r->count=count;
+
+	mutex_lock(&(s->lock));
+	s->pending++;
+	mutex_unlock(&(s->lock));
+	threadpool_submit(s->pool,framesched_job,r);
+
+	return 1;
+
+}
+
+int framesched_wait(FRAMESCHED* s) {
+
+	int failed;
+
+	/* Only this scheduler's ranges - other work on the pool carries on regardless */
+	mutex_lock(&(s->lock));
+	while (s->pending>0)
+		condvar_wait(&(s->done),&(s->lock));
+	failed=s->failed;
+	s->failed=0;
+	mutex_unlock(&(s->lock));
+
+	return !failed;
+
+}
+
+void framesched_job(void* arg) {
+
+	FRAMERANGE*	r=(FRAMERANGE*)arg;
+	FRAMERANGE*	back;
+	FRAMESCHED*	s=r->sched;
+	void*		scratch;
+	void*		own=NULL;
+	int			half;
+
+	/*
+	 * Keep the front half and queue the back half on this worker's deque.  The biggest
+	 * halves are the oldest jobs, so they are the ones idle workers steal, and the owner
+	 * works down through ever smaller ranges of frames next to the ones it just did
+	 */
+	while (r->count>=2*s->grain) {
+		half=(r->count/s->grain/2)*s->grain;
+		if (!(back=(FRAMERANGE*)malloc(sizeof(FRAMERANGE))))
+			break;
+		*back=*r;
+		back->first+=half;
+		back->count-=half;
+		r->count=half;
+
+		mutex_lock(&(s->lock));
+		s->pending++;
+		mutex_unlock(&(s->lock));
+		threadpool_submit(s->pool,framesched_job,back);
+	}
+
+	/* A kernel that needs scratch is never handed NULL - the range is skipped and reported instead */
+	scratch=framesched_scratch(s,&own);
+	if (scratch || !s->create)
+		r->kernel(r->ctx,scratch,r->first,r->count);
+	if (own && s->destroy)
+		s->destroy(own);
+
+	framesched_done(s,scratch || !s->create);
+	free(r);
+
+}
+
+void* framesched_scratch(FRAMESCHED* s, void** own) {
+
+	int w;
+
+	if (!s->create)
+		return NULL;
+
+	/* Not one of the pool's workers - scratch just for this range */
+	if ((w=threadpool_self(s->pool))==-1)
+		return *own=s->create(s->scratchctx);
+
+	if (!s->scratch[w])
+		s->scratch[w]=s->create(s->scratchctx);
+
+	return s->scratch[w];
+
+}
+
+void framesched_done(FRAMESCHED* s, int ran) {
+
+	mutex_lock(&(s->lock));
+	if (!ran)
+		s->failed++;
+	if (!--s->pending)
+		condvar_broadcast(&(s->done));
+	mutex_unlock(&(s->lock));
+
+}
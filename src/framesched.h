@@ -0,0 +1,67 @@
+#ifndef COLLOMOSSE_MOCAP_FRAMESCHED_INCLUDED
+#define COLLOMOSSE_MOCAP_FRAMESCHED_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  FRAMESCHED.H                                         *
+*  Splits frame ranges of clips across the thread pool  *
+*                                                       *
+*  A range is halved until it is no longer than the     *
+*  grain, the halves landing on the worker's own deque  *
+*  for idle workers to steal.  Each worker is handed    *
+*  its own scratch, made the first time it needs it     *
+*  and never NULL when there is a way to make it        *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "threadpool.h"
+
+/* Frames per range when none is given - long enough to hide the cost of a job */
+#define FRAMESCHED_GRAIN	(64)
+
+/* Per-frame kernel - runs frames first to first+count-1 of whatever ctx describes, with the worker's scratch */
+typedef void (*FRAMEKERNEL)(void* ctx, void* scratch, int first, int count);
+
+/* Makes and frees one worker's scratch */
+typedef void* (*FRAMESCRATCH)(void* scratchctx);
+typedef void (*FRAMESCRATCHFREE)(void* scratch);
+
+/* Type for a scheduler - one per pool and kind of scratch */
+typedef struct _framesched {
+
+	THREADPOOL*			pool;
+	int					grain;			/* Ranges are split at multiples of this many frames, and no shorter */
+
+	FRAMESCRATCH		create;			/* May be NULL, in which case kernels are given NULL scratch */
+	FRAMESCRATCHFREE	destroy;
+	void*				scratchctx;
+	void**				scratch;		/* [worker] - only ever touched by that worker until framesched_free */
+
+	MUTEX				lock;			/* Guards pending and failed */
+	CONDVAR				done;			/* Broadcast when pending drops to zero */
+	int					pending;		/* Ranges of this scheduler queued or running, not other users of the pool */
+	int					failed;			/* Ranges skipped since the last framesched_wait, for want of scratch */
+
+} FRAMESCHED;
+
+/* A range of frames waiting to be run or split */
+typedef struct _framerange {
+
+	FRAMESCHED*			sched;
+	FRAMEKERNEL			kernel;
+	void*				ctx;
+	int					first;
+	int					count;
+
+} FRAMERANGE;
+
+
+FRAMESCHED*	framesched_create(THREADPOOL* pool, int grain, FRAMESCRATCH create, FRAMESCRATCHFREE destroy, void* scratchctx);	/* grain<=0 means FRAMESCHED_GRAIN */
+void		framesched_free(FRAMESCHED* sched);																					/* Frees every worker's scratch - not while ranges are running */
+int			framesched_submit(FRAMESCHED* sched, int first, int count, FRAMEKERNEL kernel, void* ctx);							/* Queue frames first to first+count-1 (0 if out of memory) */
+int			framesched_wait(FRAMESCHED* sched);																					/* Block until every range of this scheduler has run - 0 if any was skipped for want of scratch */
+
+#endif
@@ -0,0 +1,391 @@
+/*******************************************************\
+*                                                       *
+*  GLRES.C                                              *
+*  OpenGL resources made once and held until shutdown   *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "glres.h"
+#include "GL/glu.h"
+
+#ifdef WIN32
+	typedef PROC				GLRESPROC;
+	#define glres_getproc(name)	wglGetProcAddress(name)
+#else
+	#include "GL/glx.h"
+	typedef void (*GLRESPROC)(void);
+	#define glres_getproc(name)	glXGetProcAddressARB((const GLubyte*)(name))
+#endif
+
+#ifndef GL_VERTEX_SHADER
+	#define GL_FRAGMENT_SHADER			0x8B30
+	#define GL_VERTEX_SHADER			0x8B31
+	#define GL_COMPILE_STATUS			0x8B81
+	#define GL_LINK_STATUS				0x8B82
+#endif
+
+/* Entry points looked up by glres_init - OpenGL 1.5 buffers and 2.0 shaders */
+typedef struct _glresgl {
+
+	void	(APIENTRY *GenBuffers)(GLsizei, GLuint*);
+	void	(APIENTRY *DeleteBuffers)(GLsizei, const GLuint*);
+	void	(APIENTRY *BindBuffer)(GLenum, GLuint);
+	void	(APIENTRY *BufferData)(GLenum, ptrdiff_t, const void*, GLenum);
+	GLuint	(APIENTRY *CreateShader)(GLenum);
+	void	(APIENTRY *ShaderSource)(GLuint, GLsizei, const char**, const GLint*);
+	void	(APIENTRY *CompileShader)(GLuint);
+	void	(APIENTRY *GetShaderiv)(GLuint, GLenum, GLint*);
+	void	(APIENTRY *DeleteShader)(GLuint);
+	GLuint	(APIENTRY *CreateProgram)(void);
+	void	(APIENTRY *AttachShader)(GLuint, GLuint);
+	void	(APIENTRY *BindAttribLocation)(GLuint, GLuint, const char*);
+	void	(APIENTRY *LinkProgram)(GLuint);
+	void	(APIENTRY *GetProgramiv)(GLuint, GLenum, GLint*);
+	void	(APIENTRY *DeleteProgram)(GLuint);
+	void	(APIENTRY *UseProgram)(GLuint);
+
+} GLRESGL;
+
+/* Global variables */
+GLRESGL		glresGL;				/* Entry points, valid when glresShaders */
+int			glresShaders = 0;		/* Non-zero once glres_init has found buffers and shaders */
+GLRESOURCE*	glresItems = NULL;		/* Resource of each slot, the low GLRES_SLOTBITS of a handle less 1 */
+int			glresItems_enum = 0;
+int			glresItems_alloc = 0;
+int			glresLive = 0;
+GLRESCOUNT	glresFrame;				/* Counts since the last glres_endframe */
+
+
+/* Internal prototypes */
+
+GLRES	glres_add(int, GLuint, long);				/* Hold a resource just made - a handle to it */
+GLRESOURCE*	glres_item(GLRES);						/* The resource a handle is for, NULL if freed or stale */
+void	glres_release(GLRESOURCE*);					/* Delete a held resource and free its slot */
+void	glres_delete(int, GLuint);					/* Hand a resource back to OpenGL */
+GLuint	glres_shader(GLenum, const char*);			/* Compiled shader, 0 on failure */
+
+
+int glres_init(void) {
+
+	const char*	version=(const char*)glGetString(GL_VERSION);
+	int			ok=1;
+
+	memset(&glresFrame,0,sizeof(GLRESCOUNT));
+	glresShaders=0;
+	if (!version || atoi(version)<2)
+		return 0;
+
+	ok&=glres_proc(&(glresGL.GenBuffers),"glGenBuffers");
+	ok&=glres_proc(&(glresGL.DeleteBuffers),"glDeleteBuffers");
+	ok&=glres_proc(&(glresGL.BindBuffer),"glBindBuffer");
+	ok&=glres_proc(&(glresGL.BufferData),"glBufferData");
+	ok&=glres_proc(&(glresGL.CreateShader),"glCreateShader");
+	ok&=glres_proc(&(glresGL.ShaderSource),"glShaderSource");
+	ok&=glres_proc(&(glresGL.CompileShader),"glCompileShader");
+	ok&=glres_proc(&(glresGL.GetShaderiv),"glGetShaderiv");
+	ok&=glres_proc(&(glresGL.DeleteShader),"glDeleteShader");
+	ok&=glres_proc(&(glresGL.CreateProgram),"glCreateProgram");
+	ok&=glres_proc(&(glresGL.AttachShader),"glAttachShader");
+	ok&=glres_proc(&(glresGL.BindAttribLocation),"glBindAttribLocation");
+	ok&=glres_proc(&(glresGL.LinkProgram),"glLinkProgram");
+	ok&=glres_proc(&(glresGL.GetProgramiv),"glGetProgramiv");
+	ok&=glres_proc(&(glresGL.DeleteProgram),"glDeleteProgram");
+	ok&=glres_proc(&(glresGL.UseProgram),"glUseProgram");
+
+	return glresShaders=ok;
+
+}
+
+int glres_shutdown(void) {
+
+	int i, held=glresLive;
+
+	for (i=0; i<glresItems_enum; i++)
+		if (glresItems[i].type!=-1)
+			glres_release(glresItems+i);
+
+	free(glresItems);
+	glresItems=NULL;
+	glresItems_enum=glresItems_alloc=0;
+	glresShaders=0;
+
+	return held;
+
+}
+
+int glres_proc(void* fn, const char* name) {
+
+	GLRESPROC proc=glres_getproc(name);
+
+	memcpy(fn,&proc,sizeof(GLRESPROC));
+
+	return proc!=NULL;
+
+}
+
+int glres_swapinterval(int interval) {
+
+#ifdef WIN32
+	BOOL	(APIENTRY *SwapIntervalEXT)(int);
+
+	if (glres_proc(&SwapIntervalEXT,"wglSwapIntervalEXT"))
+		return SwapIntervalEXT(interval)!=FALSE;
+#else
+	void	(*SwapIntervalEXT)(Display*, GLXDrawable, int);
+	int		(*SwapIntervalMESA)(unsigned int);
+	int		(*SwapIntervalSGI)(int);
+	Display*	dpy=glXGetCurrentDisplay();
+	const char*	exts;
+
+	/* GLX hands out entry points for extensions the server hasn't got, so ask which it has first */
+	if (!dpy || !(exts=glXQueryExtensionsString(dpy,DefaultScreen(dpy))))
+		return 0;
+	if (strstr(exts,"GLX_EXT_swap_control") && glres_proc(&SwapIntervalEXT,"glXSwapIntervalEXT")) {
+		SwapIntervalEXT(dpy,glXGetCurrentDrawable(),interval);
+		return 1;
+	}
+	if (strstr(exts,"GLX_MESA_swap_control") && glres_proc(&SwapIntervalMESA,"glXSwapIntervalMESA"))
+		return SwapIntervalMESA(interval)==0;
+	if (interval>0 && strstr(exts,"GLX_SGI_swap_control") && glres_proc(&SwapIntervalSGI,"glXSwapIntervalSGI"))
+		return SwapIntervalSGI(interval)==0;
+#endif
+
+	return 0;
+
+}
+
+GLRES glres_texture(int w, int h, const unsigned char* rgb) {
+
+	GLuint texture;
+
+	/* Give texture a name and select it */
+	glGenTextures(1,&texture);
+	glBindTexture(GL_TEXTURE_2D,texture);
+
+	/* Set up environment and texture wrapping */
+	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	/* Use mip mapping */
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+	gluBuild2DMipmaps(GL_TEXTURE_2D,3,w,h,GL_RGB,GL_UNSIGNED_BYTE,rgb);
+
+	glresFrame.uploads++;
+	glresFrame.upload_bytes+=(long)w*h*3;
+
+	return glres_add(GLRES_TEXTURE,texture,(long)w*h*3);
+
+}
+
+GLRES glres_buffer(GLenum target, const void* data, long bytes) {
+
+	GLuint buffer;
+
+	if (!glresShaders)
+		return 0;
+
+	glresGL.GenBuffers(1,&buffer);
+	if (data) {
+		glresGL.BindBuffer(target,buffer);
+		glresGL.BufferData(target,bytes,data,GL_STATIC_DRAW);
+		glresGL.BindBuffer(target,0);
+		glresFrame.uploads++;
+		glresFrame.upload_bytes+=bytes;
+	}
+
+	return glres_add(GLRES_BUFFER,buffer,data ? bytes : 0);
+
+}
+
+GLRES glres_list(long bytes) {
+
+	glresFrame.uploads++;
+	glresFrame.upload_bytes+=bytes;
+
+	return glres_add(GLRES_LIST,glGenLists(1),bytes);
+
+}
+
+GLRES glres_program(const char* vertex, const char* fragment, const char** attribs, int attribs_enum) {
+
+	GLuint	vs, fs, program;
+	GLint	ok=0;
+	int		i;
+
+	if (!glresShaders)
+		return 0;
+
+	vs=glres_shader(GL_VERTEX_SHADER,vertex);
+	fs=glres_shader(GL_FRAGMENT_SHADER,fragment);
+	if (!vs || !fs) {
+		if (vs)
+			glresGL.DeleteShader(vs);
+		if (fs)
+			glresGL.DeleteShader(fs);
+		return 0;
+	}
+
+	program=glresGL.CreateProgram();
+	glresGL.AttachShader(program,vs);
+	glresGL.AttachShader(program,fs);
+	for (i=0; i<attribs_enum; i++)
+		if (attribs[i])
+			glresGL.BindAttribLocation(program,i,attribs[i]);
+	glresGL.LinkProgram(program);
+
+	/* The program keeps the shaders for as long as it needs them */
+	glresGL.DeleteShader(vs);
+	glresGL.DeleteShader(fs);
+
+	glresGL.GetProgramiv(program,GL_LINK_STATUS,&ok);
+	if (!ok) {
+		glresGL.DeleteProgram(program);
+		return 0;
+	}
+
+	return glres_add(GLRES_PROGRAM,program,0);
+
+}
+
+void glres_stream(GLRES buffer, GLenum target, const void* data, long bytes) {
+
+	glresGL.BindBuffer(target,glres_name(buffer));
+	glresGL.BufferData(target,bytes,data,GL_STREAM_DRAW);
+	glresFrame.stream_bytes+=bytes;
+
+}
+
+void glres_bind(GLRES buffer, GLenum target) {
+
+	glresGL.BindBuffer(target,glres_name(buffer));
+
+}
+
+void glres_use(GLRES program) {
+
+	glresGL.UseProgram(glres_name(program));
+
+}
+
+void glres_free(GLRES res) {
+
+	GLRESOURCE* item;
+
+	if ((item=glres_item(res)))
+		glres_release(item);
+
+}
+
+GLuint glres_name(GLRES res) {
+
+	GLRESOURCE* item=glres_item(res);
+
+	return item ? item->name : 0;
+
+}
+
+int glres_live(void) {
+
+	return glresLive;
+
+}
+
+void glres_endframe(GLRESCOUNT* frame) {
+
+	if (frame)
+		*frame=glresFrame;
+	memset(&glresFrame,0,sizeof(GLRESCOUNT));
+
+}
+
+
+GLRES glres_add(int type, GLuint name, long bytes) {
+
+	int i;
+
+	/* Reuse a released slot before growing */
+	for (i=0; i<glresItems_enum && glresItems[i].type!=-1; i++);
+	if (i==glresItems_enum) {
+		if (glresItems_enum==GLRES_SLOTS) {
+			glres_delete(type,name);
+			return 0;
+		}
+		if (glresItems_enum==glresItems_alloc) {
+			glresItems_alloc=glresItems_alloc ? glresItems_alloc*2 : GLRES_INITIAL;
+			glresItems=(GLRESOURCE*)realloc(glresItems,sizeof(GLRESOURCE)*glresItems_alloc);
+		}
+		glresItems[i].generation=0;
+		glresItems_enum++;
+	}
+
+	glresItems[i].type=type;
+	glresItems[i].name=name;
+	glresItems[i].bytes=bytes;
+	glresLive++;
+	glresFrame.allocations++;
+
+	return (glresItems[i].generation<<GLRES_SLOTBITS)|(i+1);
+
+}
+
+GLRESOURCE* glres_item(GLRES res) {
+
+	int slot=res&GLRES_SLOTS;
+
+	if (res<=0 || slot==0 || slot>glresItems_enum)
+		return NULL;
+	if (glresItems[slot-1].type==-1 || glresItems[slot-1].generation!=(res>>GLRES_SLOTBITS))
+		return NULL;
+
+	return glresItems+slot-1;
+
+}
+
+void glres_release(GLRESOURCE* item) {
+
+	glres_delete(item->type,item->name);
+
+	/* Handles are kept positive, so the generation wraps within the bits left above the slot */
+	item->type=-1;
+	item->generation=(item->generation+1)&((1<<(31-GLRES_SLOTBITS))-1);
+	glresLive--;
+	glresFrame.frees++;
+
+}
+
+void glres_delete(int type, GLuint name) {
+
+	switch (type) {
+		case GLRES_TEXTURE:	glDeleteTextures(1,&name);			break;
+		case GLRES_BUFFER:	glresGL.DeleteBuffers(1,&name);		break;
+		case GLRES_LIST:	glDeleteLists(name,1);				break;
+		case GLRES_PROGRAM:	glresGL.DeleteProgram(name);		break;
+	}
+
+}
+
+GLuint glres_shader(GLenum type, const char* source) {
+
+	GLuint	shader=glresGL.CreateShader(type);
+	GLint	ok=0;
+
+	glresGL.ShaderSource(shader,1,&source,NULL);
+	glresGL.CompileShader(shader);
+	glresGL.GetShaderiv(shader,GL_COMPILE_STATUS,&ok);
+	if (!ok) {
+		glresGL.DeleteShader(shader);
+		return 0;
+	}
+
+	return shader;
+
+}
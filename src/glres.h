@@ -0,0 +1,83 @@
+#ifndef COLLOMOSSE_MOCAP_GLRES_INCLUDED
+#define COLLOMOSSE_MOCAP_GLRES_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  GLRES.H                                              *
+*  OpenGL resources made once and held until shutdown   *
+*                                                       *
+*  Textures, buffers, display lists and shaders behind  *
+*  handles, counted as they are made and filled so the  *
+*  render loop can be checked to upload nothing         *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#ifdef WIN32
+	#include "windows.h"
+#endif
+
+#include "GL/gl.h"
+
+#define GLRES_INITIAL			(16)	/* Resource slots allocated up front, doubled when full */
+#define GLRES_SLOTBITS			(16)	/* Low bits of a handle hold its slot+1, the bits above the slot's generation */
+#define GLRES_SLOTS				((1<<GLRES_SLOTBITS)-1)
+
+/* Types of resource */
+#define GLRES_TEXTURE			(0)
+#define GLRES_BUFFER			(1)
+#define GLRES_LIST				(2)
+#define GLRES_PROGRAM			(3)
+
+/* Buffer targets and usage, missing from the OpenGL 1.1 headers on Windows */
+#ifndef GL_ARRAY_BUFFER
+	#define GL_ARRAY_BUFFER				0x8892
+	#define GL_ELEMENT_ARRAY_BUFFER		0x8893
+	#define GL_STREAM_DRAW				0x88E0
+	#define GL_STATIC_DRAW				0x88E4
+#endif
+
+/* Handle to a resource - 0 is none.  A handle outliving its resource is refused, even once the slot is reused */
+typedef int GLRES;
+
+/* Type for one resource held */
+typedef struct _glresource {
+
+	int		type;			/* GLRES_TEXTURE..., -1 for a free slot */
+	int		generation;		/* Bumped every time the slot is freed, so old handles no longer match */
+	GLuint	name;			/* OpenGL's name for it */
+	long	bytes;			/* Data handed to OpenGL for it */
+
+} GLRESOURCE;
+
+/* Type for the counts kept between two glres_endframe calls */
+typedef struct _glrescount {
+
+	int		allocations;	/* Resources made */
+	int		frees;			/* and released */
+	int		uploads;		/* Textures, buffers and lists filled with data that stays */
+	long	upload_bytes;
+	long	stream_bytes;	/* Data sent afresh every frame, e.g. instances - not an upload */
+
+} GLRESCOUNT;
+
+
+int		glres_init(void);												/* With a current GL context - 0 if buffers and shaders are missing (textures and lists still work) */
+int		glres_shutdown(void);											/* Release everything still held - returns how many were */
+int		glres_proc(void* fn, const char* name);							/* Look up a GL entry point into a function pointer - 0 if missing */
+int		glres_swapinterval(int interval);								/* Swap buffers every interval display refreshes (0 never waits) - 0 if the driver can't */
+GLRES	glres_texture(int w, int h, const unsigned char* rgb);			/* Mipmapped, repeating RGB texture */
+GLRES	glres_buffer(GLenum target, const void* data, long bytes);		/* Buffer filled once with data (NULL to stream into it) */
+GLRES	glres_list(long bytes);											/* Display list name for the caller to compile bytes of vertex data into */
+GLRES	glres_program(const char* vertex, const char* fragment, const char** attribs, int attribs_enum);	/* Linked shader, attribs[i] bound at i (NULL to skip) - 0 on failure */
+void	glres_stream(GLRES buffer, GLenum target, const void* data, long bytes);	/* Replace a buffer's data for this frame, leaving it bound */
+void	glres_bind(GLRES buffer, GLenum target);						/* Bind a buffer to target (0 unbinds) */
+void	glres_use(GLRES program);										/* Draw with a program (0 goes back to fixed function) */
+void	glres_free(GLRES res);
+GLuint	glres_name(GLRES res);											/* OpenGL's name for a handle, 0 for none, freed or stale */
+int		glres_live(void);												/* Resources held */
+void	glres_endframe(GLRESCOUNT* frame);								/* Counts since the last call (frame may be NULL), then start again */
+
+#endif
@@ -1,63 +1,116 @@
-/*******************************************************\
-*                                                       *
-*  MAIN.C                                               *
-*                                                       *
-*  Entry point for motion capture coursework            *
-*                                                       *
-*  (c) John Collomosse, University of Bath              *
-*  September 2008                                       *
-*                                                       *
-\*******************************************************/
-
-
-#include <stdio.h>
-#include <stdlib.h>
-#include "parser.h"
-#include "display.h"
-
-#define EXITCODE_SUCCESS	(0)
-#define EXITCODE_BADSYNTAX	(1)
-#define EXITCODE_BADSKEL	(2)
-#define EXITCODE_BADMOCAP	(3)
-
-
-int main (int argc, char** argv) {
-
-	SKELETON* model=NULL;		/* Stores the skeleton (from ASF file) */
-	MOCAP*	  motion=NULL;		/* Stores the motion capture data (from AMC file) */
-	int		  delay=0;			/* Stores the optional delay used to slow down animation on fast PCs */
-
-	/* Check we have both command line arguments */
-	if (argc<2 || argc>4) {
-		printf("Use MOCAPTEST <asf file> <amc file> [optional delay]\n");
-		return (EXITCODE_BADSYNTAX);
-	}
-	
-	/* Load the ASF file (skeleton) into 'model' */
-	if (!(model=parser_loadSkeleton(argv[1]))) {
-		printf("FATAL:  Failed to load skeleton from file\n");
-		return (EXITCODE_BADSKEL);
-	}
-
-	/* Print out the skeleton hierarchy just for info */
-	parser_debugskeletonTree(model);
-
-
-	/* Load the AMC file (motion capture data) into 'mocap' */
-	if (!(motion=parser_loadMocap(argv[2],model))) {
-		printf("FATAL:  Failed to load mocap data from file\n");
-		return (EXITCODE_BADMOCAP);
-	}
-
-	if (argc==4) {
-		delay=atoi(argv[3]);
-		printf("Pausing %dms at each cycle\n",delay);
-	}
-
-	/* TODO - Render an animation of the moving skeleton */
-	dorender(argc,argv,model,motion,delay);
-
-	/* Actually the dorender(..) call will never return from the GLUT loop so this line is redundant */
-
-	return (EXITCODE_SUCCESS);
+/*******************************************************\
+*                                                       *
+*  MAIN.C                                               *
+*                                                       *
+*  Entry point for motion capture coursework            *
+*                                                       *
+*  (c) John Collomosse, University of Bath              *
+*  September 2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parser.h"
+#include "amcb.h"
+#include "display.h"
+
+#define EXITCODE_SUCCESS	(0)
+#define EXITCODE_BADSYNTAX	(1)
+#define EXITCODE_BADSKEL	(2)
+#define EXITCODE_BADMOCAP	(3)
+
+
+int main (int argc, char** argv) {
+
+	SKELETON* model=NULL;		/* Stores the skeleton (from ASF file) */
+	MOCAP*	  motion=NULL;		/* Stores the motion capture data (from AMC file) */
+	int		  delay=0;			/* Stores the optional delay used to slow down animation on fast PCs */
+	int		  stream=0;			/* Play the AMC file straight from disk rather than loading it (-stream) */
+	AMCSTREAM* frames=NULL;		/* Reads the AMC file frame by frame when streaming */
+	int		  follow=0;			/* Keep reading the AMC file as it is written, showing the newest frame (-follow) */
+	AMCFOLLOW* live=NULL;		/* Parses frames appended to the AMC file when following */
+	FILEWATCH* watch=NULL;		/* Tells us when the AMC file grows */
+	int		  i;
+
+	/* Check we have both command line arguments */
+	if (argc<3 || argc>5) {
+		printf("Use MOCAPTEST <asf file> <amc file> [optional delay] [-stream | -follow]\n");
+		return (EXITCODE_BADSYNTAX);
+	}
+
+	/* Optional arguments */
+	for (i=3; i<argc; i++) {
+		if (!strcmp(argv[i],"-stream")) {
+			stream=1;
+		}
+		else if (!strcmp(argv[i],"-follow")) {
+			follow=1;
+		}
+		else {
+			delay=atoi(argv[i]);
+			printf("Playing a frame every %dms\n",delay);
+		}
+	}
+
+	if (follow) {
+
+		/* The AMC file may still be being written (e.g. by a live capture) - parse it as it grows */
+		if (!(model=parser_loadSkeleton(argv[1]))) {
+			printf("FATAL:  Failed to load skeleton from file\n");
+			return (EXITCODE_BADSKEL);
+		}
+		if (!(live=parser_openMocapFollow(argv[2],model)) || !(watch=filewatch_open(argv[2]))) {
+			printf("FATAL:  Failed to load mocap data from file\n");
+			return (EXITCODE_BADMOCAP);
+		}
+
+		parser_debugskeletonTree(model);
+		dorenderfollow(argc,argv,model,live,watch,delay);
+
+		return (EXITCODE_SUCCESS);
+	}
+
+	if (stream) {
+
+		/* Only the skeleton is loaded, the AMC file is read a frame at a time as it plays */
+		if (!(model=parser_loadSkeleton(argv[1]))) {
+			printf("FATAL:  Failed to load skeleton from file\n");
+			return (EXITCODE_BADSKEL);
+		}
+		if (!(frames=parser_openMocapStream(argv[2],model))) {
+			printf("FATAL:  Failed to load mocap data from file\n");
+			return (EXITCODE_BADMOCAP);
+		}
+
+		parser_debugskeletonTree(model);
+		dorenderstream(argc,argv,model,frames,delay);
+
+		return (EXITCODE_SUCCESS);
+	}
+
+	/* Load the ASF file (skeleton) into 'model' and the AMC file (motion capture data) into 'motion'.
+	 * Both come straight from the .amcb binary cache when it is up to date, otherwise the text
+	 * files are parsed and the cache is rewritten for next time.
+	 */
+	switch (amcb_load(argv[1],argv[2],&model,&motion)) {
+		case AMCB_BADSKEL:
+			printf("FATAL:  Failed to load skeleton from file\n");
+			return (EXITCODE_BADSKEL);
+		case AMCB_BADMOCAP:
+			printf("FATAL:  Failed to load mocap data from file\n");
+			return (EXITCODE_BADMOCAP);
+	}
+
+	/* Print out the skeleton hierarchy just for info */
+	parser_debugskeletonTree(model);
+
+	/* TODO - Render an animation of the moving skeleton */
+	dorender(argc,argv,model,motion,delay);
+
+	/* Actually the dorender(..) call will never return from the GLUT loop so this line is redundant */
+
+	return (EXITCODE_SUCCESS);
 }
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*******************************************************\
+*                                                       *
+*  MAPFILE.C                                            *
+*  Read-only memory mapped files                        *
+*                                                       *
+*  Maps a whole ASF/AMC file into memory so that the    *
+*  parsers can tokenize it in place                     *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include "mapfile.h"
+
+#ifndef WIN32
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+
+MAPPEDFILE*	mapfile_openmode(char* argFilename, int copy);	/* Shared implementation of mapfile_open/mapfile_opencopy */
+
+
+MAPPEDFILE* mapfile_open(char* argFilename) {
+
+	return mapfile_openmode(argFilename,0);
+
+}
+
+MAPPEDFILE* mapfile_opencopy(char* argFilename) {
+
+	return mapfile_openmode(argFilename,1);
+
+}
+
+
+#ifdef WIN32
+
+MAPPEDFILE* mapfile_openmode(char* argFilename, int copy) {
+
+	MAPPEDFILE* mf;
+	LARGE_INTEGER len;
+
+	mf=(MAPPEDFILE*)calloc(1,sizeof(MAPPEDFILE));
+
+	mf->file=CreateFileA(argFilename,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+	if (mf->file==INVALID_HANDLE_VALUE || !GetFileSizeEx(mf->file,&len)) {
+		if (mf->file!=INVALID_HANDLE_VALUE)
+			CloseHandle(mf->file);
+		free(mf);
+		return NULL;
+	}
+
+	mf->size=(size_t)len.QuadPart;
+	mf->data=NULL;
+	mf->mapping=NULL;
+
+	/* Windows refuses to map an empty file, leave data NULL in that case */
+	if (mf->size==0)
+		return mf;
+
+	mf->mapping=CreateFileMapping(mf->file,NULL,copy ? PAGE_WRITECOPY : PAGE_READONLY,0,0,NULL);
+	if (mf->mapping)
+		mf->data=(char*)MapViewOfFile(mf->mapping,copy ? FILE_MAP_COPY : FILE_MAP_READ,0,0,0);
+
+	if (!mf->data) {
+		if (mf->mapping)
+			CloseHandle(mf->mapping);
+		CloseHandle(mf->file);
+		free(mf);
+		return NULL;
+	}
+
+	return mf;
+
+}
+
+void mapfile_close(MAPPEDFILE* mf) {
+
+	if (!mf)
+		return;
+
+	if (mf->data)
+		UnmapViewOfFile(mf->data);
+	if (mf->mapping)
+		CloseHandle(mf->mapping);
+	CloseHandle(mf->file);
+	free(mf);
+
+}
+
+#else
+
+MAPPEDFILE* mapfile_openmode(char* argFilename, int copy) {
+
+	MAPPEDFILE* mf;
+	struct stat st;
+	void* addr;
+
+	mf=(MAPPEDFILE*)calloc(1,sizeof(MAPPEDFILE));
+
+	mf->fd=open(argFilename,O_RDONLY);
+	if (mf->fd<0 || fstat(mf->fd,&st)) {
+		if (mf->fd>=0)
+			close(mf->fd);
+		free(mf);
+		return NULL;
+	}
+
+	mf->size=(size_t)st.st_size;
+	mf->data=NULL;
+
+	/* mmap() refuses zero length mappings, leave data NULL in that case */
+	if (mf->size==0)
+		return mf;
+
+	addr=mmap(NULL,mf->size,copy ? PROT_READ|PROT_WRITE : PROT_READ,MAP_PRIVATE,mf->fd,0);
+	if (addr==MAP_FAILED) {
+		close(mf->fd);
+		free(mf);
+		return NULL;
+	}
+
+	/* The parsers walk read only mappings front to back */
+	if (!copy)
+		madvise(addr,mf->size,MADV_SEQUENTIAL);
+	mf->data=(char*)addr;
+
+	return mf;
+
+}
+
+void mapfile_close(MAPPEDFILE* mf) {
+
+	if (!mf)
+		return;
+
+	if (mf->data)
+		munmap(mf->data,mf->size);
+	close(mf->fd);
+	free(mf);
+
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef COLLOMOSSE_MOCAP_MAPFILE_INCLUDED
+#define COLLOMOSSE_MOCAP_MAPFILE_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  MAPFILE.H                                            *
+*  Read-only memory mapped files                        *
+*                                                       *
+*  Maps a whole ASF/AMC file into memory so that the    *
+*  parsers can tokenize it in place                     *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include <stddef.h>
+
+#ifdef WIN32
+	#include "windows.h"
+#endif
+
+/* Type for representing a mapped file - data[0] to data[size-1] are readable */
+typedef struct _mappedfile {
+
+	char*		data;		/* First byte of the file (NULL if the file is empty) - read only unless opened with mapfile_opencopy */
+	size_t		size;		/* Length of the file in bytes */
+
+#ifdef WIN32
+	HANDLE		file;		/* Underlying file handle */
+	HANDLE		mapping;	/* File mapping object */
+#else
+	int			fd;			/* Underlying file descriptor */
+#endif
+
+} MAPPEDFILE;
+
+
+MAPPEDFILE*	mapfile_open(char* argFilename);		/* Map a file read only, NULL on failure */
+MAPPEDFILE*	mapfile_opencopy(char* argFilename);	/* Map a file copy-on-write - data may be modified without touching the file */
+void		mapfile_close(MAPPEDFILE* mf);			/* Unmap and free */
+
+#endif
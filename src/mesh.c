@@ -0,0 +1,311 @@
+/*******************************************************\
+*                                                       *
+*  MESH.C                                               *
+*  Meshes built once and drawn many times               *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include "mesh.h"
+
+/* Attribute numbers of the instancing shader - a mat4 takes four in a row */
+#define MESH_POSITION	(0)
+#define MESH_NORMAL		(1)
+#define MESH_MODEL		(2)
+#define MESH_COLOUR		(6)
+
+#define MESH_PI			(3.14159265358979)
+
+/* Entry points looked up by mesh_init - making, binding and using buffers and shaders is left to glres.c */
+typedef struct _meshgl {
+
+	void	(APIENTRY *EnableVertexAttribArray)(GLuint);
+	void	(APIENTRY *DisableVertexAttribArray)(GLuint);
+	void	(APIENTRY *VertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+	void	(APIENTRY *VertexAttribDivisor)(GLuint, GLuint);
+	void	(APIENTRY *DrawElementsInstanced)(GLenum, GLsizei, GLenum, const void*, GLsizei);
+
+} MESHGL;
+
+/*
+ * The fixed function lighting init() sets up - one directional light, glColor driving ambient and diffuse
+ * through GL_COLOR_MATERIAL - worked out per vertex as before, but with each instance's own matrix and colour.
+ * The meshes are only ever scaled evenly across their normals, so the model matrix turns them as it should.
+ */
+const char* mesh_vertexshader=
+	"#version 120\n"
+	"attribute vec3 position;\n"
+	"attribute vec3 normal;\n"
+	"attribute mat4 model;\n"
+	"attribute vec3 colour;\n"
+	"varying vec4 lit;\n"
+	"void main() {\n"
+	"	vec3 n=normalize(gl_NormalMatrix*(mat3(model)*normal));\n"
+	"	float d=max(dot(n,normalize(gl_LightSource[0].position.xyz)),0.0);\n"
+	"	float s=(d>0.0) ? pow(max(dot(n,normalize(gl_LightSource[0].halfVector.xyz)),0.0),gl_FrontMaterial.shininess) : 0.0;\n"
+	"	lit=vec4(colour*(gl_LightModel.ambient.rgb+gl_LightSource[0].ambient.rgb+d*gl_LightSource[0].diffuse.rgb)\n"
+	"		+s*gl_LightSource[0].specular.rgb*gl_FrontMaterial.specular.rgb,1.0);\n"
+	"	gl_Position=gl_ModelViewProjectionMatrix*(model*vec4(position,1.0));\n"
+	"}\n";
+
+const char* mesh_fragmentshader=
+	"#version 120\n"
+	"varying vec4 lit;\n"
+	"void main() {\n"
+	"	gl_FragColor=lit;\n"
+	"}\n";
+
+/* Global variables */
+MESHGL	meshGL;					/* Entry points, valid when meshInstanced */
+int		meshInstanced = 0;		/* Non-zero once mesh_init has found instancing */
+GLRES	meshProgram = 0;		/* The instancing shader */
+GLRES	meshStream = 0;			/* Buffer the instances of each mesh_draw are streamed through */
+
+/* Shader attributes by number */
+const char* mesh_attribs[MESH_COLOUR+1]={"position","normal","model",NULL,NULL,NULL,"colour"};
+
+
+/* Internal prototypes */
+
+MESH*	mesh_build(float*, int, GLushort*, int);			/* Mesh from interleaved positions and normals and its triangles */
+
+
+int mesh_init(void) {
+
+	const char*	version=(const char*)glGetString(GL_VERSION);
+	const char*	extensions=(const char*)glGetString(GL_EXTENSIONS);
+	int			ok=1;
+
+	meshInstanced=0;
+	if (!version || atoi(version)<2 || !extensions || !strstr(extensions,"GL_ARB_instanced_arrays"))
+		return 0;
+
+	ok&=glres_proc(&(meshGL.EnableVertexAttribArray),"glEnableVertexAttribArray");
+	ok&=glres_proc(&(meshGL.DisableVertexAttribArray),"glDisableVertexAttribArray");
+	ok&=glres_proc(&(meshGL.VertexAttribPointer),"glVertexAttribPointer");
+	ok&=glres_proc(&(meshGL.VertexAttribDivisor),"glVertexAttribDivisorARB");
+	ok&=glres_proc(&(meshGL.DrawElementsInstanced),"glDrawElementsInstancedARB");
+
+	/* glres_program fails too if glres_init found no shaders */
+	if (!ok || !(meshProgram=glres_program(mesh_vertexshader,mesh_fragmentshader,mesh_attribs,MESH_COLOUR+1)))
+		return 0;
+
+	meshStream=glres_buffer(GL_ARRAY_BUFFER,NULL,0);
+	meshInstanced=1;
+
+	return 1;
+
+}
+
+void mesh_shutdown(void) {
+
+	glres_free(meshStream);
+	glres_free(meshProgram);
+	meshStream=meshProgram=0;
+	meshInstanced=0;
+
+}
+
+MESH* mesh_cylinder(int slices) {
+
+	MESH*		mesh;
+	float*		v;
+	GLushort*	t;
+	double		a;
+	int			i, n=slices+1;
+
+	/* A ring of vertices at z=0 and another at z=1, the first and last of each at the same angle */
+	v=(float*)malloc(sizeof(float)*6*2*n);
+	t=(GLushort*)malloc(sizeof(GLushort)*6*slices);
+	for (i=0; i<n; i++) {
+		a=2*MESH_PI*i/slices;
+		v[i*6]=v[i*6+3]=v[(n+i)*6]=v[(n+i)*6+3]=(float)sin(a);
+		v[i*6+1]=v[i*6+4]=v[(n+i)*6+1]=v[(n+i)*6+4]=(float)cos(a);
+		v[i*6+2]=v[i*6+5]=v[(n+i)*6+5]=0;
+		v[(n+i)*6+2]=1;
+	}
+	for (i=0; i<slices; i++) {
+		t[i*6]=(GLushort)i;		t[i*6+1]=(GLushort)(n+i+1);	t[i*6+2]=(GLushort)(i+1);
+		t[i*6+3]=(GLushort)i;	t[i*6+4]=(GLushort)(n+i);	t[i*6+5]=(GLushort)(n+i+1);
+	}
+
+	mesh=mesh_build(v,2*n,t,6*slices);
+	free(v);
+	free(t);
+
+	return mesh;
+
+}
+
+MESH* mesh_sphere(int slices, int stacks) {
+
+	MESH*		mesh;
+	float*		v;
+	float*		p;
+	GLushort*	t;
+	double		a, b;
+	int			i, j, k, n=slices+1;
+
+	/* Rings of latitude from the top down, each vertex its own normal */
+	v=(float*)malloc(sizeof(float)*6*n*(stacks+1));
+	t=(GLushort*)malloc(sizeof(GLushort)*6*slices*stacks);
+	for (j=0; j<=stacks; j++) {
+		b=MESH_PI*j/stacks;
+		for (i=0; i<n; i++) {
+			a=2*MESH_PI*i/slices;
+			p=v+(j*n+i)*6;
+			p[0]=p[3]=(float)(sin(b)*cos(a));
+			p[1]=p[4]=(float)(sin(b)*sin(a));
+			p[2]=p[5]=(float)cos(b);
+		}
+	}
+	for (j=k=0; j<stacks; j++) {
+		for (i=0; i<slices; i++, k+=6) {
+			t[k]=(GLushort)(j*n+i);		t[k+1]=(GLushort)((j+1)*n+i);	t[k+2]=(GLushort)((j+1)*n+i+1);
+			t[k+3]=(GLushort)(j*n+i);	t[k+4]=(GLushort)((j+1)*n+i+1);	t[k+5]=(GLushort)(j*n+i+1);
+		}
+	}
+
+	mesh=mesh_build(v,n*(stacks+1),t,6*slices*stacks);
+	free(v);
+	free(t);
+
+	return mesh;
+
+}
+
+void mesh_free(MESH* mesh) {
+
+	glres_free(mesh->vertices);
+	glres_free(mesh->indices);
+	glres_free(mesh->list);
+	free(mesh->instances);
+	free(mesh);
+
+}
+
+void mesh_add(MESH* mesh, MAT4* frame, MAT3* shape, float r, float g, float b) {
+
+	INSTANCE*	in;
+	MAT4*		out;
+	int			row, col;
+
+	if (mesh->instances_enum==mesh->instances_alloc) {
+		mesh->instances_alloc*=2;
+		mesh->instances=(INSTANCE*)realloc(mesh->instances,sizeof(INSTANCE)*mesh->instances_alloc);
+	}
+
+	in=mesh->instances+mesh->instances_enum++;
+	out=(MAT4*)(in->m);
+
+	/* frame.shape, shape having no translation of its own */
+	for (row=0; row<4; row++) {
+		for (col=0; col<3; col++)
+			MAT4_AT(out,row,col)=MAT4_AT(frame,row,0)*shape->m[0][col]+MAT4_AT(frame,row,1)*shape->m[1][col]+MAT4_AT(frame,row,2)*shape->m[2][col];
+		MAT4_AT(out,row,3)=MAT4_AT(frame,row,3);
+	}
+
+	in->colour[0]=r;
+	in->colour[1]=g;
+	in->colour[2]=b;
+	in->colour[3]=1;
+
+}
+
+void mesh_draw(MESH* mesh) {
+
+	INSTANCE*	in;
+	int			i;
+
+	if (!mesh->instances_enum)
+		return;
+
+	if (!meshInstanced) {
+		/* One display list call per instance - the matrices scale the mesh, so the normals need renormalising */
+		glEnable(GL_NORMALIZE);
+		for (i=0; i<mesh->instances_enum; i++) {
+			in=mesh->instances+i;
+			glPushMatrix();
+			glMultMatrixf(in->m);
+			glColor3fv(in->colour);
+			glCallList(glres_name(mesh->list));
+			glPopMatrix();
+		}
+		glDisable(GL_NORMALIZE);
+		mesh->instances_enum=0;
+		return;
+	}
+
+	glres_use(meshProgram);
+
+	glres_bind(mesh->vertices,GL_ARRAY_BUFFER);
+	meshGL.VertexAttribPointer(MESH_POSITION,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)0);
+	meshGL.VertexAttribPointer(MESH_NORMAL,3,GL_FLOAT,GL_FALSE,6*sizeof(float),(void*)(3*sizeof(float)));
+	meshGL.EnableVertexAttribArray(MESH_POSITION);
+	meshGL.EnableVertexAttribArray(MESH_NORMAL);
+
+	/* The instances, one step along the buffer per instance rather than per vertex */
+	glres_stream(meshStream,GL_ARRAY_BUFFER,mesh->instances,sizeof(INSTANCE)*mesh->instances_enum);
+	for (i=0; i<4; i++) {
+		meshGL.VertexAttribPointer(MESH_MODEL+i,4,GL_FLOAT,GL_FALSE,sizeof(INSTANCE),(void*)(offsetof(INSTANCE,m)+4*i*sizeof(float)));
+		meshGL.VertexAttribDivisor(MESH_MODEL+i,1);
+		meshGL.EnableVertexAttribArray(MESH_MODEL+i);
+	}
+	meshGL.VertexAttribPointer(MESH_COLOUR,3,GL_FLOAT,GL_FALSE,sizeof(INSTANCE),(void*)offsetof(INSTANCE,colour));
+	meshGL.VertexAttribDivisor(MESH_COLOUR,1);
+	meshGL.EnableVertexAttribArray(MESH_COLOUR);
+
+	glres_bind(mesh->indices,GL_ELEMENT_ARRAY_BUFFER);
+	meshGL.DrawElementsInstanced(GL_TRIANGLES,mesh->indices_enum,GL_UNSIGNED_SHORT,(void*)0,mesh->instances_enum);
+
+	/* Leave the fixed function state as we found it for everything else */
+	for (i=MESH_POSITION; i<=MESH_COLOUR; i++) {
+		meshGL.VertexAttribDivisor(i,0);
+		meshGL.DisableVertexAttribArray(i);
+	}
+	glres_bind(0,GL_ELEMENT_ARRAY_BUFFER);
+	glres_bind(0,GL_ARRAY_BUFFER);
+	glres_use(0);
+
+	mesh->instances_enum=0;
+
+}
+
+
+MESH* mesh_build(float* v, int v_enum, GLushort* t, int t_enum) {
+
+	MESH* mesh;
+
+	mesh=(MESH*)calloc(1,sizeof(MESH));
+	mesh->indices_enum=t_enum;
+	mesh->instances_alloc=MESH_INITIAL_INSTANCES;
+	mesh->instances=(INSTANCE*)malloc(sizeof(INSTANCE)*MESH_INITIAL_INSTANCES);
+
+	if (meshInstanced) {
+		mesh->vertices=glres_buffer(GL_ARRAY_BUFFER,v,sizeof(float)*6*v_enum);
+		mesh->indices=glres_buffer(GL_ELEMENT_ARRAY_BUFFER,t,sizeof(GLushort)*t_enum);
+	}
+	else {
+		/* OpenGL 1.1 - the list takes its own copy of the arrays as it is compiled */
+		mesh->list=glres_list(sizeof(float)*6*v_enum+sizeof(GLushort)*t_enum);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glVertexPointer(3,GL_FLOAT,6*sizeof(float),v);
+		glNormalPointer(GL_FLOAT,6*sizeof(float),v+3);
+		glNewList(glres_name(mesh->list),GL_COMPILE);
+		glDrawElements(GL_TRIANGLES,t_enum,GL_UNSIGNED_SHORT,t);
+		glEndList();
+		glDisableClientState(GL_NORMAL_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+	}
+
+	return mesh;
+
+}
@@ -0,0 +1,60 @@
+#ifndef COLLOMOSSE_MOCAP_MESH_INCLUDED
+#define COLLOMOSSE_MOCAP_MESH_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  MESH.H                                               *
+*  Meshes built once and drawn many times               *
+*                                                       *
+*  Unit cylinder and sphere kept in vertex buffers and  *
+*  drawn as instances, one draw call per mesh however   *
+*  many bones and joints (or skeletons) are queued      *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#ifdef WIN32
+	#include "windows.h"
+#endif
+
+#include "GL/gl.h"
+
+#include "fk.h"
+#include "glres.h"
+
+#define MESH_INITIAL_INSTANCES	(64)	/* Instances allocated up front in each mesh's queue, doubled when full */
+
+/* Type for one instance - its model matrix (column major, as MAT4) then its colour */
+typedef struct _instance {
+
+	float	m[16];
+	float	colour[4];
+
+} INSTANCE;
+
+/* Type for a mesh and the instances of it queued for the next mesh_draw */
+typedef struct _mesh {
+
+	GLRES		vertices;		/* Buffer of interleaved position and normal, 0 without instancing */
+	GLRES		indices;		/* Buffer of triangles */
+	GLRES		list;			/* Display list drawing the mesh once, used without instancing */
+	int			indices_enum;
+
+	INSTANCE*	instances;
+	int			instances_enum;
+	int			instances_alloc;
+
+} MESH;
+
+
+int		mesh_init(void);												/* Look up instancing once glres_init has run - 0 means meshes fall back to display lists */
+void	mesh_shutdown(void);
+MESH*	mesh_cylinder(int slices);										/* Radius 1 round the Z axis from z=0 to z=1, open ended as gluCylinder */
+MESH*	mesh_sphere(int slices, int stacks);							/* Radius 1 round the origin */
+void	mesh_free(MESH* mesh);
+void	mesh_add(MESH* mesh, MAT4* frame, MAT3* shape, float r, float g, float b);	/* Queue an instance at frame.shape - shape scales and turns the unit mesh */
+void	mesh_draw(MESH* mesh);											/* Draw every queued instance under the current MODELVIEW and empty the queue */
+
+#endif
@@ -0,0 +1,206 @@
+/*******************************************************\
+*                                                       *
+*  NUMBENCH.C                                           *
+*  Microbenchmark for the number scanner                *
+*                                                       *
+*  Converts every number in the given AMC files with    *
+*  sscanf, strtof and numparse_float, checks they agree *
+*  bit for bit and reports the time for each            *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mapfile.h"
+#include "numparse.h"
+#include "timer.h"
+
+#define EXITCODE_SUCCESS	(0)
+#define EXITCODE_BADSYNTAX	(1)
+#define EXITCODE_BADFILE	(2)
+#define EXITCODE_MISMATCH	(3)
+
+#define BENCH_RUNS			(5)			/* Each scanner is timed this many times, the best run is reported */
+#define TOKEN_BUFFERLEN		(64)		/* Longest number kept */
+
+/* Every numeric token from the input files, each null terminated */
+typedef struct _tokenlist {
+
+	char*	text;			/* Tokens back to back */
+	int*	offsets;		/* Start of each token in text */
+	int		tokens_enum;
+	int		text_len;
+	int		text_alloc;
+	int		tokens_alloc;
+
+} TOKENLIST;
+
+int		collect_tokens(char* filename, TOKENLIST* list);			/* Append the numbers of one file, 0 on failure */
+double	time_sscanf(TOKENLIST* list, float* out);					/* Best of BENCH_RUNS for each scanner, in seconds */
+double	time_strtof(TOKENLIST* list, float* out);
+double	time_numparse(TOKENLIST* list, float* out);
+
+
+int main (int argc, char** argv) {
+
+	TOKENLIST	list;
+	float*		viasscanf;
+	float*		viastrtof;
+	float*		vianumparse;
+	double		tsscanf, tstrtof, tnumparse;
+	int			i, mismatches;
+
+	if (argc<2) {
+		printf("Use NUMBENCH <amc file> [more amc files]\n");
+		return (EXITCODE_BADSYNTAX);
+	}
+
+	memset(&list,0,sizeof(TOKENLIST));
+	for (i=1; i<argc; i++) {
+		if (!collect_tokens(argv[i],&list)) {
+			printf("FATAL:  Failed to read %s\n",argv[i]);
+			return (EXITCODE_BADFILE);
+		}
+	}
+
+	viasscanf=(float*)malloc(sizeof(float)*(list.tokens_enum+1));
+	viastrtof=(float*)malloc(sizeof(float)*(list.tokens_enum+1));
+	vianumparse=(float*)malloc(sizeof(float)*(list.tokens_enum+1));
+
+	tsscanf=time_sscanf(&list,viasscanf);
+	tstrtof=time_strtof(&list,viastrtof);
+	tnumparse=time_numparse(&list,vianumparse);
+
+	/* Compare bit patterns, not values, so -0 and 0 (or NaNs) are told apart */
+	mismatches=0;
+	for (i=0; i<list.tokens_enum; i++) {
+		if (memcmp(viastrtof+i,vianumparse+i,sizeof(float)) || memcmp(viastrtof+i,viasscanf+i,sizeof(float))) {
+			if (mismatches++<10)
+				printf("MISMATCH [%s] strtof %.9g sscanf %.9g numparse %.9g\n",list.text+list.offsets[i],viastrtof[i],viasscanf[i],vianumparse[i]);
+		}
+	}
+
+	printf("%d numbers, %d bytes\n",list.tokens_enum,list.text_len);
+	printf("  sscanf    %8.3f ms  %7.1f ns/number\n",tsscanf*1000.0,tsscanf*1e9/list.tokens_enum);
+	printf("  strtof    %8.3f ms  %7.1f ns/number\n",tstrtof*1000.0,tstrtof*1e9/list.tokens_enum);
+	printf("  numparse  %8.3f ms  %7.1f ns/number  (%.2fx sscanf, %.2fx strtof)\n",tnumparse*1000.0,tnumparse*1e9/list.tokens_enum,tsscanf/tnumparse,tstrtof/tnumparse);
+	printf("  results %s\n",mismatches ? "DIFFER" : "bit-identical");
+
+	free(viasscanf);
+	free(viastrtof);
+	free(vianumparse);
+	free(list.text);
+	free(list.offsets);
+
+	return mismatches ? (EXITCODE_MISMATCH) : (EXITCODE_SUCCESS);
+}
+
+
+int collect_tokens(char* filename, TOKENLIST* list) {
+
+	MAPPEDFILE*	mf;
+	const char*	p;
+	const char*	end;
+	int			len;
+
+	if (!(mf=mapfile_open(filename)))
+		return 0;
+
+	/* A token is a number if it starts like one - bone names and keywords are skipped */
+	p=mf->data;
+	end=p+mf->size;
+	while (p<end) {
+		while (p<end && (unsigned char)*p<=0x20)
+			p++;
+		len=0;
+		while (p+len<end && (unsigned char)p[len]>0x20)
+			len++;
+
+		if (len && len<TOKEN_BUFFERLEN && ((*p>='0' && *p<='9') || *p=='-' || *p=='+' || *p=='.')) {
+			if (list->tokens_enum==list->tokens_alloc) {
+				list->tokens_alloc=list->tokens_alloc ? list->tokens_alloc*2 : 4096;
+				list->offsets=(int*)realloc(list->offsets,sizeof(int)*list->tokens_alloc);
+			}
+			if (list->text_len+len+1>list->text_alloc) {
+				list->text_alloc=(list->text_alloc+len+1)*2;
+				list->text=(char*)realloc(list->text,list->text_alloc);
+			}
+			list->offsets[list->tokens_enum++]=list->text_len;
+			memcpy(list->text+list->text_len,p,len);
+			list->text[list->text_len+len]='\0';
+			list->text_len+=len+1;
+		}
+		p+=len;
+	}
+
+	mapfile_close(mf);
+
+	return 1;
+
+}
+
+
+double time_sscanf(TOKENLIST* list, float* out) {
+
+	double	best=-1, t;
+	int		i, run;
+
+	for (run=0; run<BENCH_RUNS; run++) {
+		t=timer_seconds();
+		for (i=0; i<list->tokens_enum; i++)
+			sscanf(list->text+list->offsets[i],"%f",out+i);
+		t=timer_seconds()-t;
+		if (best<0 || t<best)
+			best=t;
+	}
+
+	return best;
+
+}
+
+
+double time_strtof(TOKENLIST* list, float* out) {
+
+	double	best=-1, t;
+	int		i, run;
+
+	for (run=0; run<BENCH_RUNS; run++) {
+		t=timer_seconds();
+		for (i=0; i<list->tokens_enum; i++)
+			out[i]=strtof(list->text+list->offsets[i],NULL);
+		t=timer_seconds()-t;
+		if (best<0 || t<best)
+			best=t;
+	}
+
+	return best;
+
+}
+
+
+double time_numparse(TOKENLIST* list, float* out) {
+
+	double		best=-1, t;
+	const char*	tok;
+	int			i, run;
+
+	for (run=0; run<BENCH_RUNS; run++) {
+		t=timer_seconds();
+		for (i=0; i<list->tokens_enum; i++) {
+			tok=list->text+list->offsets[i];
+			/* Tokens are back to back in one buffer, so the scanner may read up to the end of it */
+			numparse_float(tok,list->text+list->text_len,out+i);
+		}
+		t=timer_seconds()-t;
+		if (best<0 || t<best)
+			best=t;
+	}
+
+	return best;
+
+}
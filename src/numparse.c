@@ -0,0 +1,406 @@
+/*******************************************************\
+*                                                       *
+*  NUMPARSE.C                                           *
+*  Locale free number scanner/formatter for ASF/AMC     *
+*                                                       *
+*  Converts decimal text straight from the read buffer  *
+*  with results bit-identical to strtof, and back       *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "numparse.h"
+
+/* Longest token copied for the strtof fallback */
+#define NUMPARSE_BUFFERLEN	(64)
+
+/* Most significant digits accumulated exactly in 64 bits */
+#define NUMPARSE_MAXDIGITS	(19)
+
+/* Eight digits at a time (SIMD within a register) needs unaligned little endian 64 bit loads */
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__) || \
+	(defined(__BYTE_ORDER__) && __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__)
+	#define NUMPARSE_SWAR
+#endif
+
+/* The direct conversion relies on double arithmetic being rounded to double (SSE2, not x87) */
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD==0) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+	#define NUMPARSE_FASTPATH
+#endif
+
+typedef unsigned long long U64;
+
+/* Powers of ten exactly representable in a double */
+static const double pow10tab[23]={
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Powers of ten for shifting accumulated digits along (and counting digits when formatting) */
+static const U64 pow10int[10]={
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+};
+
+const char*	numparse_digits(const char* p, const char* end, U64* m, int* ndigits);	/* Accumulate a run of digits */
+const char*	numparse_fallback(const char* p, const char* end, float* out);		/* Copy the token and use strtof */
+int			numparse_ctz(U64 v);													/* Count trailing zero bits of a non zero word */
+double		numparse_pow10(int k);													/* 10^k, exact for 0<=k<=22 */
+int			numparse_round(double a, int prec, int e10, U64* m, int* k);			/* a rounded to prec digits as m/10^k - 0 if that came out as zero */
+int			numparse_roundtrips(U64 m, int k, float f);								/* Non zero if m/10^k reads back as exactly f */
+int			numparse_emit(U64 m, int digits, int exp, char* out);				/* Write d.ddd x 10^exp without trailing zeros */
+
+
+const char* numparse_float(const char* p, const char* end, float* out) {
+
+	const char*	start=p;
+	const char*	q;
+	U64			m=0;			/* significant digits */
+	int			ndigits=0;		/* digits accumulated into m (leading zeros included) */
+	int			intdigits;
+	int			fracdigits;
+	int			neg=0;
+	int			e=0;			/* decimal exponent applied to m */
+	int			eneg=0;
+	int			ev;
+	double		d;
+	U64			bits;
+
+	if (p<end && (*p=='-' || *p=='+'))
+		neg=(*p++=='-');
+
+	/* Integer part */
+	q=numparse_digits(p,end,&m,&ndigits);
+	intdigits=q-p;
+	p=q;
+
+	/* Fraction part - every digit moves the decimal point one place */
+	fracdigits=0;
+	if (p<end && *p=='.') {
+		q=numparse_digits(p+1,end,&m,&ndigits);
+		fracdigits=q-(p+1);
+		e=-fracdigits;
+		p=q;
+	}
+
+	if (!intdigits && !fracdigits)
+		return numparse_fallback(start,end,out);	/* inf, nan or not a number at all */
+
+	/* Exponent - only taken if at least one digit follows, as strtof does */
+	if (p<end && (*p=='e' || *p=='E')) {
+		q=p+1;
+		if (q<end && (*q=='-' || *q=='+'))
+			eneg=(*q++=='-');
+		if (q<end && *q>='0' && *q<='9') {
+			ev=0;
+			while (q<end && *q>='0' && *q<='9') {
+				if (ev<100000)
+					ev=ev*10+(*q-'0');
+				q++;
+			}
+			e+=eneg ? -ev : ev;
+			p=q;
+		}
+	}
+
+	/* Hex floats start with a lone zero, let strtof deal with them */
+	if (p<end && (*p=='x' || *p=='X'))
+		return numparse_fallback(start,end,out);
+
+	/* Too many digits to hold exactly */
+	if (ndigits>NUMPARSE_MAXDIGITS)
+		return numparse_fallback(start,end,out);
+
+	if (m==0) {
+		*out=neg ? -0.0f : 0.0f;
+		return p;
+	}
+
+#ifdef NUMPARSE_FASTPATH
+	/* m and 10^|e| are exact doubles, so one multiply or divide gives the correctly rounded double.
+	 * Rounding that to float is only wrong if it landed exactly half way between two floats
+	 * (the 29 bits dropped are 1000...0), so those rare cases go to strtof too.
+	 */
+	if (m<=((U64)1<<53) && e>=-22 && e<=22) {
+		d=(e<0) ? (double)m/pow10tab[-e] : (double)m*pow10tab[e];
+		memcpy(&bits,&d,sizeof(double));
+		if ((bits&0x1FFFFFFFULL)!=0x10000000ULL) {
+			*out=(float)(neg ? -d : d);
+			return p;
+		}
+	}
+#endif
+
+	return numparse_fallback(start,end,out);
+
+}
+
+
+const char* numparse_digits(const char* p, const char* end, U64* m, int* ndigits) {
+
+#ifdef NUMPARSE_SWAR
+	U64	v, t, nondigit;
+	int	n;
+
+	/* Classify and convert up to eight digits per step while eight bytes are readable */
+	while (end-p>=8 && *ndigits+8<=NUMPARSE_MAXDIGITS) {
+		memcpy(&v,p,8);
+
+		/* High bit of each byte set where the byte isn't '0'..'9' - exact up to the first such byte */
+		t=v-0x3030303030303030ULL;
+		nondigit=(t | (t+0x7676767676767676ULL)) & 0x8080808080808080ULL;
+		n=nondigit ? numparse_ctz(nondigit)>>3 : 8;
+		if (!n)
+			return p;
+
+		/* Shift the digits to the top of the word so the bytes below read as leading zeros,
+		 * then combine pairs, quads and octets of digits with three multiplies
+		 */
+		v<<=(8-n)*8;
+		v=((v&0x0F0F0F0F0F0F0F0FULL)*2561)>>8;
+		v=((v&0x00FF00FF00FF00FFULL)*6553601)>>16;
+		v=((v&0x0000FFFF0000FFFFULL)*42949672960001ULL)>>32;
+
+		*m=*m*pow10int[n]+v;
+		*ndigits+=n;
+		p+=n;
+		if (n<8)
+			return p;
+	}
+#endif
+
+	while (p<end && *p>='0' && *p<='9') {
+		/* Digits beyond what fits are still consumed, the caller then falls back to strtof */
+		if (*ndigits<NUMPARSE_MAXDIGITS)
+			*m=*m*10+(*p-'0');
+		(*ndigits)++;
+		p++;
+	}
+
+	return p;
+
+}
+
+
+const char* numparse_fallback(const char* p, const char* end, float* out) {
+
+	char	tok[NUMPARSE_BUFFERLEN];
+	char*	stop;
+	int		len=0;
+
+	/* strtof needs a terminated string, copy up to the next whitespace */
+	while (p+len<end && len<NUMPARSE_BUFFERLEN-1 && (unsigned char)p[len]>0x20 && (unsigned char)p[len]<0x7f) {
+		tok[len]=p[len];
+		len++;
+	}
+	tok[len]='\0';
+
+	*out=strtof(tok,&stop);
+	if (stop==tok)
+		return NULL;
+
+	return p+(stop-tok);
+
+}
+
+
+int numparse_ctz(U64 v) {
+
+#if defined(__GNUC__)
+	return __builtin_ctzll(v);
+#else
+	int n=0;
+
+	while (!(v&0xFF)) {
+		v>>=8;
+		n+=8;
+	}
+	while (!(v&1)) {
+		v>>=1;
+		n++;
+	}
+	return n;
+#endif
+
+}
+
+
+int numparse_format(float f, char* out) {
+
+	char*	p=out;
+	double	a;
+	int		e2, e10, prec, k, n;
+	int		lo, hi, best=0, bestk=0;
+	U64		m, bestm=0;
+	unsigned int bits;
+
+	memcpy(&bits,&f,sizeof(float));
+	if (f!=f || f-f!=0)
+		return sprintf(out,"%g",f);		/* inf and nan */
+	if (bits&0x80000000u)
+		*p++='-';
+	if (f==0) {
+		strcpy(p,"0");
+		return p+1-out;
+	}
+
+	/* Decimal exponent of the leading digit - estimated from the binary exponent (x1233/4096 ~ log10 2)
+	 * then corrected by comparing against powers of ten
+	 */
+	a=(f<0) ? -(double)f : (double)f;
+	e2=(int)((bits>>23)&0xFF)-127;
+	e10=(e2>=0) ? (e2*1233)>>12 : -(((-e2)*1233+4095)>>12);
+	while (a<numparse_pow10(e10))
+		e10--;
+	while (a>=numparse_pow10(e10+1))
+		e10++;
+
+	/* Rounding to more digits never gets further from f, so binary search for the fewest that read back
+	 * as f - nine always do. Every candidate is checked, so a bad rounding in the double arithmetic can
+	 * only cost a digit, never exactness.
+	 */
+	lo=1;
+	hi=10;
+	while (lo<hi) {
+		prec=(lo+hi)/2;
+		if (numparse_round(a,prec,e10,&m,&k) && numparse_roundtrips(m,k,f)) {
+			best=prec;
+			bestm=m;
+			bestk=k;
+			hi=prec;
+		}
+		else
+			lo=prec+1;
+	}
+	if (best)
+		return (p-out)+numparse_emit(bestm,best,best-1-bestk,p);
+
+	/* Only reached if the double arithmetic above fell foul of a rounding tie */
+	n=sprintf(p,"%.9g",a);
+	return (p-out)+n;
+
+}
+
+
+double numparse_pow10(int k) {
+
+	double d=1;
+
+	if (k>=0 && k<=22)
+		return pow10tab[k];
+
+	/* Beyond the table - inexact, so numparse_roundtrips checks the result the slow way */
+	while (k>22) {
+		d*=1e22;
+		k-=22;
+	}
+	while (k<-22) {
+		d/=1e22;
+		k+=22;
+	}
+
+	return (k>=0) ? d*pow10tab[k] : d/pow10tab[-k];
+
+}
+
+
+int numparse_round(double a, int prec, int e10, U64* m, int* k) {
+
+	double d;
+
+	*k=prec-1-e10;
+	d=(*k>=0) ? a*numparse_pow10(*k) : a/numparse_pow10(-*k);
+	*m=(U64)(d+0.5);
+	if (*m>=pow10int[prec]) {
+		/* Rounded up to the next power of ten */
+		*m/=10;
+		(*k)--;
+	}
+
+	return *m!=0;
+
+}
+
+
+int numparse_roundtrips(U64 m, int k, float f) {
+
+	char	buf[NUMPARSE_FORMATLEN];
+	float	back;
+	float	a=(f<0) ? -f : f;
+	double	d;
+	U64		bits;
+	int		n;
+
+#ifdef NUMPARSE_FASTPATH
+	/* The same exact conversion numparse_float makes, without going through text */
+	if (m<=((U64)1<<53) && k>=-22 && k<=22) {
+		d=(k>=0) ? (double)m/pow10tab[k] : (double)m*pow10tab[-k];
+		memcpy(&bits,&d,sizeof(double));
+		if ((bits&0x1FFFFFFFULL)!=0x10000000ULL)
+			return (float)d==a;
+	}
+#endif
+
+	n=sprintf(buf,"%llue%d",m,-k);
+	numparse_float(buf,buf+n,&back);
+	return back==a;
+
+}
+
+
+int numparse_emit(U64 m, int digits, int exp, char* out) {
+
+	char	dig[10];
+	char*	p=out;
+	int		i;
+
+	/* Digits most significant first, trailing zeros dropped */
+	for (i=digits-1; i>=0; i--) {
+		dig[i]=(char)('0'+m%10);
+		m/=10;
+	}
+	while (digits>1 && dig[digits-1]=='0')
+		digits--;
+
+	if (exp>=-4 && exp<9) {
+		if (exp<0) {
+			/* 0.000ddd */
+			*p++='0';
+			*p++='.';
+			for (i=-1; i>exp; i--)
+				*p++='0';
+			for (i=0; i<digits; i++)
+				*p++=dig[i];
+		}
+		else {
+			/* ddd.ddd or ddd000 */
+			for (i=0; i<=exp; i++)
+				*p++=(i<digits) ? dig[i] : '0';
+			if (digits>exp+1) {
+				*p++='.';
+				for (i=exp+1; i<digits; i++)
+					*p++=dig[i];
+			}
+		}
+	}
+	else {
+		/* d.ddde-xx */
+		*p++=dig[0];
+		if (digits>1) {
+			*p++='.';
+			for (i=1; i<digits; i++)
+				*p++=dig[i];
+		}
+		p+=sprintf(p,"e%d",exp);
+	}
+
+	*p='\0';
+	return p-out;
+
+}
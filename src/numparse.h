@@ -0,0 +1,32 @@
+#ifndef COLLOMOSSE_MOCAP_NUMPARSE_INCLUDED
+#define COLLOMOSSE_MOCAP_NUMPARSE_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  NUMPARSE.H                                           *
+*  Locale free number scanner/formatter for ASF/AMC     *
+*                                                       *
+*  Converts decimal text straight from the read buffer  *
+*  with results bit-identical to strtof, and back       *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+/* Parse one number starting exactly at p (no leading whitespace) and never reading at or past end.
+ * Returns the first byte after the number, or NULL if there isn't one at p.
+ * Plain decimals e.g. -26.2701 and 7.62852e-016 are converted directly, anything else
+ * (very long mantissas, huge exponents, inf/nan, hex) is handed on to strtof.
+ */
+const char*	numparse_float(const char* p, const char* end, float* out);
+
+/* Room needed by numparse_format, terminator included */
+#define NUMPARSE_FORMATLEN	(32)
+
+/* Write the shortest decimal that numparse_float (and strtof) reads back as exactly f, e.g. 0.1f -> "0.1".
+ * Plain notation from 1e-4 up to 1e9, scientific outside it. Returns the length, out is null terminated.
+ */
+int			numparse_format(float f, char* out);
+
+#endif
@@ -1,698 +1,1936 @@
-/*******************************************************\
-*                                                       *
-*  PARSER.C                                             *
-*  Acclaim Motion Capture (ASF/AMC) Parser Library      *
-*                                                       *
-*  Parses Skeleton (ASF) and motion capture (AMC) files *
-*  Written as a resource for CM20219 coursework         *
-*                                                       *
-*  (c) John Collomosse, University of Bath              *
-*  September 2008                                       *
-*                                                       *
-\*******************************************************/
-
-/* CM20219 students - You should not need to edit/view 
-   this file for your coursework */
-
-#include "parser.h"
-
-/* ASF/AMC parser states */
-#define PARSESTATE_UNKNOWN	(0)
-#define PARSESTATE_VERSION	(1)
-#define PARSESTATE_NAME		(2)
-#define PARSESTATE_UNITS	(3)
-#define PARSESTATE_DOCS		(4)
-#define PARSESTATE_ROOT		(5)
-#define PARSESTATE_BONEDATA	(6)
-#define PARSESTATE_HIERARCHY (7)
-#define PARSESTATE_DEGREES  (8)
-
-/* Presence flags for DOF keywords in :bonedata of ASF file */
-#define DOF_FLAG_RX (0x01)
-#define DOF_FLAG_RY (0x02)
-#define DOF_FLAG_RZ (0x04)
-
-/* Buffer size for reading each line of ASF/AMC file */
-#define READ_BUFFERLEN		(1024)
-
-/* Prototypes for internal functions */
-
-void	trim			(char*);		/* Trim whitespace off string */
-int		changemode		(char*);		/* Check for change of parser state */
-int		nextwht			(char*);		/* Find next whitespace character in string */
-
-int		decode_bonedata	(FILE*, BONE**, int*);				/* Decoder for ASF :bonedata state */
-int		decode_dummyfield(FILE*);							/* Decoder for ASF/AMC dummy/invalid state */
-int		decode_hierarchy(FILE*, BONE*, int, SKELETON*);		/* Decoder for ASF :hierarchy state */
-int		getboneindex (BONE*, int, char*);					/* Resolve bone name to bone index */
-void	debugskeletonTree_recur(BONE* bn, int recurctr);	/* Print skeleton hierarchy for debugging */
-void	parser_free_skeleton_helper(BONE* bn);				/* Recursive helper for freeing skeleton structure */
-int		decode_root(FILE* fp, SKELETON* skel);				/* Decoder for ASF :root state */
-int		decode_degrees(FILE* fp, MOCAP* mocap, SKELETON* skel);/* Decoder for AMC :degrees state */
-void	rotateVector(POINT3D*, float, float, float);	/* Rotate vector by X, Y, Z Euler angles */
-
-SKELETON* parser_loadSkeleton(char* argFilename) {
-
-	FILE* fp;					/* file to be parsed */
-	int	  ps;				/* parser state */
-	char  buf [READ_BUFFERLEN];	/* parse buffer */
-	SKELETON* skel;				/* the skeleton */
-	BONE*		bones;			/* bone collection */
-	int			bone_enum;		/* count of bones in collection */
-	int		i;
-	
-	if (!(fp=fopen(argFilename,"rt")))
-		return NULL;
-
-	skel=(SKELETON*)calloc(1,sizeof(SKELETON));
-	skel->children_enum=0;
-	skel->children=NULL;
-	skel->bonearray=NULL;
-
-	bones=NULL;
-	bone_enum=0;
-	
-	ps=PARSESTATE_UNKNOWN;
-	while (!feof(fp)) {
-
-		if (ps==PARSESTATE_UNKNOWN) {
-			fgets(buf,READ_BUFFERLEN,fp);
-			trim(buf);
-			ps=changemode(buf);
-		}
-
-		
-		/* Handle modes */
-		switch (ps) {
-			case PARSESTATE_BONEDATA:
-				ps=decode_bonedata(fp,&bones,&bone_enum);
-				break;
-			case PARSESTATE_HIERARCHY:
-				ps=decode_hierarchy(fp,bones,bone_enum,skel);
-				break;
-			case PARSESTATE_ROOT:
-				ps=decode_root(fp,skel);
-				break;
-			default:
-				ps=decode_dummyfield(fp);
-				break;
-		}
-
-	}
-
-	
-	fclose(fp);
-
-	/* Rewrite the bone direction vectors (which are in global i.e. root frame coords) to the local/axis coord system
-	   which is more convenient when performing recursion later on */
-
-	for (i=0; i<skel->bonearray_enum; i++) {
-		rotateVector(&(skel->bonearray[i].direction), -skel->bonearray[i].axis.x, -skel->bonearray[i].axis.y, -skel->bonearray[i].axis.z); 
-	}
-
-	return skel;
-
-}
-
-int changemode (char* argstr) {
-
-	unsigned int i;
-	char tmp[READ_BUFFERLEN];
-	strcpy(tmp,argstr);
-
-	for (i=0; i<strlen(tmp); i++) {
-		if (tmp[i]<=0x20 || tmp[i]>=0x7f) {
-			tmp[i]='\0';
-			break;
-		}
-	}
-
-	if (!strcasecmp(tmp,":version"))
-		return PARSESTATE_VERSION;
-	else if (!strcasecmp(tmp,":name"))
-		return PARSESTATE_NAME;
-	else if (!strcasecmp(tmp,":units"))
-		return PARSESTATE_UNITS;
-	else if (!strcasecmp(tmp,":documentation"))
-		return PARSESTATE_DOCS;
-	else if (!strcasecmp(tmp,":root"))
-		return PARSESTATE_ROOT;
-	else if (!strcasecmp(tmp,":bonedata"))
-		return PARSESTATE_BONEDATA;
-	else if (!strcasecmp(tmp,":hierarchy"))
-		return PARSESTATE_HIERARCHY;
-	else if (!strcasecmp(tmp,":degrees"))
-		return PARSESTATE_DEGREES;
-
-
-	return PARSESTATE_UNKNOWN;
-}
-
-void trim(char* argstr) {
-
-	int len=strlen(argstr)+1;
-	char* tmpstr=(char*)malloc(len);
-	char* origtmpstr=tmpstr;
-	int i;
-	int offsetL;
-
-	strcpy(tmpstr,argstr);
-
-	offsetL=0;
-	for (i=0; i<strlen(tmpstr); i++) {
-		if (tmpstr[i]<=0x20 || tmpstr[i]>=0x7f) {
-			offsetL++;
-		}
-		else {
-			break;
-		}
-	}
-	tmpstr+=offsetL;
-
-	for (i=strlen(tmpstr); i>=0; i--) {
-		if (tmpstr[i]<=0x20 || tmpstr[i]>=0x7f) {
-			tmpstr[i]='\0';
-		}
-		else {
-			break;
-		}
-	}
-
-	strcpy(argstr,tmpstr);
-	free (origtmpstr);
-
-}
-
-int nextwht (char* argstr) {
-
-	unsigned int i;
-
-	for (i=0; i<strlen(argstr); i++) {
-		if (argstr[i]<=0x20 || argstr[i]>=0x7f) {
-			break;
-		}
-	}
-
-	return i;
-
-}
-
-int decode_dummyfield(FILE* fp) {
-
-	int  newps;
-	char buf[READ_BUFFERLEN];
-
-	while (!feof(fp)) {
-		fgets(buf,READ_BUFFERLEN,fp);
-		trim(buf);
-		
-		newps=changemode(buf);
-		if (newps) {
-			/* Mode change - leave this decoder */
-			return newps;
-		}
-	}	
-
-	return PARSESTATE_UNKNOWN;
-
-}
-int decode_bonedata(FILE* fp, BONE** bones, int* bone_ctr) {
-
-	int  newps;
-	int  operand;
-	BONE thisbone;
-	char buf[READ_BUFFERLEN];
-	char firstword[READ_BUFFERLEN];
-	char strbuf[READ_BUFFERLEN];
-	BONE* tmpbones;
-
-	while (!feof(fp)) {
-		fgets(buf,READ_BUFFERLEN,fp);
-		trim(buf);
-		newps=changemode(buf);
-		if (newps) {
-			/* Mode change - leave this decoder */
-			return newps;
-		}
-		/* Decode */
-		
-		memset(firstword,0,sizeof(READ_BUFFERLEN));
-		operand=nextwht(buf);
-		memcpy(firstword,buf,operand);
-		firstword[operand]='\0';
-		trim(firstword);
-
-		if (!strcasecmp(firstword,"begin")) {
-			thisbone.id=*bone_ctr;
-			thisbone.direction.x=thisbone.direction.y=thisbone.direction.z=0;
-			thisbone.length=0;
-			thisbone.name=NULL;
-			thisbone.axis.x=thisbone.axis.y=thisbone.axis.z=0;
-			thisbone.xyzflags=0;
-			thisbone.children=NULL;
-			thisbone.children_enum=0;
-			thisbone.parent=NULL;
-		}
-		else if (!strcasecmp(firstword,"end")) {
-			tmpbones=(BONE*)calloc((*bone_ctr)+1,sizeof(BONE));
-			memcpy(tmpbones,(*bones),sizeof(BONE)*(*bone_ctr));
-			free(*bones);
-			tmpbones[(*bone_ctr)++]=thisbone;
-			*bones=tmpbones;
-		}
-		else if (!strcasecmp(firstword,"id")) {
-			/*sscanf(buf+operand,"%d",&(thisbone.id));* - disable, must use internal id now */
-		}
-		else if (!strcasecmp(firstword,"direction")) {
-			sscanf(buf+operand,"%f %f %f",&(thisbone.direction.x),&(thisbone.direction.y),&(thisbone.direction.z));
-		}
-		else if (!strcasecmp(firstword,"axis")) {
-			sscanf(buf+operand,"%f %f %f",&(thisbone.axis.x),&(thisbone.axis.y),&(thisbone.axis.z));
-		}
-		else if (!strcasecmp(firstword,"length")) {
-			sscanf(buf+operand,"%f",&(thisbone.length));
-		}
-		else if (!strcasecmp(firstword,"name")) {
-			strcpy(strbuf,buf+operand);
-			trim(strbuf);
-			thisbone.name=(char*)malloc(strlen(strbuf)+1);
-			strcpy(thisbone.name,strbuf);
-		}
-		else if (!strcasecmp(firstword,"dof")) {
-			strcpy(strbuf,buf+operand);
-			trim(strbuf);
-			thisbone.xyzflags=0;
-			/* Check strbuf for rx ry and rz indicators */
-			if (strstr(strbuf,"rx")) {
-				thisbone.xyzflags|=DOF_FLAG_RX;
-			}
-			if (strstr(strbuf,"ry")) {
-				thisbone.xyzflags|=DOF_FLAG_RY;
-			}
-			if (strstr(strbuf,"rz")) {
-				thisbone.xyzflags|=DOF_FLAG_RZ;
-			}
-		}
-
-	}	
-
-	return PARSESTATE_UNKNOWN;
-
-}
-
-
-int decode_root(FILE* fp, SKELETON* skel) {
-
-	int  newps;
-	int  operand;
-	char buf[READ_BUFFERLEN];
-	char firstword[READ_BUFFERLEN];
-
-	while (!feof(fp)) {
-		fgets(buf,READ_BUFFERLEN,fp);
-		trim(buf);
-		newps=changemode(buf);
-		if (newps) {
-			/* Mode change - leave this decoder */
-			return newps;
-		}
-		/* Decode */
-		
-		memset(firstword,0,sizeof(READ_BUFFERLEN));
-		operand=nextwht(buf);
-		memcpy(firstword,buf,operand);
-		firstword[operand]='\0';
-		trim(firstword);
-
-		if (!strcasecmp(firstword,"orientation")) {
-			sscanf(buf+operand,"%f %f %f",&(skel->init_orientation.x),&(skel->init_orientation.y),&(skel->init_orientation.z));
-		}
-		else if (!strcasecmp(firstword,"position")) {
-			sscanf(buf+operand,"%f %f %f",&(skel->init_position.x),&(skel->init_position.y),&(skel->init_position.z));
-		}
-
-	}	
-
-	return PARSESTATE_UNKNOWN;
-
-}
-
-
-int getboneindex (BONE* bones, int bone_ctr, char* bonename) {
-
-	int boneid;
-
-	for (boneid=0; boneid<bone_ctr; boneid++) {
-		if (!strcasecmp(bones[boneid].name,bonename))
-			break;
-	}
-
-	if (boneid==bone_ctr)
-		return -1;
-	else
-		return boneid;
-
-}
-
-int decode_hierarchy(FILE* fp, BONE* bones, int bone_ctr, SKELETON* skel) {
-
-	int  newps;
-	int  parentid,boneid;
-	int  operand;
-	char buf[READ_BUFFERLEN];
-	char firstword[READ_BUFFERLEN];
-
-	int*	children_enum;
-	BONE***	children;
-
-	skel->bonearray=bones;
-	skel->bonearray_enum=bone_ctr;
-
-	while (!feof(fp)) {
-		fgets(buf,READ_BUFFERLEN,fp);
-		trim(buf);
-		newps=changemode(buf);
-		if (newps) {
-			/* Mode change - leave this decoder */
-			return newps;
-		}
-		/* Decode */
-		memset(firstword,0,sizeof(READ_BUFFERLEN));
-		operand=nextwht(buf);
-		memcpy(firstword,buf,operand);
-		firstword[operand]='\0';
-		trim(firstword);
-
-		if (!strcasecmp("begin",firstword) || !strcasecmp("end",firstword))
-			continue;
-
-		/* Which node? */
-		if (!strcasecmp("root",firstword)) {
-			children=&(skel->children);
-			children_enum=&(skel->children_enum);
-			parentid=-1;
-		}
-		else {
-			parentid=getboneindex(bones,bone_ctr,firstword);
-			if (parentid==-1) {
-				printf("WARNING: Skeleton hierarchy - undefined bone name [%s] as parent\n",firstword);
-				continue;
-			}
-			else {	
-				children=&(bones[parentid].children);
-				children_enum=&(bones[parentid].children_enum);
-			}
-		}
-		/* Add on all specified children */
-		while (1) {
-			memmove(buf,buf+operand,READ_BUFFERLEN-operand);
-			trim(buf);
-			operand=nextwht(buf);
-			memset(firstword,0,sizeof(READ_BUFFERLEN));
-			memcpy(firstword,buf,operand);
-			firstword[operand]='\0';
-			trim(firstword);
-			if (strlen(firstword)==0)
-				break;
-			/* Firstword contains name of child */
-			boneid=getboneindex(bones,bone_ctr,firstword);
-			if (boneid==-1) {
-				printf("WARNING:  Skeleton hierarchy - undefined bone name [%s] as child\n",firstword);
-			}
-			else {
-				*children=(BONE**)realloc(*children,sizeof(BONE*)*((*children_enum)+1));
-				(*children)[(*children_enum)++]=bones+boneid;
-				if (parentid>-1)
-					bones[boneid].parent=bones+parentid;
-				else
-					bones[boneid].parent=NULL;
-			}
-		}
-	}	
-
-	return PARSESTATE_UNKNOWN;
-
-}
-
-void parser_debugskeletonTree(SKELETON* skel) {
-
-	int i=0;
-
-	printf("root\n");
-	for (i=0; i<skel->children_enum; i++) {
-		debugskeletonTree_recur(skel->children[i],1);
-		if (skel->children[i]->parent!=NULL) {
-			printf("Hierarchy FAILED %p\n",skel->children[i]->parent);
-			exit(1);
-		}
-	}
-}
-
-void debugskeletonTree_recur(BONE* bn, int recurctr) {
-
-	int i;
-
-	for (i=0; i<recurctr; i++) {
-		printf("  ");
-	}
-	printf("%s\n",bn->name);
-	for (i=0; i<bn->children_enum; i++) {
-		debugskeletonTree_recur(bn->children[i],recurctr+1);
-		if (bn->children[i]->parent!=bn) {
-			printf("HIERARCHY FAILED 2\n");
-			exit(1);
-		}
-
-	}
-
-}
-
-void parser_free_skeleton(SKELETON* skel) {
-
-	int i=0;
-
-	for (i=0; i<skel->children_enum; i++) {
-		parser_free_skeleton_helper(skel->children[i]);
-	}
-	free(skel->bonearray);
-	free(skel);
-
-}
-
-void parser_free_skeleton_helper(BONE* bn) {
-
-	int i=0;
-
-	for (i=0; i<bn->children_enum; i++) {
-		if (bn->children[i]) {
-			parser_free_skeleton_helper(bn->children[i]);
-		}
-	}
-	free(bn->name);
-
-}
-
-MOCAP*	parser_loadMocap(char* argFilename, SKELETON* skel) {
-
-
-	FILE* fp;					/* file to be parsed */
-	int	  ps;				/* parser state */
-	char  buf [READ_BUFFERLEN];	/* parse buffer */
-	MOCAP* momodel;				/* the skeleton */
-	
-	if (!(fp=fopen(argFilename,"rt")))
-		return NULL;
-
-	momodel=(MOCAP*)calloc(1,sizeof(MOCAP));
-	momodel->bones_orient=NULL;
-	momodel->frames_enum=0;
-	momodel->root_pos=NULL;
-	momodel->root_orient=NULL;
-	
-	ps=PARSESTATE_UNKNOWN;
-	while (!feof(fp)) {
-
-		if (ps==PARSESTATE_UNKNOWN) {
-			fgets(buf,READ_BUFFERLEN,fp);
-			trim(buf);
-			ps=changemode(buf);
-		}
-
-		
-		/* Handle modes */
-		switch (ps) {
-			case PARSESTATE_DEGREES:
-				ps=decode_degrees(fp,momodel,skel);
-				break;
-			default:
-				ps=decode_dummyfield(fp);
-				break;
-		}
-
-	}
-
-	
-	fclose(fp);
-	return momodel;
-
-
-}
-
-
-int decode_degrees(FILE* fp, MOCAP* mocap, SKELETON* skel) {
-
-	int	 frmnum=-1;
-	int  newps;
-	int  boneid;
-	int  operand;
-	char buf[READ_BUFFERLEN];
-	char firstword[READ_BUFFERLEN];
-	int	 psd,idx;
-	float	 r[3];
-
-
-	while (!feof(fp)) {
-		fgets(buf,READ_BUFFERLEN,fp);
-		trim(buf);
-		newps=changemode(buf);
-		if (newps) {
-			/* Mode change - leave this decoder */
-			return newps;
-		}
-		/* Decode */
-		memset(firstword,0,sizeof(READ_BUFFERLEN));
-		operand=nextwht(buf);
-		memcpy(firstword,buf,operand);
-		firstword[operand]='\0';
-		trim(firstword);
-
-		if (atoi(firstword)>0) {
-			/* New frame */
-			frmnum=atoi(firstword);
-			if (frmnum>mocap->frames_enum) {
-				mocap->bones_orient=(POINT3D**)realloc(mocap->bones_orient,sizeof(POINT3D*)*frmnum);
-				mocap->root_orient=(POINT3D*)realloc(mocap->root_orient,sizeof(POINT3D)*frmnum);
-				mocap->root_pos=(POINT3D*)realloc(mocap->root_pos,sizeof(POINT3D)*frmnum);
-				mocap->frames_enum=frmnum;
-				mocap->bones_orient[frmnum-1]=(POINT3D*)calloc(skel->bonearray_enum,sizeof(POINT3D));
-				for (boneid=0; boneid<skel->bonearray_enum; boneid++) {
-					mocap->bones_orient[frmnum-1][boneid].x=0;
-					mocap->bones_orient[frmnum-1][boneid].y=0;
-					mocap->bones_orient[frmnum-1][boneid].z=0;
-				}
-			}
-			continue;
-		}
-		else {
-			if (frmnum==-1) {
-				printf("FATAL:  Data out of sync with frame number\n");
-				return PARSESTATE_UNKNOWN;
-			}
-		}
-
-
-		/* Which node? */
-		if (!strcasecmp("root",firstword)) {
-			sscanf(buf+operand,"%f %f %f %f %f %f\n",
-				&(mocap->root_pos[frmnum-1].x),&(mocap->root_pos[frmnum-1].y),&(mocap->root_pos[frmnum-1].z),
-				&(mocap->root_orient[frmnum-1].x),&(mocap->root_orient[frmnum-1].y),&(mocap->root_orient[frmnum-1].z));
-		}
-		else {
-			boneid=getboneindex(skel->bonearray,skel->bonearray_enum,firstword);
-			if (boneid==-1) {
-				printf("WARNING: MOCAP file - undefined bone name [%s] in datastream\n",firstword);
-				continue;
-			}
-			else {	
-				r[0]=r[1]=r[2]=0;
-				psd=sscanf(buf+operand,"%f %f %f",&(r[0]),&(r[1]),&(r[2]));
-
-				idx=0;
-				if (skel->bonearray[boneid].xyzflags & DOF_FLAG_RX) {
-					mocap->bones_orient[frmnum-1][boneid].x=r[idx++];
-				}
-				if (skel->bonearray[boneid].xyzflags & DOF_FLAG_RY) {
-					mocap->bones_orient[frmnum-1][boneid].y=r[idx++];
-				}
-				if (skel->bonearray[boneid].xyzflags & DOF_FLAG_RZ) {
-					mocap->bones_orient[frmnum-1][boneid].z=r[idx++];
-				}
-				
-			}
-		}
-
-	}	
-
-	return PARSESTATE_UNKNOWN;
-	
-
-}
-
-
-void matrix_transform_affine(double m[4][4],
-							 double x, double y, 
-							 double z, POINT3D* pt) 
-{
-    pt->x = m[0][0]*x + m[0][1]*y + m[0][2]*z + m[0][3];
-    pt->y = m[1][0]*x + m[1][1]*y + m[1][2]*z + m[1][3];
-    pt->z = m[2][0]*x + m[2][1]*y + m[2][2]*z + m[2][3];
-}
-
-
-void rotateVector(POINT3D* v, float a, float b, float c)
-{
-    double Rx[4][4], Ry[4][4], Rz[4][4];
-
-	//Rz is a rotation matrix about Z axis by angle c, same for Ry and Rx
-    rotationZ(Rz, c);
-    rotationY(Ry, b);
-    rotationX(Rx, a);
-
-	//Matrix vector multiplication to generate the output vector v.
-    matrix_transform_affine(Rz, v->x, v->y, v->z, v);
-    matrix_transform_affine(Ry, v->x, v->y, v->z, v);
-    matrix_transform_affine(Rx, v->x, v->y, v->z, v);
-}
-
-void rotationZ(double r[][4], float a)
-{
-    a=a*PI/180.;
-    r[0][0]=cos(a); r[0][1]=-sin(a); r[0][2]=0; r[0][3]=0;
-    r[1][0]=sin(a); r[1][1]=cos(a);  r[1][2]=0; r[1][3]=0;
-    r[2][0]=0;      r[2][1]=0;       r[2][2]=1; r[2][3]=0;
-    r[3][0]=0;      r[3][1]=0;       r[3][2]=0; r[3][3]=1;
-}
-
-void rotationY(double r[][4], float a)
-{
-    a=a*PI/180.;
-    r[0][0]=cos(a);  r[0][1]=0;       r[0][2]=sin(a); r[0][3]=0;
-    r[1][0]=0;       r[1][1]=1;       r[1][2]=0;      r[1][3]=0;
-    r[2][0]=-sin(a); r[2][1]=0;       r[2][2]=cos(a); r[2][3]=0;
-    r[3][0]=0;       r[3][1]=0;       r[3][2]=0;      r[3][3]=1;
-}
-
-void rotationX(double r[][4], float a)
-{
-    a=a*PI/180.;
-    r[0][0]=1;       r[0][1]=0;       r[0][2]=0;       r[0][3]=0;
-    r[1][0]=0;       r[1][1]=cos(a);  r[1][2]=-sin(a); r[1][3]=0;
-    r[2][0]=0;       r[2][1]=sin(a);  r[2][2]=cos(a);  r[2][3]=0;
-    r[3][0]=0;       r[3][1]=0;       r[3][2]=0;       r[3][3]=1;
-}
-
-void parser_free_mocap(MOCAP* mocap) {
-
-	int i;
-
-	free (mocap->root_orient);
-	free (mocap->root_pos);
-	for (i=0; i<mocap->frames_enum; i++) {
-		free (mocap->bones_orient[i]);
-	}
-	free (mocap->bones_orient);
-
-
-
-}
-
+/*******************************************************\
+*                                                       *
+*  PARSER.C                                             *
+*  Acclaim Motion Capture (ASF/AMC) Parser Library      *
+*                                                       *
+*  Parses Skeleton (ASF) and motion capture (AMC) files *
+*  Written as a resource for CM20219 coursework         *
+*                                                       *
+*  (c) John Collomosse, University of Bath              *
+*  September 2008                                       *
+*                                                       *
+\*******************************************************/
+
+/* CM20219 students - You should not need to edit/view 
+   this file for your coursework */
+
+#include <limits.h>
+#include "parser.h"
+#include "mapfile.h"
+#include "threadpool.h"
+#include "numparse.h"
+#include "arena.h"
+#include "euler.h"
+
+/* ASF/AMC parser states */
+#define PARSESTATE_UNKNOWN	(0)
+#define PARSESTATE_VERSION	(1)
+#define PARSESTATE_NAME		(2)
+#define PARSESTATE_UNITS	(3)
+#define PARSESTATE_DOCS		(4)
+#define PARSESTATE_ROOT		(5)
+#define PARSESTATE_BONEDATA	(6)
+#define PARSESTATE_HIERARCHY (7)
+#define PARSESTATE_DEGREES  (8)
+
+/* Buffer size for reading each line of ASF/AMC file */
+#define READ_BUFFERLEN		(1024)
+
+/* Number of bones allocated for a skeleton before geometric growth kicks in */
+#define SKELETON_INITIAL_BONES	(32)
+
+/* Number of frames allocated for a clip before geometric growth kicks in */
+#define MOCAP_INITIAL_FRAMES	(256)
+#define INDEX_MAX_FRAMES		(1<<24)		/* Frame numbers above this are taken for a corrupt line by parser_indexMocap */
+
+/* Size of the read window of an AMCSTREAM - no line may be longer than this */
+#define STREAM_BUFFERLEN	(64*1024)
+
+/* Files smaller than this are parsed on the calling thread by parser_loadMocapParallel */
+#define PARALLEL_MINBYTES		(256*1024)
+
+/* parser_loadMocapParallel cuts the :degrees section into this many chunks per thread to balance the load */
+#define PARALLEL_CHUNKSPERTHREAD	(4)
+
+/* Output buffer of parser_saveSkeleton/parser_saveMocap - the file is written in fwrites of this size */
+#define WRITE_BUFFERLEN		(256*1024)
+
+/* 64 bit file positioning for parser_seekMocapStream and parser_followMocap */
+#ifdef WIN32
+	#define fseek64	_fseeki64
+	#define ftell64	_ftelli64
+#else
+	#define fseek64	fseeko
+	#define ftell64	ftello
+#endif
+
+/* Character class used by the tokenizer to delimit words */
+#define ISWHT(c)	((unsigned char)(c)<=0x20 || (unsigned char)(c)>=0x7f)
+
+/* Words that mean something inside an ASF/AMC section (see keyword) */
+#define KEYWORD_NONE		(0)
+#define KEYWORD_BEGIN		(1)
+#define KEYWORD_END			(2)
+#define KEYWORD_ID			(3)
+#define KEYWORD_NAME		(4)
+#define KEYWORD_DIRECTION	(5)
+#define KEYWORD_LENGTH		(6)
+#define KEYWORD_AXIS		(7)
+#define KEYWORD_DOF			(8)
+#define KEYWORD_ROOT		(9)
+#define KEYWORD_ORIENTATION	(10)
+#define KEYWORD_POSITION	(11)
+
+/* A word or part of a line as (pointer, length) into the read buffer or mapping - never copied or null terminated */
+typedef struct _span {
+
+	const char*	p;
+	int			len;
+
+} SPAN;
+
+/* A run of whole frames from an AMC :degrees section, decoded by one parser_loadMocapParallel job */
+typedef struct _amcchunk {
+
+	const char*	begin;			/* First byte - always the start of a frame number line */
+	const char*	end;			/* One past the last byte */
+	MOCAP*		mocap;			/* Frames are written straight into their preallocated slots */
+	SKELETON*	skel;
+	int			firstframe;		/* Lowest and highest frame numbers seen (1 based) */
+	int			lastframe;
+	int			frames;			/* Number of frame number lines seen */
+	int			failed;			/* Set if the chunk needs the serial loader (keyword, bad order, sync error) */
+
+} AMCCHUNK;
+
+/* Buffered output for the ASF/AMC writers - numbers are formatted straight into buf */
+typedef struct _writer {
+
+	FILE*		fp;
+	char*		buf;
+	int			len;			/* Bytes waiting in buf */
+	int			failed;			/* Set by the first fwrite that comes up short */
+
+} WRITER;
+
+/* Prototypes for internal functions */
+
+const char*	nextline	(const char*, const char*, SPAN*, SPAN*);	/* Split the next line into its first word and the rest, returns the start of the line after */
+int		readline		(FILE*, char*, SPAN*, SPAN*);	/* fgets a line into the buffer and split it as nextline - 0 at end of file */
+int		nextword		(SPAN*, SPAN*);		/* Take the next word off the front of a span - 0 if there is none */
+void	span_trim		(SPAN*);			/* Drop whitespace off both ends of a span */
+int		span_contains	(SPAN, const char*);	/* Non zero if a string occurs in a span */
+int		changemode_span	(SPAN);				/* Parser state a section keyword switches to, PARSESTATE_UNKNOWN for any other word */
+int		keyword			(SPAN);				/* KEYWORD_ code of a word */
+int		framenumber		(SPAN);				/* Value of a frame number word, 0 if the word isn't one */
+int		scanfloats		(const char*, const char*, float*, int);	/* Parse up to N floats from a byte range */
+
+int		decode_bonedata	(FILE*, ARENA*, BONE**, int*, int*);	/* Decoder for ASF :bonedata state */
+int		decode_dummyfield(FILE*);							/* Decoder for ASF/AMC dummy/invalid state */
+int		decode_hierarchy(FILE*, BONE*, int, SKELETON*);		/* Decoder for ASF :hierarchy state */
+void	bone_addchildren(SKELETON*, BONE***, int*, int*, int);	/* Append bones to a children array */
+unsigned int boneindex_hash (const char*, int);				/* Case insensitive hash of a bone name */
+void	debugskeletonTree_recur(BONE* bn, int recurctr);	/* Print skeleton hierarchy for debugging */
+void	parser_free_skeleton_helper(BONE* bn);				/* Recursive helper for freeing skeleton structure */
+int		decode_root(FILE* fp, SKELETON* skel);				/* Decoder for ASF :root state */
+int		decode_degrees(FILE* fp, MOCAP* mocap, SKELETON* skel, int* missing);/* Decoder for AMC :degrees state, adding frames skipped over to *missing */
+int		decode_degreesline(SPAN, SPAN, MOCAP*, SKELETON*, int*);	/* In place decoder for one AMC :degrees line */
+void	decode_degreesvalues(SPAN, SPAN, SKELETON*, POINT3D*, POINT3D*, POINT3D*);	/* Decode one root/bone line into a single frame */
+int		stream_nextline(AMCSTREAM*, SPAN*, SPAN*);	/* Next line of a stream, 0 at end of file */
+void	follow_line(AMCFOLLOW*, SPAN, SPAN);		/* Feed one complete line to a follower */
+void	follow_restart(AMCFOLLOW*);					/* Forget everything read, e.g. after the file was truncated */
+void	mocap_growframes(MOCAP* mocap, int frmnum);	/* Extend mocap to hold frames 1 to frmnum */
+void	mocap_setcapacity(MOCAP* mocap, int frames);			/* Resize the motion arrays to hold exactly this many frames */
+void	decode_degreeschunk(void* chunk);						/* Thread pool job decoding one AMCCHUNK */
+void	mocap_zeroframes(MOCAP* mocap, int first, int last);	/* Zero frames first to last-1 (0 based) */
+int		writer_open		(WRITER*, char*);			/* Create the file and the buffer - 0 on failure */
+int		writer_close	(WRITER*);					/* Flush and close - 0 if anything failed to write */
+void	writer_flush	(WRITER*);					/* Empty the buffer into the file */
+void	writer_text		(WRITER*, const char*);		/* Append a string */
+void	writer_int		(WRITER*, int);				/* Append a decimal integer */
+void	writer_floats	(WRITER*, const float*, int);	/* Append space separated shortest round trip floats */
+void	bone_asfdirection(BONE*, POINT3D*);			/* Direction to write in the ASF file - asfdirection, or direction rotated back if it was edited */
+void	vector_unrotate	(double[4][4], double[4][4], double[4][4], double*);	/* v = Rz.Ry.Rx.v */
+float	float_step		(float, int);				/* The float k representable values away */
+void	rotateVector(POINT3D*, float, float, float);	/* Rotate vector by X, Y, Z Euler angles */
+
+SKELETON* parser_loadSkeleton(char* argFilename) {
+
+	FILE* fp;					/* file to be parsed */
+	int	  ps;				/* parser state */
+	char  buf [READ_BUFFERLEN];	/* parse buffer */
+	SPAN  word, rest;			/* first word of the line and what follows it */
+	SKELETON* skel;				/* the skeleton */
+	ARENA*		arena;			/* everything the skeleton points to */
+	BONE*		bones;			/* bone collection */
+	int			bone_enum;		/* count of bones in collection */
+	int			bone_alloc;		/* room in bones */
+	POINT3D*	angles;			/* -axis of every bone, to rotate the directions by */
+	POINT3D*	directions;
+	int		i;
+	
+	if (!(fp=fopen(argFilename,"rt")))
+		return NULL;
+
+	/* The skeleton lives in its own arena so parser_free_skeleton is a handful of frees */
+	arena=arena_create(0);
+	skel=(SKELETON*)arena_calloc(arena,1,sizeof(SKELETON));
+	skel->arena=arena;
+	skel->children_enum=0;
+	skel->children=NULL;
+	skel->bonearray=NULL;
+
+	bones=NULL;
+	bone_enum=0;
+	bone_alloc=0;
+	
+	ps=PARSESTATE_UNKNOWN;
+	while (1) {
+
+		if (ps==PARSESTATE_UNKNOWN) {
+			if (!readline(fp,buf,&word,&rest))
+				break;
+			ps=changemode_span(word);
+		}
+
+		
+		/* Handle modes */
+		switch (ps) {
+			case PARSESTATE_BONEDATA:
+				ps=decode_bonedata(fp,arena,&bones,&bone_enum,&bone_alloc);
+				break;
+			case PARSESTATE_HIERARCHY:
+				ps=decode_hierarchy(fp,bones,bone_enum,skel);
+				break;
+			case PARSESTATE_ROOT:
+				ps=decode_root(fp,skel);
+				break;
+			default:
+				ps=decode_dummyfield(fp);
+				break;
+		}
+
+	}
+
+	
+	fclose(fp);
+
+	/* A skeleton without a :hierarchy section never had its bones attached */
+	if (!skel->bonearray && bones) {
+		skel->bonearray=bones;
+		skel->bonearray_enum=bone_enum;
+		parser_indexbones(skel);
+	}
+
+	/* Rewrite the bone direction vectors (which are in global i.e. root frame coords) to the local/axis coord system
+	   which is more convenient when performing recursion later on */
+
+	if (skel->bonearray_enum) {
+		angles=(POINT3D*)malloc(sizeof(POINT3D)*skel->bonearray_enum*2);
+		directions=angles+skel->bonearray_enum;
+		for (i=0; i<skel->bonearray_enum; i++) {
+			skel->bonearray[i].asfdirection=skel->bonearray[i].direction;
+			directions[i]=skel->bonearray[i].direction;
+			angles[i].x=-skel->bonearray[i].axis.x;
+			angles[i].y=-skel->bonearray[i].axis.y;
+			angles[i].z=-skel->bonearray[i].axis.z;
+		}
+		euler_rotatevectors(angles, skel->bonearray_enum, EULER_ASF, directions);
+		for (i=0; i<skel->bonearray_enum; i++)
+			skel->bonearray[i].direction=directions[i];
+		free(angles);
+	}
+
+	return skel;
+
+}
+
+const char* nextline(const char* p, const char* end, SPAN* word, SPAN* rest) {
+
+	const char* eol;
+
+	/* Delimit the line and its first word without copying anything */
+	eol=(const char*)memchr(p,'\n',end-p);
+	if (!eol)
+		eol=end;
+
+	rest->p=p;
+	rest->len=eol-p;
+	nextword(rest,word);
+
+	return (eol<end) ? eol+1 : end;
+
+}
+
+int readline(FILE* fp, char* buf, SPAN* word, SPAN* rest) {
+
+	if (!fgets(buf,READ_BUFFERLEN,fp))
+		return 0;
+
+	nextline(buf,buf+strlen(buf),word,rest);
+
+	return 1;
+
+}
+
+int nextword(SPAN* rest, SPAN* word) {
+
+	const char* end=rest->p+rest->len;
+
+	word->p=rest->p;
+	while (word->p<end && ISWHT(*(word->p)))
+		word->p++;
+	word->len=0;
+	while (word->p+word->len<end && !ISWHT(word->p[word->len]))
+		word->len++;
+
+	rest->p=word->p+word->len;
+	rest->len=end-rest->p;
+
+	return word->len>0;
+
+}
+
+void span_trim(SPAN* s) {
+
+	while (s->len && ISWHT(*(s->p))) {
+		s->p++;
+		s->len--;
+	}
+	while (s->len && ISWHT(s->p[s->len-1]))
+		s->len--;
+
+}
+
+int span_contains(SPAN s, const char* str) {
+
+	int n=strlen(str);
+	int i;
+
+	for (i=0; i+n<=s.len; i++) {
+		if (!memcmp(s.p+i,str,n))
+			return 1;
+	}
+
+	return 0;
+
+}
+
+/* Length and one character pick the only candidate, one compare confirms it */
+#define SPAN_IS(w,k)	(!strncasecmp((w).p,(k),(w).len))
+
+int changemode_span (SPAN word) {
+
+	/* Only keywords start with a colon, don't bother comparing anything else */
+	if (word.len<2 || word.p[0]!=':')
+		return PARSESTATE_UNKNOWN;
+
+	switch (word.len) {
+		case 5:
+			if (SPAN_IS(word,":name"))
+				return PARSESTATE_NAME;
+			if (SPAN_IS(word,":root"))
+				return PARSESTATE_ROOT;
+			break;
+		case 6:
+			if (SPAN_IS(word,":units"))
+				return PARSESTATE_UNITS;
+			break;
+		case 8:
+			if (tolower((unsigned char)word.p[1])=='v' && SPAN_IS(word,":version"))
+				return PARSESTATE_VERSION;
+			if (SPAN_IS(word,":degrees"))
+				return PARSESTATE_DEGREES;
+			break;
+		case 9:
+			if (SPAN_IS(word,":bonedata"))
+				return PARSESTATE_BONEDATA;
+			break;
+		case 10:
+			if (SPAN_IS(word,":hierarchy"))
+				return PARSESTATE_HIERARCHY;
+			break;
+		case 14:
+			if (SPAN_IS(word,":documentation"))
+				return PARSESTATE_DOCS;
+			break;
+	}
+
+	return PARSESTATE_UNKNOWN;
+
+}
+
+int keyword (SPAN word) {
+
+	switch (word.len) {
+		case 2:
+			if (SPAN_IS(word,"id"))
+				return KEYWORD_ID;
+			break;
+		case 3:
+			if (tolower((unsigned char)word.p[0])=='e' && SPAN_IS(word,"end"))
+				return KEYWORD_END;
+			if (SPAN_IS(word,"dof"))
+				return KEYWORD_DOF;
+			break;
+		case 4:
+			switch (tolower((unsigned char)word.p[0])) {
+				case 'n':	return SPAN_IS(word,"name") ? KEYWORD_NAME : KEYWORD_NONE;
+				case 'a':	return SPAN_IS(word,"axis") ? KEYWORD_AXIS : KEYWORD_NONE;
+				case 'r':	return SPAN_IS(word,"root") ? KEYWORD_ROOT : KEYWORD_NONE;
+			}
+			break;
+		case 5:
+			if (SPAN_IS(word,"begin"))
+				return KEYWORD_BEGIN;
+			break;
+		case 6:
+			if (SPAN_IS(word,"length"))
+				return KEYWORD_LENGTH;
+			break;
+		case 8:
+			if (SPAN_IS(word,"position"))
+				return KEYWORD_POSITION;
+			break;
+		case 9:
+			if (SPAN_IS(word,"direction"))
+				return KEYWORD_DIRECTION;
+			break;
+		case 11:
+			if (SPAN_IS(word,"orientation"))
+				return KEYWORD_ORIENTATION;
+			break;
+	}
+
+	return KEYWORD_NONE;
+
+}
+
+int decode_dummyfield(FILE* fp) {
+
+	int  newps;
+	char buf[READ_BUFFERLEN];
+	SPAN word, rest;
+
+	while (readline(fp,buf,&word,&rest)) {
+		newps=changemode_span(word);
+		if (newps) {
+			/* Mode change - leave this decoder */
+			return newps;
+		}
+	}	
+
+	return PARSESTATE_UNKNOWN;
+
+}
+int decode_bonedata(FILE* fp, ARENA* arena, BONE** bones, int* bone_ctr, int* bone_alloc) {
+
+	int  newps;
+	BONE thisbone;
+	char buf[READ_BUFFERLEN];
+	SPAN word, rest;
+	BONE* tmpbones;
+
+	while (readline(fp,buf,&word,&rest)) {
+		newps=changemode_span(word);
+		if (newps) {
+			/* Mode change - leave this decoder */
+			return newps;
+		}
+		/* Decode */
+
+		switch (keyword(word)) {
+			case KEYWORD_BEGIN:
+				thisbone.id=*bone_ctr;
+				thisbone.direction.x=thisbone.direction.y=thisbone.direction.z=0;
+				thisbone.length=0;
+				thisbone.name=NULL;
+				thisbone.axis.x=thisbone.axis.y=thisbone.axis.z=0;
+				thisbone.xyzflags=0;
+				thisbone.children=NULL;
+				thisbone.children_enum=0;
+				thisbone.parent=NULL;
+				break;
+			case KEYWORD_END:
+				if (*bone_ctr==*bone_alloc) {
+					/* Grow geometrically - the old array is simply left in the arena */
+					*bone_alloc=(*bone_alloc) ? (*bone_alloc)*2 : SKELETON_INITIAL_BONES;
+					tmpbones=(BONE*)arena_alloc(arena,sizeof(BONE)*(*bone_alloc));
+					if (*bone_ctr)
+						memcpy(tmpbones,(*bones),sizeof(BONE)*(*bone_ctr));
+					*bones=tmpbones;
+				}
+				(*bones)[(*bone_ctr)++]=thisbone;
+				break;
+			case KEYWORD_ID:
+				/* ignored, must use internal id now */
+				break;
+			case KEYWORD_DIRECTION:
+				scanfloats(rest.p,rest.p+rest.len,&(thisbone.direction.x),3);
+				break;
+			case KEYWORD_AXIS:
+				scanfloats(rest.p,rest.p+rest.len,&(thisbone.axis.x),3);
+				break;
+			case KEYWORD_LENGTH:
+				scanfloats(rest.p,rest.p+rest.len,&(thisbone.length),1);
+				break;
+			case KEYWORD_NAME:
+				span_trim(&rest);
+				thisbone.name=arena_strndup(arena,rest.p,rest.len);
+				break;
+			case KEYWORD_DOF:
+				/* Check the rest of the line for rx ry and rz indicators */
+				thisbone.xyzflags=0;
+				if (span_contains(rest,"rx")) {
+					thisbone.xyzflags|=DOF_FLAG_RX;
+				}
+				if (span_contains(rest,"ry")) {
+					thisbone.xyzflags|=DOF_FLAG_RY;
+				}
+				if (span_contains(rest,"rz")) {
+					thisbone.xyzflags|=DOF_FLAG_RZ;
+				}
+				break;
+		}
+
+	}	
+
+	return PARSESTATE_UNKNOWN;
+
+}
+
+
+int decode_root(FILE* fp, SKELETON* skel) {
+
+	int  newps;
+	char buf[READ_BUFFERLEN];
+	SPAN word, rest;
+
+	while (readline(fp,buf,&word,&rest)) {
+		newps=changemode_span(word);
+		if (newps) {
+			/* Mode change - leave this decoder */
+			return newps;
+		}
+		/* Decode */
+
+		switch (keyword(word)) {
+			case KEYWORD_ORIENTATION:
+				scanfloats(rest.p,rest.p+rest.len,&(skel->init_orientation.x),3);
+				break;
+			case KEYWORD_POSITION:
+				scanfloats(rest.p,rest.p+rest.len,&(skel->init_position.x),3);
+				break;
+		}
+
+	}	
+
+	return PARSESTATE_UNKNOWN;
+
+}
+
+
+unsigned int boneindex_hash (const char* name, int len) {
+
+	unsigned int h=2166136261u;		/* FNV-1a over the lower cased name */
+	int i;
+
+	for (i=0; i<len; i++) {
+		h^=(unsigned char)tolower((unsigned char)name[i]);
+		h*=16777619u;
+	}
+
+	return h;
+
+}
+
+void parser_indexbones(SKELETON* skel) {
+
+	BONEINDEX* idx=&(skel->bonenames);
+	unsigned int slot,mask;
+	int i;
+
+	/* Keep the table at most half full so probe sequences stay short */
+	idx->slots_enum=8;
+	while (idx->slots_enum<skel->bonearray_enum*2)
+		idx->slots_enum*=2;
+
+	/* An old table in an arena is just left behind */
+	if (skel->arena)
+		idx->slots=(int*)arena_alloc(skel->arena,sizeof(int)*idx->slots_enum);
+	else {
+		free(idx->slots);
+		idx->slots=(int*)malloc(sizeof(int)*idx->slots_enum);
+	}
+	for (i=0; i<idx->slots_enum; i++)
+		idx->slots[i]=-1;
+
+	mask=idx->slots_enum-1;
+	for (i=0; i<skel->bonearray_enum; i++) {
+		if (!skel->bonearray[i].name)
+			continue;
+		/* Duplicate names resolve to the first bone, as the old linear search did */
+		if (parser_findbone(skel,skel->bonearray[i].name)!=-1)
+			continue;
+		slot=boneindex_hash(skel->bonearray[i].name,strlen(skel->bonearray[i].name))&mask;
+		while (idx->slots[slot]!=-1)
+			slot=(slot+1)&mask;
+		idx->slots[slot]=i;
+	}
+
+}
+
+int parser_findbone (SKELETON* skel, const char* name) {
+
+	return parser_findbone_span(skel,name,strlen(name));
+
+}
+
+int parser_findbone_span (SKELETON* skel, const char* name, int len) {
+
+	BONEINDEX* idx=&(skel->bonenames);
+	unsigned int slot,mask;
+	int boneid;
+
+	if (!idx->slots)
+		return -1;
+
+	mask=idx->slots_enum-1;
+	for (slot=boneindex_hash(name,len)&mask; (boneid=idx->slots[slot])!=-1; slot=(slot+1)&mask) {
+		if (!strncasecmp(skel->bonearray[boneid].name,name,len) && skel->bonearray[boneid].name[len]=='\0')
+			return boneid;
+	}
+
+	return -1;
+
+}
+
+int decode_hierarchy(FILE* fp, BONE* bones, int bone_ctr, SKELETON* skel) {
+
+	int  newps;
+	int  parentid,boneid;
+	char buf[READ_BUFFERLEN];
+	SPAN word, rest;
+
+	int*	children_enum;
+	BONE***	children;
+	int		childids[READ_BUFFERLEN/2];	/* children named on the current line - at most one per two characters */
+	int		childids_enum;
+
+	skel->bonearray=bones;
+	skel->bonearray_enum=bone_ctr;
+	parser_indexbones(skel);
+
+	while (readline(fp,buf,&word,&rest)) {
+		newps=changemode_span(word);
+		if (newps) {
+			/* Mode change - leave this decoder */
+			return newps;
+		}
+		/* Decode */
+		if (!word.len)
+			continue;
+
+		/* Which node? */
+		switch (keyword(word)) {
+			case KEYWORD_BEGIN:
+			case KEYWORD_END:
+				continue;
+			case KEYWORD_ROOT:
+				children=&(skel->children);
+				children_enum=&(skel->children_enum);
+				parentid=-1;
+				break;
+			default:
+				parentid=parser_findbone_span(skel,word.p,word.len);
+				if (parentid==-1) {
+					printf("WARNING: Skeleton hierarchy - undefined bone name [%.*s] as parent\n",word.len,word.p);
+					continue;
+				}
+				children=&(bones[parentid].children);
+				children_enum=&(bones[parentid].children_enum);
+				break;
+		}
+		/* Add on all specified children */
+		childids_enum=0;
+		while (nextword(&rest,&word)) {
+			/* Word is the name of a child */
+			boneid=parser_findbone_span(skel,word.p,word.len);
+			if (boneid==-1) {
+				printf("WARNING:  Skeleton hierarchy - undefined bone name [%.*s] as child\n",word.len,word.p);
+			}
+			else {
+				childids[childids_enum++]=boneid;
+				if (parentid>-1)
+					bones[boneid].parent=bones+parentid;
+				else
+					bones[boneid].parent=NULL;
+			}
+		}
+		bone_addchildren(skel,children,children_enum,childids,childids_enum);
+	}	
+
+	return PARSESTATE_UNKNOWN;
+
+}
+
+void bone_addchildren(SKELETON* skel, BONE*** children, int* children_enum, int* ids, int ids_enum) {
+
+	BONE**	grown;
+	int		i;
+
+	if (!ids_enum)
+		return;
+
+	/* Sized for the whole line at once - a parent named on a second line just gets a bigger copy */
+	grown=(BONE**)arena_alloc(skel->arena,sizeof(BONE*)*((*children_enum)+ids_enum));
+	if (*children_enum)
+		memcpy(grown,*children,sizeof(BONE*)*(*children_enum));
+	for (i=0; i<ids_enum; i++)
+		grown[(*children_enum)++]=skel->bonearray+ids[i];
+	*children=grown;
+
+}
+
+void parser_debugskeletonTree(SKELETON* skel) {
+
+	int i=0;
+
+	printf("root\n");
+	for (i=0; i<skel->children_enum; i++) {
+		debugskeletonTree_recur(skel->children[i],1);
+		if (skel->children[i]->parent!=NULL) {
+			printf("Hierarchy FAILED %p\n",skel->children[i]->parent);
+			exit(1);
+		}
+	}
+}
+
+void debugskeletonTree_recur(BONE* bn, int recurctr) {
+
+	int i;
+
+	for (i=0; i<recurctr; i++) {
+		printf("  ");
+	}
+	printf("%s\n",bn->name);
+	for (i=0; i<bn->children_enum; i++) {
+		debugskeletonTree_recur(bn->children[i],recurctr+1);
+		if (bn->children[i]->parent!=bn) {
+			printf("HIERARCHY FAILED 2\n");
+			exit(1);
+		}
+
+	}
+
+}
+
+void parser_free_skeleton(SKELETON* skel) {
+
+	int i=0;
+
+	/* Everything, the SKELETON included, came from the arena */
+	if (skel->arena) {
+		arena_destroy(skel->arena);
+		return;
+	}
+
+	for (i=0; i<skel->children_enum; i++) {
+		parser_free_skeleton_helper(skel->children[i]);
+	}
+	free(skel->bonearray);
+	free(skel->bonenames.slots);
+	free(skel);
+
+}
+
+void parser_free_skeleton_helper(BONE* bn) {
+
+	int i=0;
+
+	for (i=0; i<bn->children_enum; i++) {
+		if (bn->children[i]) {
+			parser_free_skeleton_helper(bn->children[i]);
+		}
+	}
+	free(bn->name);
+
+}
+
+MOCAP*	parser_loadMocap(char* argFilename, SKELETON* skel) {
+
+
+	FILE* fp;					/* file to be parsed */
+	int	  ps;				/* parser state */
+	char  buf [READ_BUFFERLEN];	/* parse buffer */
+	SPAN  word, rest;			/* first word of the line and what follows it */
+	MOCAP* momodel;				/* the skeleton */
+	int	  missing=0;			/* frames the frame numbers jumped over */
+	
+	if (!(fp=fopen(argFilename,"rt")))
+		return NULL;
+
+	momodel=(MOCAP*)calloc(1,sizeof(MOCAP));
+	momodel->bones_orient=NULL;
+	momodel->frames_enum=0;
+	momodel->root_pos=NULL;
+	momodel->root_orient=NULL;
+	momodel->bones_enum=skel->bonearray_enum;
+	momodel->frames_alloc=0;
+	momodel->bones_slab=NULL;
+	
+	ps=PARSESTATE_UNKNOWN;
+	while (1) {
+
+		if (ps==PARSESTATE_UNKNOWN) {
+			if (!readline(fp,buf,&word,&rest))
+				break;
+			ps=changemode_span(word);
+		}
+
+		
+		/* Handle modes */
+		switch (ps) {
+			case PARSESTATE_DEGREES:
+				ps=decode_degrees(fp,momodel,skel,&missing);
+				break;
+			default:
+				ps=decode_dummyfield(fp);
+				break;
+		}
+
+	}
+
+	
+	fclose(fp);
+
+	/* Give back the spare room left over from growing during the parse */
+	if (momodel->frames_enum)
+		mocap_setcapacity(momodel,momodel->frames_enum);
+
+	if (missing)
+		printf("WARNING: MOCAP file - %d frame(s) missing from the sequence\n",missing);
+
+	return momodel;
+
+
+}
+
+
+int decode_degrees(FILE* fp, MOCAP* mocap, SKELETON* skel, int* missing) {
+
+	int	 frmnum=-1;
+	int  newps;
+	int  before;
+	char buf[READ_BUFFERLEN];
+	SPAN word, rest;
+
+
+	while (readline(fp,buf,&word,&rest)) {
+		if (!word.len)
+			continue;
+		newps=changemode_span(word);
+		if (newps) {
+			/* Mode change - leave this decoder */
+			return newps;
+		}
+		/* Decode - a frame number more than one past the last leaves the frames in between zero */
+		before=mocap->frames_enum;
+		if (!decode_degreesline(word,rest,mocap,skel,&frmnum))
+			return PARSESTATE_UNKNOWN;
+		if (mocap->frames_enum>before+1)
+			*missing+=mocap->frames_enum-before-1;
+
+	}	
+
+	return PARSESTATE_UNKNOWN;
+	
+
+}
+
+void mocap_growframes(MOCAP* mocap, int frmnum) {
+
+	int capacity;
+
+	/* Grow geometrically so that parsing N frames costs O(N) copying in total */
+	if (frmnum>mocap->frames_alloc) {
+		capacity=mocap->frames_alloc ? mocap->frames_alloc*2 : MOCAP_INITIAL_FRAMES;
+		if (capacity<frmnum)
+			capacity=frmnum;
+		mocap_setcapacity(mocap,capacity);
+	}
+
+	/* Zero every new frame, including any skipped over by a gap in the frame numbers */
+	mocap_zeroframes(mocap,mocap->frames_enum,frmnum);
+	mocap->frames_enum=frmnum;
+
+}
+
+void mocap_setcapacity(MOCAP* mocap, int frames) {
+
+	int i;
+
+	if (frames<1)
+		frames=1;
+
+	mocap->bones_slab=(POINT3D*)realloc(mocap->bones_slab,sizeof(POINT3D)*(size_t)frames*(mocap->bones_enum ? mocap->bones_enum : 1));
+	mocap->bones_orient=(POINT3D**)realloc(mocap->bones_orient,sizeof(POINT3D*)*frames);
+	mocap->root_orient=(POINT3D*)realloc(mocap->root_orient,sizeof(POINT3D)*frames);
+	mocap->root_pos=(POINT3D*)realloc(mocap->root_pos,sizeof(POINT3D)*frames);
+	mocap->frames_alloc=frames;
+
+	/* The slab may have moved, so point every frame back into it */
+	for (i=0; i<frames; i++)
+		mocap->bones_orient[i]=mocap->bones_slab+(size_t)i*mocap->bones_enum;
+
+}
+
+
+MOCAP*	parser_loadMocapMapped(char* argFilename, SKELETON* skel) {
+
+	MAPPEDFILE*	mf;			/* mapped copy of the file to be parsed */
+	MOCAP*		momodel;	/* the motion */
+	int			ps;			/* parser state */
+	int			newps;
+	int			frmnum;		/* current frame number (1 based), -1 before the first */
+	const char*	p;			/* start of the current line */
+	const char*	end;		/* one past the last byte of the file */
+	SPAN		word;		/* first word on the current line */
+	SPAN		rest;		/* and the rest of the line */
+	int			before;		/* frames_enum before the current line */
+	int			missing;	/* frames the frame numbers jumped over */
+
+	if (!(mf=mapfile_open(argFilename)))
+		return NULL;
+
+	momodel=(MOCAP*)calloc(1,sizeof(MOCAP));
+	momodel->bones_orient=NULL;
+	momodel->frames_enum=0;
+	momodel->root_pos=NULL;
+	momodel->root_orient=NULL;
+	momodel->bones_enum=skel->bonearray_enum;
+	momodel->frames_alloc=0;
+	momodel->bones_slab=NULL;
+
+	ps=PARSESTATE_UNKNOWN;
+	frmnum=-1;
+	missing=0;
+
+	p=mf->data;
+	end=p+mf->size;
+	while (p<end) {
+
+		p=nextline(p,end,&word,&rest);
+		if (!word.len)
+			continue;
+
+		newps=changemode_span(word);
+		if (newps) {
+			/* Mode change - a new :degrees section starts before its first frame */
+			ps=newps;
+			frmnum=-1;
+			continue;
+		}
+
+		/* Everything outside of :degrees is skipped, as decode_dummyfield would */
+		if (ps!=PARSESTATE_DEGREES)
+			continue;
+
+		/* A frame number more than one past the last leaves the frames in between zero */
+		before=momodel->frames_enum;
+		if (!decode_degreesline(word,rest,momodel,skel,&frmnum))
+			ps=PARSESTATE_UNKNOWN;
+		if (momodel->frames_enum>before+1)
+			missing+=momodel->frames_enum-before-1;
+
+	}
+
+	mapfile_close(mf);
+
+	/* Give back the spare room left over from growing during the parse */
+	if (momodel->frames_enum)
+		mocap_setcapacity(momodel,momodel->frames_enum);
+
+	if (missing)
+		printf("WARNING: MOCAP file - %d frame(s) missing from the sequence\n",missing);
+
+	return momodel;
+
+}
+
+
+int decode_degreesline(SPAN word, SPAN rest, MOCAP* mocap, SKELETON* skel, int* frmnum) {
+
+	int n;
+
+	if ((n=framenumber(word))) {
+		/* New frame */
+		*frmnum=n;
+		if (n>mocap->frames_enum)
+			mocap_growframes(mocap,n);
+		return 1;
+	}
+
+	if (*frmnum==-1) {
+		printf("FATAL:  Data out of sync with frame number\n");
+		return 0;
+	}
+
+	decode_degreesvalues(word,rest,skel,mocap->root_pos+*frmnum-1,mocap->root_orient+*frmnum-1,mocap->bones_orient[*frmnum-1]);
+
+	return 1;
+
+}
+
+
+void decode_degreesvalues(SPAN word, SPAN rest, SKELETON* skel, POINT3D* rootpos, POINT3D* rootorient, POINT3D* bones) {
+
+	int			boneid;
+	int			n,i,idx;
+	float		r[6];
+
+	/* Which node? */
+	if (keyword(word)==KEYWORD_ROOT) {
+		n=scanfloats(rest.p,rest.p+rest.len,r,6);
+		for (i=0; i<n; i++) {
+			if (i<3)
+				(&(rootpos->x))[i]=r[i];
+			else
+				(&(rootorient->x))[i-3]=r[i];
+		}
+	}
+	else {
+		boneid=parser_findbone_span(skel,word.p,word.len);
+		if (boneid==-1) {
+			printf("WARNING: MOCAP file - undefined bone name [%.*s] in datastream\n",word.len,word.p);
+			return;
+		}
+
+		r[0]=r[1]=r[2]=0;
+		scanfloats(rest.p,rest.p+rest.len,r,3);
+
+		idx=0;
+		if (skel->bonearray[boneid].xyzflags & DOF_FLAG_RX) {
+			bones[boneid].x=r[idx++];
+		}
+		if (skel->bonearray[boneid].xyzflags & DOF_FLAG_RY) {
+			bones[boneid].y=r[idx++];
+		}
+		if (skel->bonearray[boneid].xyzflags & DOF_FLAG_RZ) {
+			bones[boneid].z=r[idx++];
+		}
+	}
+
+}
+
+
+int framenumber(SPAN word) {
+
+	int n=0;
+	int i;
+
+	/* A bare positive integer starts a new frame (same test as atoi(firstword)>0) */
+	if (!word.len || !((word.p[0]>='0' && word.p[0]<='9') || word.p[0]=='+'))
+		return 0;
+
+	/* More digits than an int holds - atoi gave nothing sensible either, so it isn't a frame */
+	for (i=(word.p[0]=='+'); i<word.len && word.p[i]>='0' && word.p[i]<='9'; i++) {
+		if (n>(INT_MAX-9)/10)
+			return 0;
+		n=n*10+(word.p[i]-'0');
+	}
+
+	return n;
+
+}
+
+
+MOCAP* parser_loadMocapParallel(char* argFilename, SKELETON* skel, int threads) {
+
+	MAPPEDFILE*	mf;
+	MOCAP*		momodel;
+	THREADPOOL*	pool;
+	AMCCHUNK*	chunks;
+	int			chunks_enum;
+	const char*	body;		/* first byte after the :degrees line */
+	const char*	end;
+	const char*	p;
+	const char*	eol;
+	SPAN		word, rest;
+	int			frames;		/* highest frame number in the file */
+	int			lastframe;	/* last frame of the previous chunk */
+	int			i,missing,failed;
+
+	if (!(mf=mapfile_open(argFilename)))
+		return NULL;
+
+	if (threads<=0)
+		threads=threadpool_cpucount();
+
+	/* Find the :degrees section - anything unusual before it is left to the serial loader */
+	body=NULL;
+	end=mf->data+mf->size;
+	for (p=mf->data; p<end && !body; ) {
+		p=nextline(p,end,&word,&rest);
+		if (changemode_span(word)==PARSESTATE_DEGREES)
+			body=p;
+	}
+
+	/* The highest frame number is on the last frame line, which sizes the arrays up front */
+	frames=0;
+	for (p=end; body && p>body && !frames; ) {
+		eol=p;
+		p--;
+		while (p>body && p[-1]!='\n')
+			p--;
+		nextline(p,eol,&word,&rest);
+		frames=framenumber(word);
+	}
+
+	if (threads<2 || mf->size<PARALLEL_MINBYTES || !frames) {
+		mapfile_close(mf);
+		return parser_loadMocapMapped(argFilename,skel);
+	}
+
+	momodel=(MOCAP*)calloc(1,sizeof(MOCAP));
+	momodel->bones_enum=skel->bonearray_enum;
+	mocap_setcapacity(momodel,frames);
+	momodel->frames_enum=frames;
+
+	/* Cut the section into equal byte ranges, each snapped forward to the next frame number line */
+	chunks_enum=threads*PARALLEL_CHUNKSPERTHREAD;
+	chunks=(AMCCHUNK*)calloc(chunks_enum,sizeof(AMCCHUNK));
+	for (i=0; i<chunks_enum; i++) {
+		p=body+(end-body)/chunks_enum*i;
+		if (i) {
+			p=(const char*)memchr(p,'\n',end-p);
+			p=p ? p+1 : end;
+			while (p<end) {
+				eol=nextline(p,end,&word,&rest);
+				if (framenumber(word))
+					break;
+				p=eol;
+			}
+			if (p<chunks[i-1].begin)
+				p=chunks[i-1].begin;
+		}
+		chunks[i].begin=p;
+		chunks[i].mocap=momodel;
+		chunks[i].skel=skel;
+	}
+	for (i=0; i<chunks_enum; i++)
+		chunks[i].end=(i<chunks_enum-1) ? chunks[i+1].begin : end;
+
+	pool=threadpool_create(threads);
+	for (i=0; i<chunks_enum; i++) {
+		if (chunks[i].begin<chunks[i].end)
+			threadpool_submit(pool,decode_degreeschunk,chunks+i);
+	}
+	threadpool_destroy(pool);
+
+	/* Check the frames run in order across the chunks, and zero any gaps between them */
+	failed=0;
+	missing=0;
+	lastframe=0;
+	for (i=0; i<chunks_enum && !failed; i++) {
+		failed=chunks[i].failed;
+		if (failed || !chunks[i].frames)
+			continue;
+		failed=chunks[i].firstframe<=lastframe;
+		if (chunks[i].firstframe>lastframe+1)
+			mocap_zeroframes(momodel,lastframe,chunks[i].firstframe-1);
+		missing+=(chunks[i].lastframe-chunks[i].firstframe+1)-chunks[i].frames+(chunks[i].firstframe-lastframe-1);
+		lastframe=chunks[i].lastframe;
+	}
+
+	free(chunks);
+	mapfile_close(mf);
+
+	if (failed) {
+		/* Duplicated or out of order frames, or another section - the serial loader has the exact semantics */
+		parser_free_mocap(momodel);
+		return parser_loadMocapMapped(argFilename,skel);
+	}
+
+	if (missing)
+		printf("WARNING: MOCAP file - %d frame(s) missing from the sequence\n",missing);
+
+	return momodel;
+
+}
+
+
+void decode_degreeschunk(void* arg) {
+
+	AMCCHUNK*	chunk=(AMCCHUNK*)arg;
+	const char*	p;
+	SPAN		word, rest;
+	int			frmnum=-1;
+	int			n;
+
+	for (p=chunk->begin; p<chunk->end && !chunk->failed; ) {
+
+		p=nextline(p,chunk->end,&word,&rest);
+		if (!word.len)
+			continue;
+
+		if ((n=framenumber(word))) {
+			/* Frames must increase strictly within a chunk and stay inside the preallocated slots */
+			if (n<=frmnum || n>chunk->mocap->frames_enum) {
+				chunk->failed=1;
+				break;
+			}
+			if (frmnum==-1)
+				chunk->firstframe=n;
+			else if (n>frmnum+1)
+				mocap_zeroframes(chunk->mocap,frmnum,n-1);
+			mocap_zeroframes(chunk->mocap,n-1,n);
+			frmnum=n;
+			chunk->lastframe=n;
+			chunk->frames++;
+			continue;
+		}
+
+		if (changemode_span(word) || frmnum==-1) {
+			chunk->failed=1;
+			break;
+		}
+
+		decode_degreesline(word,rest,chunk->mocap,chunk->skel,&frmnum);
+
+	}
+
+}
+
+
+AMCSTREAM* parser_openMocapStream(char* argFilename, SKELETON* skel) {
+
+	AMCSTREAM* stream;
+	FILE* fp;
+
+	if (!(fp=fopen(argFilename,"rb")))
+		return NULL;
+
+	stream=(AMCSTREAM*)calloc(1,sizeof(AMCSTREAM));
+	stream->fp=fp;
+	stream->skel=skel;
+	stream->buf=(char*)malloc(STREAM_BUFFERLEN);
+
+	return stream;
+
+}
+
+void parser_rewindMocapStream(AMCSTREAM* stream) {
+
+	rewind(stream->fp);
+	stream->buf_len=0;
+	stream->buf_pos=0;
+	stream->eof=0;
+	stream->indegrees=0;
+	stream->pending=0;
+
+}
+
+int parser_seekMocapStream(AMCSTREAM* stream, long long offset) {
+
+	if (fseek64(stream->fp,offset,SEEK_SET))
+		return 0;
+
+	/* Frame number lines only occur inside :degrees */
+	stream->buf_len=0;
+	stream->buf_pos=0;
+	stream->eof=0;
+	stream->indegrees=1;
+	stream->pending=0;
+
+	return 1;
+
+}
+
+void parser_closeMocapStream(AMCSTREAM* stream) {
+
+	fclose(stream->fp);
+	free(stream->buf);
+	free(stream);
+
+}
+
+int parser_nextFrame(AMCSTREAM* stream, AMCFRAME* frame) {
+
+	SPAN		word, rest;
+	int			newps;
+	int			n;
+
+	/* Find the start of the next frame unless the last call already read it */
+	while (!stream->pending) {
+		if (!stream_nextline(stream,&word,&rest))
+			return 0;
+		if ((newps=changemode_span(word)))
+			stream->indegrees=(newps==PARSESTATE_DEGREES);
+		else if (stream->indegrees && !(stream->pending=framenumber(word)) && word.len)
+			printf("FATAL:  Data out of sync with frame number\n");
+	}
+
+	/* Channels missing from the file stay zero, as they do in parser_loadMocap */
+	frame->frame=stream->pending;
+	memset(&(frame->root_pos),0,sizeof(POINT3D));
+	memset(&(frame->root_orient),0,sizeof(POINT3D));
+	memset(frame->bones_orient,0,sizeof(POINT3D)*stream->skel->bonearray_enum);
+	stream->pending=0;
+
+	/* Decode lines up to the next frame number, section change or end of file */
+	while (stream_nextline(stream,&word,&rest)) {
+		if (!word.len)
+			continue;
+		if ((n=framenumber(word))) {
+			stream->pending=n;
+			break;
+		}
+		if ((newps=changemode_span(word))) {
+			stream->indegrees=(newps==PARSESTATE_DEGREES);
+			break;
+		}
+		decode_degreesvalues(word,rest,stream->skel,&(frame->root_pos),&(frame->root_orient),frame->bones_orient);
+	}
+
+	return 1;
+
+}
+
+int stream_nextline(AMCSTREAM* stream, SPAN* word, SPAN* rest) {
+
+	const char*	p;
+	const char*	end;
+	const char*	nl;
+
+	/* Make sure a whole line is held in the window, sliding and refilling it as needed */
+	while (1) {
+		p=stream->buf+stream->buf_pos;
+		end=stream->buf+stream->buf_len;
+		nl=(const char*)memchr(p,'\n',end-p);
+		if (nl || stream->eof || (stream->buf_pos==0 && stream->buf_len==STREAM_BUFFERLEN))
+			break;
+
+		memmove(stream->buf,p,end-p);
+		stream->buf_len=end-p;
+		stream->buf_pos=0;
+		stream->buf_len+=fread(stream->buf+stream->buf_len,1,STREAM_BUFFERLEN-stream->buf_len,stream->fp);
+		if (feof(stream->fp) || ferror(stream->fp))
+			stream->eof=1;
+	}
+
+	if (p>=end)
+		return 0;
+
+	stream->buf_pos=nextline(p,end,word,rest)-stream->buf;
+
+	return 1;
+
+}
+
+long long* parser_indexMocap(char* argFilename, int* frames_enum) {
+
+	MAPPEDFILE*	mf;
+	long long*	offsets;
+	long long*	grown;
+	int			alloc;
+	int			ps;
+	int			newps;
+	int			n;
+	const char*	p;
+	const char*	line;
+	const char*	end;
+	SPAN		word, rest;
+
+	if (!(mf=mapfile_open(argFilename)))
+		return NULL;
+
+	alloc=MOCAP_INITIAL_FRAMES;
+	offsets=(long long*)malloc(sizeof(long long)*alloc);
+	*frames_enum=0;
+
+	/* Only the first word of each line is looked at - no values are decoded */
+	ps=PARSESTATE_UNKNOWN;
+	p=mf->data;
+	end=p+mf->size;
+	while (p<end) {
+
+		line=p;
+		p=nextline(p,end,&word,&rest);
+		if (!word.len)
+			continue;
+
+		if ((newps=changemode_span(word))) {
+			ps=newps;
+			continue;
+		}
+		if (ps!=PARSESTATE_DEGREES || (n=framenumber(word))<=0 || n>INDEX_MAX_FRAMES)
+			continue;
+
+		/* n is capped, so doubling stops well short of overflowing */
+		if (n>alloc) {
+			while (n>alloc)
+				alloc*=2;
+			if (!(grown=(long long*)realloc(offsets,sizeof(long long)*alloc))) {
+				free(offsets);
+				mapfile_close(mf);
+				return NULL;
+			}
+			offsets=grown;
+		}
+		while (*frames_enum<n)
+			offsets[(*frames_enum)++]=-1;
+
+		/* A frame number repeated later in the file is read from its last occurrence */
+		offsets[n-1]=line-mf->data;
+
+	}
+
+	mapfile_close(mf);
+
+	return offsets;
+
+}
+
+AMCFOLLOW* parser_openMocapFollow(char* argFilename, SKELETON* skel) {
+
+	AMCFOLLOW* follow;
+	FILE* fp;
+	int i;
+
+	if (!(fp=fopen(argFilename,"rb")))
+		return NULL;
+
+	follow=(AMCFOLLOW*)calloc(1,sizeof(AMCFOLLOW));
+	follow->fp=fp;
+	follow->filename=(char*)malloc(strlen(argFilename)+1);
+	strcpy(follow->filename,argFilename);
+	follow->skel=skel;
+	follow->buf=(char*)malloc(STREAM_BUFFERLEN);
+	follow->mocap=(MOCAP*)calloc(1,sizeof(MOCAP));
+	follow->mocap->bones_enum=skel->bonearray_enum;
+	follow->frame_lines=1;
+	for (i=0; i<skel->bonearray_enum; i++)
+		if (skel->bonearray[i].xyzflags)
+			follow->frame_lines++;
+	follow_restart(follow);
+
+	return follow;
+
+}
+
+int parser_followMocap(AMCFOLLOW* follow) {
+
+	const char*	p;
+	const char*	end;
+	const char*	nl;
+	SPAN		word, rest;
+	long long	size;
+	int			ready=follow->frames_ready;
+	size_t		n;
+
+	/* A file shorter than what was already read has been truncated or replaced - start again */
+	if (!fseek64(follow->fp,0,SEEK_END) && (size=ftell64(follow->fp))>=0 && size<follow->offset)
+		follow_restart(follow);
+	fseek64(follow->fp,follow->offset,SEEK_SET);
+
+	while ((n=fread(follow->buf+follow->buf_len,1,STREAM_BUFFERLEN-follow->buf_len,follow->fp))>0) {
+		follow->offset+=n;
+		follow->buf_len+=n;
+
+		/* Only whole lines are parsed, the writer may be half way through the last one */
+		p=follow->buf;
+		end=follow->buf+follow->buf_len;
+		while ((nl=(const char*)memchr(p,'\n',end-p))) {
+			p=nextline(p,end,&word,&rest);
+			follow_line(follow,word,rest);
+		}
+		if (p==follow->buf && follow->buf_len==STREAM_BUFFERLEN) {
+			/* No line may be longer than the buffer */
+			p=nextline(p,end,&word,&rest);
+			follow_line(follow,word,rest);
+		}
+
+		memmove(follow->buf,p,end-p);
+		follow->buf_len=end-p;
+	}
+
+	/* Let the next call read past the current end of file */
+	clearerr(follow->fp);
+
+	return follow->frames_ready-ready;
+
+}
+
+int parser_reopenMocapFollow(AMCFOLLOW* follow) {
+
+	FILE* fp;
+
+	/* Until the new file can be opened, keep what we have of the old one */
+	if (!(fp=fopen(follow->filename,"rb")))
+		return 0;
+
+	fclose(follow->fp);
+	follow->fp=fp;
+	follow_restart(follow);
+
+	return 1;
+
+}
+
+void parser_closeMocapFollow(AMCFOLLOW* follow) {
+
+	fclose(follow->fp);
+	free(follow->filename);
+	free(follow->buf);
+	parser_free_mocap(follow->mocap);
+	free(follow);
+
+}
+
+void follow_line(AMCFOLLOW* follow, SPAN word, SPAN rest) {
+
+	int newps;
+
+	if (!word.len)
+		return;
+
+	/* Same state machine as parser_loadMocapMapped, one line at a time */
+	if ((newps=changemode_span(word))) {
+		follow->ps=newps;
+		follow->frmnum=-1;
+		return;
+	}
+	if (follow->ps!=PARSESTATE_DEGREES)
+		return;
+
+	/* A new frame number means the frame before it is complete, even if it skipped some bones */
+	if (framenumber(word)) {
+		if (follow->frmnum>follow->frames_ready)
+			follow->frames_ready=follow->frmnum;
+		follow->lines=0;
+	}
+	else {
+		follow->lines++;
+	}
+
+	if (!decode_degreesline(word,rest,follow->mocap,follow->skel,&(follow->frmnum))) {
+		follow->ps=PARSESTATE_UNKNOWN;
+		return;
+	}
+
+	/* Otherwise a frame is ready as soon as its last bone arrives, not one frame later */
+	if (follow->lines==follow->frame_lines && follow->frmnum>follow->frames_ready)
+		follow->frames_ready=follow->frmnum;
+
+}
+
+void follow_restart(AMCFOLLOW* follow) {
+
+	follow->mocap->frames_enum=0;
+	follow->frames_ready=0;
+	follow->buf_len=0;
+	follow->offset=0;
+	follow->ps=PARSESTATE_UNKNOWN;
+	follow->frmnum=-1;
+	follow->lines=0;
+
+}
+
+int parser_saveSkeleton(char* argFilename, SKELETON* skel) {
+
+	WRITER	w;
+	BONE*	bone;
+	POINT3D	dir;
+	int		i,j;
+
+	if (!writer_open(&w,argFilename))
+		return 0;
+
+	writer_text(&w,"# ASF file written by parser_saveSkeleton\n:version 1.10\n:name VICON\n:units\n  angle deg\n");
+	writer_text(&w,":root\n   order TX TY TZ RX RY RZ\n   axis XYZ\n   position ");
+	writer_floats(&w,&(skel->init_position.x),3);
+	writer_text(&w,"\n   orientation ");
+	writer_floats(&w,&(skel->init_orientation.x),3);
+
+	writer_text(&w,"\n:bonedata\n");
+	for (i=0; i<skel->bonearray_enum; i++) {
+		bone=&(skel->bonearray[i]);
+		writer_text(&w,"  begin\n     id ");
+		writer_int(&w,i+1);
+		if (bone->name) {
+			writer_text(&w,"\n     name ");
+			writer_text(&w,bone->name);
+		}
+		writer_text(&w,"\n     direction ");
+		bone_asfdirection(bone,&dir);
+		writer_floats(&w,&(dir.x),3);
+		writer_text(&w,"\n     length ");
+		writer_floats(&w,&(bone->length),1);
+		writer_text(&w,"\n     axis ");
+		writer_floats(&w,&(bone->axis.x),3);
+		writer_text(&w," XYZ\n");
+		if (bone->xyzflags) {
+			writer_text(&w,"     dof");
+			if (bone->xyzflags & DOF_FLAG_RX)
+				writer_text(&w," rx");
+			if (bone->xyzflags & DOF_FLAG_RY)
+				writer_text(&w," ry");
+			if (bone->xyzflags & DOF_FLAG_RZ)
+				writer_text(&w," rz");
+			writer_text(&w,"\n");
+		}
+		writer_text(&w,"  end\n");
+	}
+
+	/* One line per parent, children by name - bones without a name can't be placed */
+	writer_text(&w,":hierarchy\n  begin\n");
+	if (skel->children_enum) {
+		writer_text(&w,"    root");
+		for (j=0; j<skel->children_enum; j++) {
+			if (skel->children[j]->name) {
+				writer_text(&w," ");
+				writer_text(&w,skel->children[j]->name);
+			}
+		}
+		writer_text(&w,"\n");
+	}
+	for (i=0; i<skel->bonearray_enum; i++) {
+		bone=&(skel->bonearray[i]);
+		if (!bone->children_enum || !bone->name)
+			continue;
+		writer_text(&w,"    ");
+		writer_text(&w,bone->name);
+		for (j=0; j<bone->children_enum; j++) {
+			if (bone->children[j]->name) {
+				writer_text(&w," ");
+				writer_text(&w,bone->children[j]->name);
+			}
+		}
+		writer_text(&w,"\n");
+	}
+	writer_text(&w,"  end\n");
+
+	return writer_close(&w);
+
+}
+
+int parser_saveMocap(char* argFilename, MOCAP* mocap, SKELETON* skel) {
+
+	WRITER	w;
+	BONE*	bone;
+	float	r[3];
+	int		f,i,n;
+
+	if (!writer_open(&w,argFilename))
+		return 0;
+
+	writer_text(&w,"# AMC file written by parser_saveMocap\n:FULLY-SPECIFIED\n:DEGREES\n");
+
+	/* Every frame is written, so gaps in the original numbering come back as the zero frames they loaded as */
+	for (f=0; f<mocap->frames_enum; f++) {
+		writer_int(&w,f+1);
+		writer_text(&w,"\nroot ");
+		writer_floats(&w,&(mocap->root_pos[f].x),3);
+		writer_text(&w," ");
+		writer_floats(&w,&(mocap->root_orient[f].x),3);
+		writer_text(&w,"\n");
+
+		/* Only the degrees of freedom the skeleton declares, in rx ry rz order as decode_degreesvalues expects */
+		for (i=0; i<skel->bonearray_enum; i++) {
+			bone=&(skel->bonearray[i]);
+			if (!bone->xyzflags || !bone->name)
+				continue;
+			n=0;
+			if (bone->xyzflags & DOF_FLAG_RX)
+				r[n++]=mocap->bones_orient[f][i].x;
+			if (bone->xyzflags & DOF_FLAG_RY)
+				r[n++]=mocap->bones_orient[f][i].y;
+			if (bone->xyzflags & DOF_FLAG_RZ)
+				r[n++]=mocap->bones_orient[f][i].z;
+			writer_text(&w,bone->name);
+			writer_text(&w," ");
+			writer_floats(&w,r,n);
+			writer_text(&w,"\n");
+		}
+	}
+
+	return writer_close(&w);
+
+}
+
+int writer_open(WRITER* w, char* argFilename) {
+
+	if (!(w->fp=fopen(argFilename,"wb")))
+		return 0;
+
+	w->buf=(char*)malloc(WRITE_BUFFERLEN);
+	w->len=0;
+	w->failed=0;
+
+	return 1;
+
+}
+
+int writer_close(WRITER* w) {
+
+	writer_flush(w);
+	if (fclose(w->fp))
+		w->failed=1;
+	free(w->buf);
+
+	return !w->failed;
+
+}
+
+void writer_flush(WRITER* w) {
+
+	if (w->len && fwrite(w->buf,1,w->len,w->fp)!=(size_t)w->len)
+		w->failed=1;
+	w->len=0;
+
+}
+
+void writer_text(WRITER* w, const char* str) {
+
+	int n=strlen(str);
+
+	if (w->len+n>WRITE_BUFFERLEN) {
+		writer_flush(w);
+		if (n>WRITE_BUFFERLEN) {
+			if (fwrite(str,1,n,w->fp)!=(size_t)n)
+				w->failed=1;
+			return;
+		}
+	}
+
+	memcpy(w->buf+w->len,str,n);
+	w->len+=n;
+
+}
+
+void writer_int(WRITER* w, int v) {
+
+	if (w->len+NUMPARSE_FORMATLEN>WRITE_BUFFERLEN)
+		writer_flush(w);
+
+	w->len+=sprintf(w->buf+w->len,"%d",v);
+
+}
+
+void writer_floats(WRITER* w, const float* v, int n) {
+
+	int i;
+
+	if (w->len+n*NUMPARSE_FORMATLEN>WRITE_BUFFERLEN)
+		writer_flush(w);
+
+	for (i=0; i<n; i++) {
+		if (i)
+			w->buf[w->len++]=' ';
+		w->len+=numparse_format(v[i],w->buf+w->len);
+	}
+
+}
+
+void bone_asfdirection(BONE* bone, POINT3D* asf) {
+
+	double	Rx[4][4], Ry[4][4], Rz[4][4];
+	double	v[3], t[3];
+	POINT3D	guess, back;
+	int		i,iter,r,dx,dy,dz;
+
+	/* The direction as it was loaded, unless it has been changed since */
+	back=bone->asfdirection;
+	rotateVector(&back,-bone->axis.x,-bone->axis.y,-bone->axis.z);
+	if (!memcmp(&back,&(bone->direction),sizeof(POINT3D))) {
+		*asf=bone->asfdirection;
+		return;
+	}
+
+	rotationX(Rx,bone->axis.x);
+	rotationY(Ry,bone->axis.y);
+	rotationZ(Rz,bone->axis.z);
+	v[0]=v[1]=v[2]=0;
+	back.x=back.y=back.z=0;
+
+	/* parser_loadSkeleton applied Rx(-x).Ry(-y).Rz(-z), rounding to float after each rotation, so undo it
+	   with Rz(z).Ry(y).Rx(x) in double and then correct by whatever error reloading the guess leaves */
+	for (iter=0; iter<4; iter++) {
+		t[0]=bone->direction.x-back.x;
+		t[1]=bone->direction.y-back.y;
+		t[2]=bone->direction.z-back.z;
+		vector_unrotate(Rx,Ry,Rz,t);
+		for (i=0; i<3; i++)
+			v[i]+=t[i];
+		guess.x=(float)v[0];
+		guess.y=(float)v[1];
+		guess.z=(float)v[2];
+		back=guess;
+		rotateVector(&back,-bone->axis.x,-bone->axis.y,-bone->axis.z);
+		if (!memcmp(&back,&(bone->direction),sizeof(POINT3D))) {
+			*asf=guess;
+			return;
+		}
+	}
+	*asf=guess;
+
+	/* Still off by rounding - try the neighbours a couple of representable values away in each component.
+	   Not every float vector is reachable through the rotation, in which case the closest guess stands */
+	for (r=1; r<=2; r++) {
+		for (dx=-r; dx<=r; dx++) {
+			for (dy=-r; dy<=r; dy++) {
+				for (dz=-r; dz<=r; dz++) {
+					if (dx!=-r && dx!=r && dy!=-r && dy!=r && dz!=-r && dz!=r)
+						continue;		/* Inner shell, already tried */
+					guess.x=float_step(asf->x,dx);
+					guess.y=float_step(asf->y,dy);
+					guess.z=float_step(asf->z,dz);
+					back=guess;
+					rotateVector(&back,-bone->axis.x,-bone->axis.y,-bone->axis.z);
+					if (!memcmp(&back,&(bone->direction),sizeof(POINT3D))) {
+						*asf=guess;
+						return;
+					}
+				}
+			}
+		}
+	}
+
+}
+
+void vector_unrotate(double Rx[4][4], double Ry[4][4], double Rz[4][4], double* v) {
+
+	double t[3];
+	int i;
+
+	for (i=0; i<3; i++)
+		t[i]=Rx[i][0]*v[0]+Rx[i][1]*v[1]+Rx[i][2]*v[2];
+	for (i=0; i<3; i++)
+		v[i]=Ry[i][0]*t[0]+Ry[i][1]*t[1]+Ry[i][2]*t[2];
+	for (i=0; i<3; i++)
+		t[i]=Rz[i][0]*v[0]+Rz[i][1]*v[1]+Rz[i][2]*v[2];
+	for (i=0; i<3; i++)
+		v[i]=t[i];
+
+}
+
+float float_step(float f, int k) {
+
+	unsigned int bits;
+	int o;
+
+	/* Map the bit pattern to a signed integer that counts representable values through zero */
+	memcpy(&bits,&f,sizeof(float));
+	o=(bits&0x80000000u) ? -(int)(bits&0x7FFFFFFFu) : (int)bits;
+	o+=k;
+	bits=(o<0) ? ((unsigned int)(-o))|0x80000000u : (unsigned int)o;
+	memcpy(&f,&bits,sizeof(float));
+
+	return f;
+
+}
+
+void parser_frameview(AMCFRAME* frame, MOCAP* view) {
+
+	memset(view,0,sizeof(MOCAP));
+	view->frames_enum=1;
+	view->frames_alloc=1;
+	view->root_pos=&(frame->root_pos);
+	view->root_orient=&(frame->root_orient);
+	view->bones_orient=&(frame->bones_orient);
+	view->bones_slab=frame->bones_orient;
+
+}
+
+
+void mocap_zeroframes(MOCAP* mocap, int first, int last) {
+
+	memset(mocap->bones_slab+(size_t)first*mocap->bones_enum,0,sizeof(POINT3D)*(size_t)(last-first)*mocap->bones_enum);
+	memset(mocap->root_orient+first,0,sizeof(POINT3D)*(last-first));
+	memset(mocap->root_pos+first,0,sizeof(POINT3D)*(last-first));
+
+}
+
+
+int scanfloats(const char* p, const char* end, float* out, int max) {
+
+	int n=0;
+
+	/* Same results as sscanf "%f %f ..." - stops at the first thing that isn't a number */
+	while (n<max) {
+		while (p<end && ISWHT(*p))
+			p++;
+		if (p>=end || !(p=numparse_float(p,end,out+n)))
+			break;
+		n++;
+	}
+
+	return n;
+
+}
+
+
+void matrix_transform_affine(double m[4][4],
+							 double x, double y, 
+							 double z, POINT3D* pt) 
+{
+    pt->x = m[0][0]*x + m[0][1]*y + m[0][2]*z + m[0][3];
+    pt->y = m[1][0]*x + m[1][1]*y + m[1][2]*z + m[1][3];
+    pt->z = m[2][0]*x + m[2][1]*y + m[2][2]*z + m[2][3];
+}
+
+
+void rotateVector(POINT3D* v, float a, float b, float c)
+{
+	POINT3D angles;
+
+	//Rx.Ry.Rz applied to v, with one sin and cos per angle rather than three 4x4 matrices
+	angles.x=a;
+	angles.y=b;
+	angles.z=c;
+	euler_rotatevectors(&angles, 1, EULER_ASF, v);
+}
+
+void rotationZ(double r[][4], float a)
+{
+    a=a*PI/180.;
+    r[0][0]=cos(a); r[0][1]=-sin(a); r[0][2]=0; r[0][3]=0;
+    r[1][0]=sin(a); r[1][1]=cos(a);  r[1][2]=0; r[1][3]=0;
+    r[2][0]=0;      r[2][1]=0;       r[2][2]=1; r[2][3]=0;
+    r[3][0]=0;      r[3][1]=0;       r[3][2]=0; r[3][3]=1;
+}
+
+void rotationY(double r[][4], float a)
+{
+    a=a*PI/180.;
+    r[0][0]=cos(a);  r[0][1]=0;       r[0][2]=sin(a); r[0][3]=0;
+    r[1][0]=0;       r[1][1]=1;       r[1][2]=0;      r[1][3]=0;
+    r[2][0]=-sin(a); r[2][1]=0;       r[2][2]=cos(a); r[2][3]=0;
+    r[3][0]=0;       r[3][1]=0;       r[3][2]=0;      r[3][3]=1;
+}
+
+void rotationX(double r[][4], float a)
+{
+    a=a*PI/180.;
+    r[0][0]=1;       r[0][1]=0;       r[0][2]=0;       r[0][3]=0;
+    r[1][0]=0;       r[1][1]=cos(a);  r[1][2]=-sin(a); r[1][3]=0;
+    r[2][0]=0;       r[2][1]=sin(a);  r[2][2]=cos(a);  r[2][3]=0;
+    r[3][0]=0;       r[3][1]=0;       r[3][2]=0;       r[3][3]=1;
+}
+
+void parser_free_mocap(MOCAP* mocap) {
+
+	free (mocap->bones_orient);
+	if (mocap->backing) {
+		/* Everything else lives in the mapped cache file */
+		mapfile_close(mocap->backing);
+	}
+	else {
+		free (mocap->root_orient);
+		free (mocap->root_pos);
+		free (mocap->bones_slab);
+	}
+	free (mocap);
+
+}
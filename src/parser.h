@@ -1,95 +1,183 @@
-#ifndef COLLOMOSSE_MOCAP_PARSER_INCLUDED
-#define COLLOMOSSE_MOCAP_PARSER_INCLUDED
-
-/*******************************************************\
-*                                                       *
-*  PARSER.H                                             *
-*  Acclaim Motion Capture (ASF/AMC) Parser Library      *
-*                                                       *
-*  Parses Skeleton (ASF) and motion capture (AMC) files *
-*  Written as a resource for CM20219 coursework         *
-*                                                       *
-*  (c) John Collomosse, University of Bath              *
-*  September 2008                                       *
-*                                                       *
-\*******************************************************/
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <math.h>
-
-#define PI (3.141)
-
-#ifdef WIN32
-	#include "windows.h"
-	#define strcasecmp stricmp
-#endif
-
-/* A basic type for representing 3D quantities e.g. points, vectors and Euler angles */
-typedef struct _3dcoord {
-
-	float x;
-	float y;
-	float z;
-
-} POINT3D;
-
-
-/* Type for representing bones */
-typedef struct _bone {
-
-	int		id;
-	char*	name;
-	POINT3D direction;
-	float	length;
-	POINT3D axis;
-	int		xyzflags;
-	int		children_enum;
-	struct _bone**	children;
-	struct _bone*	parent;
-
-} BONE;
-
-
-/* Type for representing the skeleton (collection of bones) */
-typedef struct _skeleton {
-
-	POINT3D init_position;			/* Initial translation of the root (world) reference frame */
-	POINT3D init_orientation;		/* Initial orientation of the root (world) reference frame */
-	int		children_enum;			/* How many children bones off the root ? */
-	struct _bone**	children;		/* Array of pointers to children bones e.g. children[0 to children_enum] */
-
-	/* You aren't likely to need these next two fields for your coursework */
-	int		bonearray_enum;			/* Number of bones in bonearray */
-	struct _bone* bonearray;		/* Not needed for coursework - array of all bones in skeleton bonearray[0 to bonearray_enum]*/
-
-} SKELETON;
-
-
-/* Type for representing a motion capture set (how the skeleton moves) */
-typedef struct _mocap {
-
-	int			frames_enum;	/* Number of frames of animation */
-	POINT3D*	root_pos;		/* Translation of root (world) reference frame - root_pos[0] to root_pos[frames_enum-1] */
-	POINT3D*	root_orient;	/* Orientation of root (world) reference frame - root_orient[0] to root_orient[frames_enum-1] */
-	POINT3D**	bones_orient;	/* Orientation of bones - bones_orient[framenumber][bonenumber] */
-
-} MOCAP;
-
-
-SKELETON*	parser_loadSkeleton(char* argFilename);
-MOCAP*		parser_loadMocap(char* argFilename, SKELETON* skel);
-void		parser_debugskeletonTree(SKELETON* skel);
-void		parser_free_skeleton(SKELETON* skel);
-void		parser_free_mocap(MOCAP* mocap);
-void RotateBoneDirToLocalCoordSystem(SKELETON* skel);
-void vector_rotationXYZ(POINT3D* v, float a, float b, float c);
-void matrix_transform_affine(double m[4][4], double x, double y, double z, POINT3D* v);
-void rotationX(double r[][4], float a);
-void rotationY(double r[][4], float a);
-void rotationZ(double r[][4], float a);
-
-
-
+#ifndef COLLOMOSSE_MOCAP_PARSER_INCLUDED
+#define COLLOMOSSE_MOCAP_PARSER_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  PARSER.H                                             *
+*  Acclaim Motion Capture (ASF/AMC) Parser Library      *
+*                                                       *
+*  Parses Skeleton (ASF) and motion capture (AMC) files *
+*  Written as a resource for CM20219 coursework         *
+*                                                       *
+*  (c) John Collomosse, University of Bath              *
+*  September 2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#define PI (3.141)
+
+#ifdef WIN32
+	#include "windows.h"
+	#define strcasecmp stricmp
+	#define strncasecmp strnicmp
+#endif
+
+/* Presence flags for DOF keywords in :bonedata of ASF file (BONE::xyzflags) */
+#define DOF_FLAG_RX (0x01)
+#define DOF_FLAG_RY (0x02)
+#define DOF_FLAG_RZ (0x04)
+
+/* A basic type for representing 3D quantities e.g. points, vectors and Euler angles */
+typedef struct _3dcoord {
+
+	float x;
+	float y;
+	float z;
+
+} POINT3D;
+
+
+/* Type for representing bones */
+typedef struct _bone {
+
+	int		id;
+	char*	name;
+	POINT3D direction;
+	POINT3D	asfdirection;	/* direction as the ASF file gave it, before parser_loadSkeleton rotated it - only needed by parser_saveSkeleton */
+	float	length;
+	POINT3D axis;
+	int		xyzflags;
+	int		children_enum;
+	struct _bone**	children;
+	struct _bone*	parent;
+
+} BONE;
+
+
+/* Type for looking up bones by name - case insensitive open addressing hash table */
+typedef struct _boneindex {
+
+	int		slots_enum;				/* Number of slots, always a power of two */
+	int*	slots;					/* Index into bonearray for each slot, -1 if the slot is empty */
+
+} BONEINDEX;
+
+
+/* Type for representing the skeleton (collection of bones) */
+typedef struct _skeleton {
+
+	POINT3D init_position;			/* Initial translation of the root (world) reference frame */
+	POINT3D init_orientation;		/* Initial orientation of the root (world) reference frame */
+	int		children_enum;			/* How many children bones off the root ? */
+	struct _bone**	children;		/* Array of pointers to children bones e.g. children[0 to children_enum] */
+
+	/* You aren't likely to need these next two fields for your coursework */
+	int		bonearray_enum;			/* Number of bones in bonearray */
+	struct _bone* bonearray;		/* Not needed for coursework - array of all bones in skeleton bonearray[0 to bonearray_enum]*/
+	BONEINDEX	bonenames;			/* Name lookup for bonearray - use parser_findbone() rather than searching bonearray */
+	struct _arena*	arena;			/* Holds the skeleton, its bones, names and children arrays (see arena.h), NULL if they were malloc'ed one by one */
+
+} SKELETON;
+
+
+/* Type for representing a motion capture set (how the skeleton moves) */
+typedef struct _mocap {
+
+	int			frames_enum;	/* Number of frames of animation */
+	POINT3D*	root_pos;		/* Translation of root (world) reference frame - root_pos[0] to root_pos[frames_enum-1] */
+	POINT3D*	root_orient;	/* Orientation of root (world) reference frame - root_orient[0] to root_orient[frames_enum-1] */
+	POINT3D**	bones_orient;	/* Orientation of bones - bones_orient[framenumber][bonenumber] */
+
+	/* Storage behind bones_orient - you shouldn't need these for your coursework */
+	int			bones_enum;		/* Number of bones per frame (bonearray_enum of the skeleton) */
+	int			frames_alloc;	/* Number of frames the arrays have room for */
+	POINT3D*	bones_slab;		/* All bone orientations, frame after frame - bones_orient[f] points at bones_slab+f*bones_enum */
+	struct _mappedfile* backing;	/* Binary cache file the arrays point into (see amcb.h), NULL if they were allocated */
+
+} MOCAP;
+
+
+/* A single frame of motion, as returned by parser_nextFrame */
+typedef struct _amcframe {
+
+	int			frame;			/* Frame number from the AMC file (1 based) */
+	POINT3D		root_pos;		/* Translation of root (world) reference frame */
+	POINT3D		root_orient;	/* Orientation of root (world) reference frame */
+	POINT3D*	bones_orient;	/* Caller provided - orientation of bones, bones_orient[0 to bonearray_enum-1] */
+
+} AMCFRAME;
+
+
+/* Type for reading an AMC file one frame at a time in constant memory - see parser_openMocapStream */
+typedef struct _amcstream {
+
+	FILE*		fp;
+	SKELETON*	skel;
+	char*		buf;			/* Read window - lines are tokenized in place */
+	int			buf_len;		/* Bytes held in buf */
+	int			buf_pos;		/* Start of the next unread line */
+	int			eof;			/* Nothing left to read from fp */
+	int			indegrees;		/* Inside the :degrees section */
+	int			pending;		/* Frame number line already read for the next frame, 0 if none */
+
+} AMCSTREAM;
+
+
+/* Type for parsing an AMC file that is still being written - see parser_openMocapFollow */
+typedef struct _amcfollow {
+
+	FILE*		fp;
+	char*		filename;		/* Opened again by parser_reopenMocapFollow */
+	SKELETON*	skel;
+	MOCAP*		mocap;			/* Every frame read so far, grows with the file */
+	int			frames_ready;	/* Frames 1 to frames_ready are complete (every bone read, or a later frame started) */
+	char*		buf;			/* Bytes read but not parsed yet - the start of an unfinished line */
+	int			buf_len;
+	long long	offset;			/* Bytes of the file read so far */
+	int			ps;				/* Parser state and current frame, carried from one read to the next */
+	int			frmnum;
+	int			lines;			/* Lines read so far for the current frame */
+	int			frame_lines;	/* Lines in a whole frame - the root plus every bone with a degree of freedom */
+
+} AMCFOLLOW;
+
+
+SKELETON*	parser_loadSkeleton(char* argFilename);
+MOCAP*		parser_loadMocap(char* argFilename, SKELETON* skel);
+MOCAP*		parser_loadMocapMapped(char* argFilename, SKELETON* skel);	/* As parser_loadMocap but tokenizes a memory mapped copy of the file in place */
+MOCAP*		parser_loadMocapParallel(char* argFilename, SKELETON* skel, int threads);	/* As parser_loadMocapMapped split across threads (<=0 for one per CPU) */
+void		parser_indexbones(SKELETON* skel);									/* (Re)build the bonenames lookup after filling bonearray */
+AMCSTREAM*	parser_openMocapStream(char* argFilename, SKELETON* skel);		/* Start reading an AMC file frame by frame, NULL on failure */
+int			parser_nextFrame(AMCSTREAM* stream, AMCFRAME* frame);				/* Decode the next frame into 'frame' - 0 at the end of the file */
+void		parser_rewindMocapStream(AMCSTREAM* stream);						/* Go back to the first frame */
+void		parser_closeMocapStream(AMCSTREAM* stream);
+int			parser_seekMocapStream(AMCSTREAM* stream, long long offset);		/* Continue from the frame number line at byte 'offset' (see parser_indexMocap) - 0 on failure */
+long long*	parser_indexMocap(char* argFilename, int* frames_enum);			/* Byte offset of each frame's number line, [frame-1], -1 for frames not in the file */
+AMCFOLLOW*	parser_openMocapFollow(char* argFilename, SKELETON* skel);		/* Start following an AMC file as it is written, NULL on failure */
+int			parser_followMocap(AMCFOLLOW* follow);								/* Parse whatever has been appended since the last call - number of frames that became ready */
+int			parser_reopenMocapFollow(AMCFOLLOW* follow);						/* Another file has taken the name (e.g. renamed over it) - follow that from the start, 0 if it can't be opened */
+void		parser_closeMocapFollow(AMCFOLLOW* follow);						/* Stop following and free the motion read so far */
+int			parser_saveSkeleton(char* argFilename, SKELETON* skel);			/* Write an ASF file that parser_loadSkeleton reads back identically - 0 on failure */
+int			parser_saveMocap(char* argFilename, MOCAP* mocap, SKELETON* skel);	/* Write an AMC file that parser_loadMocap reads back identically - 0 on failure */
+void		parser_frameview(AMCFRAME* frame, MOCAP* view);						/* Point a one frame MOCAP at 'frame' (e.g. for drawSkeleton) */
+int			parser_findbone(SKELETON* skel, const char* name);					/* Index of named bone in bonearray (any case), -1 if not found */
+int			parser_findbone_span(SKELETON* skel, const char* name, int len);	/* As parser_findbone for a name that isn't null terminated */
+void		parser_debugskeletonTree(SKELETON* skel);
+void		parser_free_skeleton(SKELETON* skel);
+void		parser_free_mocap(MOCAP* mocap);
+void RotateBoneDirToLocalCoordSystem(SKELETON* skel);
+void vector_rotationXYZ(POINT3D* v, float a, float b, float c);
+void matrix_transform_affine(double m[4][4], double x, double y, double z, POINT3D* v);
+void rotationX(double r[][4], float a);
+void rotationY(double r[][4], float a);
+void rotationZ(double r[][4], float a);
+
+
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*******************************************************\
+*                                                       *
+*  PLAYCLOCK.C                                          *
+*  Maps wall clock time onto clip time                  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include <math.h>
+#include "playclock.h"
+
+
+/* Internal prototypes */
+
+double	playclock_wrap(PLAYCLOCK* clock, double frame);	/* Frame brought back into [0, frames_enum) */
+
+
+PLAYCLOCK* playclock_create(double fps, int frames_enum) {
+
+	PLAYCLOCK* clock;
+
+	if (!(clock=(PLAYCLOCK*)malloc(sizeof(PLAYCLOCK))))
+		return NULL;
+
+	clock->fps=(fps>0) ? fps : PLAYCLOCK_CAPTUREFPS;
+	clock->speed=1;
+	clock->paused=0;
+	clock->frames_enum=frames_enum;
+	clock->wall_at=timer_seconds();
+	clock->frame_at=0;
+
+	return clock;
+
+}
+
+void playclock_free(PLAYCLOCK* clock) {
+
+	free(clock);
+
+}
+
+double playclock_frame(PLAYCLOCK* clock) {
+
+	if (clock->paused)
+		return clock->frame_at;
+
+	return playclock_wrap(clock,clock->frame_at+(timer_seconds()-clock->wall_at)*clock->fps*clock->speed);
+
+}
+
+void playclock_pause(PLAYCLOCK* clock, int paused) {
+
+	/* Whatever changes, the clip carries on from the frame it was showing */
+	playclock_seek(clock,playclock_frame(clock));
+	clock->paused=paused;
+
+}
+
+void playclock_setspeed(PLAYCLOCK* clock, double speed) {
+
+	playclock_seek(clock,playclock_frame(clock));
+	clock->speed=speed;
+
+}
+
+void playclock_seek(PLAYCLOCK* clock, double frame) {
+
+	clock->frame_at=playclock_wrap(clock,frame);
+	clock->wall_at=timer_seconds();
+
+}
+
+void playclock_setlength(PLAYCLOCK* clock, int frames_enum) {
+
+	double frame=playclock_frame(clock);
+
+	clock->frames_enum=frames_enum;
+	playclock_seek(clock,frame);
+
+}
+
+
+double playclock_wrap(PLAYCLOCK* clock, double frame) {
+
+	if (clock->frames_enum<=0)
+		return (frame<0) ? 0 : frame;
+
+	frame=fmod(frame,(double)clock->frames_enum);
+	if (frame<0)
+		frame+=clock->frames_enum;
+
+	return frame;
+
+}
@@ -0,0 +1,45 @@
+#ifndef COLLOMOSSE_MOCAP_PLAYCLOCK_INCLUDED
+#define COLLOMOSSE_MOCAP_PLAYCLOCK_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  PLAYCLOCK.H                                          *
+*  Maps wall clock time onto clip time                  *
+*                                                       *
+*  Gives the fractional frame to show at any instant,   *
+*  whatever the frame rate of the display, with pause,  *
+*  scrubbing and speed changes that never jump          *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "timer.h"
+
+/* Frames per second of the clips we get from the capture studio */
+#define PLAYCLOCK_CAPTUREFPS	(120.0)
+
+/* Type for a playback clock - clip time is frame_at + (now-wall_at)*fps*speed while playing */
+typedef struct _playclock {
+
+	double	fps;			/* Clip frames per second of wall time at speed 1 */
+	double	speed;			/* 1 normal, 0.5 half speed, negative plays backwards */
+	int		paused;
+	int		frames_enum;	/* Clip time wraps round at this many frames, 0 for no end */
+
+	double	wall_at;		/* timer_seconds() when the clip was last at frame_at */
+	double	frame_at;
+
+} PLAYCLOCK;
+
+
+PLAYCLOCK*	playclock_create(double fps, int frames_enum);			/* Start playing from frame 0 - fps<=0 means PLAYCLOCK_CAPTUREFPS */
+void		playclock_free(PLAYCLOCK* clock);
+double		playclock_frame(PLAYCLOCK* clock);						/* Fractional frame (0 based) to show now */
+void		playclock_pause(PLAYCLOCK* clock, int paused);			/* Stop or restart the clock where it is */
+void		playclock_setspeed(PLAYCLOCK* clock, double speed);		/* Change speed from the current frame on */
+void		playclock_seek(PLAYCLOCK* clock, double frame);			/* Jump to a frame, e.g. while scrubbing */
+void		playclock_setlength(PLAYCLOCK* clock, int frames_enum);	/* The clip grew or shrank */
+
+#endif
@@ -0,0 +1,103 @@
+/*******************************************************\
+*                                                       *
+*  POSEBUF.C                                            *
+*  Lock-free triple buffer of poses                     *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include "posebuf.h"
+
+#ifdef WIN32
+	#include "windows.h"
+#endif
+
+#define POSEBUF_FRESH	(4)		/* Bit of POSEBUF::state set by the writer and cleared by the reader */
+#define POSEBUF_INDEX	(3)		/* Bits of POSEBUF::state holding the middle slot */
+
+
+/* Internal prototypes */
+
+long	posebuf_exchange(volatile long*, long);		/* Atomically store a new state, returning the old one - a full memory barrier */
+
+
+POSEBUF* posebuf_create(RIG* rig) {
+
+	POSEBUF* buf;
+	int i;
+
+	buf=(POSEBUF*)calloc(1,sizeof(POSEBUF));
+	for (i=0; i<3; i++) {
+		buf->slots[i].pose=fk_createpose(rig);
+		fk_initialpose(rig,buf->slots[i].pose);
+	}
+
+	buf->read=0;
+	buf->state=1;
+	buf->write=2;
+
+	return buf;
+
+}
+
+void posebuf_free(POSEBUF* buf) {
+
+	int i;
+
+	for (i=0; i<3; i++)
+		fk_freepose(buf->slots[i].pose);
+	free(buf);
+
+}
+
+POSESLOT* posebuf_back(POSEBUF* buf) {
+
+	return buf->slots+buf->write;
+
+}
+
+void posebuf_publish(POSEBUF* buf) {
+
+	/* Everything written to the slot is visible before the reader can see it is fresh */
+	buf->write=(int)(posebuf_exchange(&(buf->state),buf->write|POSEBUF_FRESH)&POSEBUF_INDEX);
+
+}
+
+POSESLOT* posebuf_latest(POSEBUF* buf) {
+
+	/* Only swap for something new - otherwise keep drawing what we have.  The writer may publish again
+	   in between, which just means the slot swapped in is newer still */
+	if (buf->state&POSEBUF_FRESH)
+		buf->read=(int)(posebuf_exchange(&(buf->state),buf->read)&POSEBUF_INDEX);
+
+	return buf->slots+buf->read;
+
+}
+
+int posebuf_pending(POSEBUF* buf) {
+
+	return (buf->state&POSEBUF_FRESH)!=0;
+
+}
+
+
+long posebuf_exchange(volatile long* state, long value) {
+
+#ifdef WIN32
+	return InterlockedExchange(state,value);
+#else
+	long old;
+
+	/* The compare and swap builtins are full barriers, unlike __sync_lock_test_and_set */
+	do
+		old=*state;
+	while (__sync_val_compare_and_swap(state,old,value)!=old);
+
+	return old;
+#endif
+
+}
@@ -0,0 +1,51 @@
+#ifndef COLLOMOSSE_MOCAP_POSEBUF_INCLUDED
+#define COLLOMOSSE_MOCAP_POSEBUF_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  POSEBUF.H                                            *
+*  Lock-free triple buffer of poses                     *
+*                                                       *
+*  Hands poses from the thread working them out to the  *
+*  thread drawing them without either ever waiting -    *
+*  the reader always gets the newest finished pose      *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "fk.h"
+
+/* Type for one pose as handed over, with what the renderer needs to place the camera */
+typedef struct _poseslot {
+
+	FKPOSE*		pose;
+	POINT3D		root;			/* Root position in the AMC file's coordinates */
+	double		frame;			/* Clip time the pose is at */
+	int			posed;			/* 0 for the initial pose (nothing to follow), 1 under mocap data */
+	int			request;		/* Whatever the writer last asked to be tagged on, e.g. which key press it answers */
+
+} POSESLOT;
+
+/* Type for the buffer - the writer owns one slot, the reader another, and the third is swapped between them.
+ * state holds the index of the slot in the middle, plus POSEBUF_FRESH while the reader hasn't taken it.
+ */
+typedef struct _posebuf {
+
+	POSESLOT		slots[3];
+	int				write;			/* Writer's slot */
+	int				read;			/* Reader's slot */
+	volatile long	state;
+
+} POSEBUF;
+
+
+POSEBUF*	posebuf_create(RIG* rig);			/* Three poses of this rig, all in the initial pose */
+void		posebuf_free(POSEBUF* buf);
+POSESLOT*	posebuf_back(POSEBUF* buf);			/* Writer - the slot to fill next */
+void		posebuf_publish(POSEBUF* buf);		/* Writer - hand the filled slot over, taking the middle one back */
+POSESLOT*	posebuf_latest(POSEBUF* buf);		/* Reader - the newest published slot, kept until the next call */
+int			posebuf_pending(POSEBUF* buf);		/* Non-zero while a published slot hasn't been taken by the reader */
+
+#endif
@@ -0,0 +1,160 @@
+/*******************************************************\
+*                                                       *
+*  RIG.C                                                *
+*  Compiled skeletons                                   *
+*                                                       *
+*  Flattens the BONE tree into a parent-before-child    *
+*  array with every per-bone constant precomputed       *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include "rig.h"
+
+
+void	rig_compilebone(RIG*, SKELETON*, BONE*, int);			/* Fill in the constants of one bone */
+void	rig_tofloat(MAT3*, double[3][3]);						/* Round a double matrix to a MAT3 */
+void	rig_multiply(MAT3*, MAT3*, MAT3*);						/* a.b in double, rounded once */
+
+
+RIG* rig_compile(SKELETON* skel) {
+
+	RIG*	rig;
+	int*	stack;			/* Pairs of (bonearray index, parent's index into rig->bones) still to visit */
+	int		stack_enum;
+	BONE*	bone;
+	int		boneid, parent;
+	int		i;
+
+	rig=(RIG*)calloc(1,sizeof(RIG));
+	rig->init_position=skel->init_position;
+	rig->init_orientation=skel->init_orientation;
+	rig->bonearray_enum=skel->bonearray_enum;
+	rig->bones=(RIGBONE*)calloc(skel->bonearray_enum ? skel->bonearray_enum : 1,sizeof(RIGBONE));
+	rig->order=(int*)malloc(sizeof(int)*(skel->bonearray_enum ? skel->bonearray_enum : 1));
+	for (i=0; i<skel->bonearray_enum; i++)
+		rig->order[i]=-1;
+
+	/* Depth first with an explicit stack, children pushed last to first so they come out in file order.
+	   The parent is the bone we came from, as in drawJoints' recursion, and a bone listed under two
+	   parents is only placed the first time */
+	stack_enum=skel->children_enum;
+	for (i=0; i<skel->bonearray_enum; i++)
+		stack_enum+=skel->bonearray[i].children_enum;
+	stack=(int*)malloc(sizeof(int)*2*(stack_enum+1));
+	stack_enum=0;
+	for (i=skel->children_enum-1; i>=0; i--) {
+		stack[stack_enum++]=skel->children[i]-skel->bonearray;
+		stack[stack_enum++]=-1;
+	}
+
+	while (stack_enum) {
+		parent=stack[--stack_enum];
+		boneid=stack[--stack_enum];
+		if (rig->order[boneid]!=-1)
+			continue;
+
+		bone=skel->bonearray+boneid;
+		rig->order[boneid]=rig->bones_enum;
+		rig_compilebone(rig,skel,bone,parent);
+
+		for (i=bone->children_enum-1; i>=0; i--) {
+			if (rig->order[bone->children[i]-skel->bonearray]==-1) {
+				stack[stack_enum++]=bone->children[i]-skel->bonearray;
+				stack[stack_enum++]=rig->order[boneid];
+			}
+		}
+	}
+
+	free(stack);
+
+	return rig;
+
+}
+
+void rig_free(RIG* rig) {
+
+	free(rig->bones);
+	free(rig->order);
+	free(rig);
+
+}
+
+void rig_rotation(MAT3* m, float x, float y, float z) {
+
+	POINT3D a;
+
+	a.x=x;
+	a.y=y;
+	a.z=z;
+	euler_matrices(&a,1,EULER_EXACT,m);
+
+}
+
+
+void rig_compilebone(RIG* rig, SKELETON* skel, BONE* bone, int parent) {
+
+	RIGBONE*	rb=rig->bones+rig->bones_enum++;
+	double		c[3][3];
+	double		x, y, z, r;
+	int			i, j;
+
+	rb->bone=bone-skel->bonearray;
+	rb->parent=parent;
+	rb->xyzflags=bone->xyzflags;
+	rb->length=bone->length;
+
+	/* K and K' - a rotation's inverse is its transpose */
+	euler_matrixd(bone->axis.x*RIG_DEG2RAD,bone->axis.y*RIG_DEG2RAD,bone->axis.z*RIG_DEG2RAD,c);
+	rig_tofloat(&(rb->axis),c);
+	for (i=0; i<3; i++)
+		for (j=0; j<3; j++)
+			rb->axisinv.m[i][j]=rb->axis.m[j][i];
+
+	/* C^-1 of the parent was computed first */
+	if (parent<0)
+		rb->link=rb->axis;
+	else
+		rig_multiply(&(rb->link),&(rig->bones[parent].axisinv),&(rb->axis));
+
+	/* T - the same float products the recursive renderer passed to glTranslatef */
+	rb->offset.x=bone->direction.x*bone->length;
+	rb->offset.y=bone->direction.y*bone->length;
+	rb->offset.z=bone->direction.z*bone->length;
+
+	/* Spherical angles of the offset, as the recursive renderer worked them out: the cylinder's Z axis is turned
+	   by theta about Y and then by phi about Z */
+	x=rb->offset.x;
+	y=rb->offset.y;
+	z=rb->offset.z;
+	r=sqrt(x*x+y*y+z*z);
+	euler_matrixd(0,(r>0) ? acos(z/r) : 0,atan2(y,x),c);
+	rig_tofloat(&(rb->cylinder),c);
+
+}
+
+void rig_tofloat(MAT3* out, double m[3][3]) {
+
+	int i, j;
+
+	for (i=0; i<3; i++)
+		for (j=0; j<3; j++)
+			out->m[i][j]=(float)m[i][j];
+
+}
+
+void rig_multiply(MAT3* out, MAT3* a, MAT3* b) {
+
+	double m[3][3];
+	int i, j;
+
+	for (i=0; i<3; i++)
+		for (j=0; j<3; j++)
+			m[i][j]=(double)a->m[i][0]*b->m[0][j]+(double)a->m[i][1]*b->m[1][j]+(double)a->m[i][2]*b->m[2][j];
+
+	rig_tofloat(out,m);
+
+}
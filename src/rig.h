@@ -0,0 +1,54 @@
+#ifndef COLLOMOSSE_MOCAP_RIG_INCLUDED
+#define COLLOMOSSE_MOCAP_RIG_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  RIG.H                                                *
+*  Compiled skeletons                                   *
+*                                                       *
+*  Flattens the BONE tree into a parent-before-child    *
+*  array with every per-bone constant precomputed       *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "euler.h"
+
+/* Degrees to radians, as glRotatef converts them */
+#define RIG_DEG2RAD		EULER_DEG2RAD
+
+/* Type for one bone of a compiled skeleton - the constants of its step in the K.R.T.K' chain */
+typedef struct _rigbone {
+
+	int		bone;			/* Index into SKELETON::bonearray, and so into MOCAP::bones_orient[frame] */
+	int		parent;			/* Index into RIG::bones of the parent (always lower), -1 for children of the root */
+	int		xyzflags;		/* DOF_FLAG_ bits of the bone */
+	MAT3	axis;			/* C = Rz(axis.z).Ry(axis.y).Rx(axis.x) - K in the K.R.T.K' chain */
+	MAT3	axisinv;		/* C^-1 (its transpose) - K' */
+	MAT3	link;			/* C^-1 of the parent times C - leaves the parent's axis frame and enters this one in one step (C for children of the root) */
+	POINT3D	offset;			/* direction*length - T, the end of the bone in its own axis frame */
+	MAT3	cylinder;		/* Rz(phi).Ry(theta), turning +Z onto offset to draw the bone as a cylinder */
+	float	length;
+
+} RIGBONE;
+
+/* Type for representing a compiled skeleton */
+typedef struct _rig {
+
+	POINT3D		init_position;		/* Root translation and orientation of the initial pose (as SKELETON) */
+	POINT3D		init_orientation;
+	int			bones_enum;		/* Bones reachable from the root - the ones drawSkeleton draws */
+	RIGBONE*	bones;			/* Depth first from the root's children, every parent before its children */
+	int			bonearray_enum;	/* Size of the skeleton's bonearray */
+	int*		order;			/* order[bonearray index] = index into bones, -1 for a bone not reachable from the root */
+
+} RIG;
+
+
+RIG*	rig_compile(SKELETON* skel);		/* Compile a loaded skeleton - the skeleton may be freed afterwards */
+void	rig_free(RIG* rig);
+void	rig_rotation(MAT3* m, float x, float y, float z);	/* m = Rz(z).Ry(y).Rx(x), angles in degrees (as three glRotatef calls) */
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef COLLOMOSSE_MOCAP_SIMD_INCLUDED
+#define COLLOMOSSE_MOCAP_SIMD_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  SIMD.H                                               *
+*  Vector operations on floats, as wide as the target   *
+*                                                       *
+*  Kernels written once with these macros on SIMDVEC    *
+*  run SIMD_WIDTH lanes at a time with AVX2 or SSE2,    *
+*  or one at a time in plain C                          *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define SIMD_WIDTH		(8)
+	#define SIMD_ISA		"AVX2"
+	typedef __m256			SIMDVEC;
+	typedef __m256i			SIMDVECI;
+	#define V_SET1(a)		_mm256_set1_ps(a)
+	#define V_LOAD(p)		_mm256_loadu_ps(p)
+	#define V_STORE(p,a)	_mm256_storeu_ps(p,a)
+	#define V_ADD(a,b)		_mm256_add_ps(a,b)
+	#define V_SUB(a,b)		_mm256_sub_ps(a,b)
+	#define V_MUL(a,b)		_mm256_mul_ps(a,b)
+	#define V_ROUND(a)		_mm256_cvtps_epi32(a)
+	#define V_FROMINT(a)	_mm256_cvtepi32_ps(a)
+	#define V_SELECT(m,a,b)	_mm256_blendv_ps(b,a,_mm256_castsi256_ps(m))
+	#define V_FLIP(a,m)		_mm256_xor_ps(a,_mm256_castsi256_ps(m))
+	#define VI_SET1(a)		_mm256_set1_epi32(a)
+	#define VI_ADD(a,b)		_mm256_add_epi32(a,b)
+	#define VI_AND(a,b)		_mm256_and_si256(a,b)
+	#define VI_CMPEQ(a,b)	_mm256_cmpeq_epi32(a,b)
+	#define VI_SHL(a,n)		_mm256_slli_epi32(a,n)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+	#include <emmintrin.h>
+	#define SIMD_WIDTH		(4)
+	#define SIMD_ISA		"SSE2"
+	typedef __m128			SIMDVEC;
+	typedef __m128i			SIMDVECI;
+	#define V_SET1(a)		_mm_set1_ps(a)
+	#define V_LOAD(p)		_mm_loadu_ps(p)
+	#define V_STORE(p,a)	_mm_storeu_ps(p,a)
+	#define V_ADD(a,b)		_mm_add_ps(a,b)
+	#define V_SUB(a,b)		_mm_sub_ps(a,b)
+	#define V_MUL(a,b)		_mm_mul_ps(a,b)
+	#define V_ROUND(a)		_mm_cvtps_epi32(a)
+	#define V_FROMINT(a)	_mm_cvtepi32_ps(a)
+	#define V_SELECT(m,a,b)	_mm_or_ps(_mm_and_ps(_mm_castsi128_ps(m),a),_mm_andnot_ps(_mm_castsi128_ps(m),b))
+	#define V_FLIP(a,m)		_mm_xor_ps(a,_mm_castsi128_ps(m))
+	#define VI_SET1(a)		_mm_set1_epi32(a)
+	#define VI_ADD(a,b)		_mm_add_epi32(a,b)
+	#define VI_AND(a,b)		_mm_and_si128(a,b)
+	#define VI_CMPEQ(a,b)	_mm_cmpeq_epi32(a,b)
+	#define VI_SHL(a,n)		_mm_slli_epi32(a,n)
+#else
+	#define SIMD_WIDTH		(1)
+	#define SIMD_ISA		"scalar"
+	#define SIMD_SCALAR
+	typedef float			SIMDVEC;
+	#define V_SET1(a)		(a)
+	#define V_LOAD(p)		(*(p))
+	#define V_STORE(p,a)	(*(p)=(a))
+	#define V_ADD(a,b)		((a)+(b))
+	#define V_SUB(a,b)		((a)-(b))
+	#define V_MUL(a,b)		((a)*(b))
+#endif
+
+#endif
@@ -0,0 +1,342 @@
+/*******************************************************\
+*                                                       *
+*  THREADPOOL.C                                         *
+*  Fixed size pool of work-stealing worker threads      *
+*                                                       *
+*  Runs independent jobs (e.g. chunks of an AMC file)   *
+*  on every core, idle workers stealing from busy ones  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "threadpool.h"
+
+#ifndef WIN32
+	#include <unistd.h>
+	#include <time.h>
+#endif
+
+#define THREADPOOL_INITIAL_QUEUE	(64)	/* Job slots allocated up front in each deque, doubled when full */
+
+/* Internal prototypes */
+
+void	deque_push		(THREADDEQUE*, THREADJOB, void*);	/* Add a job at the newest end */
+int		deque_popnewest	(THREADDEQUE*, THREADJOBENTRY*);	/* Owner's end - 0 if empty */
+int		deque_popoldest	(THREADDEQUE*, THREADJOBENTRY*);	/* Thieves' end - 0 if empty */
+int		threadpool_take	(THREADPOOL*, int, THREADJOBENTRY*);	/* Next job for a worker, its own or stolen - 0 if none */
+
+#ifdef WIN32
+DWORD WINAPI threadpool_worker(LPVOID arg);		/* Worker thread main loop */
+#else
+void*	threadpool_worker(void* arg);			/* Worker thread main loop */
+#endif
+
+
+THREADPOOL* threadpool_create(int threads) {
+
+	THREADPOOL* pool;
+	int i;
+
+	if (threads<=0)
+		threads=threadpool_cpucount();
+
+	pool=(THREADPOOL*)calloc(1,sizeof(THREADPOOL));
+	pool->threads_enum=threads;
+	pool->threads=(THREAD*)calloc(threads,sizeof(THREAD));
+	pool->workers=(THREADWORKER*)calloc(threads,sizeof(THREADWORKER));
+	pool->deques=(THREADDEQUE*)calloc(threads,sizeof(THREADDEQUE));
+
+	/* Before any worker starts, so each can find itself from its very first job */
+#ifdef WIN32
+	pool->self=TlsAlloc();
+#else
+	pthread_key_create(&(pool->self),NULL);
+#endif
+
+	mutex_init(&(pool->lock));
+	condvar_init(&(pool->jobready));
+	condvar_init(&(pool->alldone));
+
+	for (i=0; i<threads; i++) {
+		mutex_init(&(pool->deques[i].lock));
+		pool->deques[i].jobs_alloc=THREADPOOL_INITIAL_QUEUE;
+		pool->deques[i].jobs=(THREADJOBENTRY*)malloc(sizeof(THREADJOBENTRY)*THREADPOOL_INITIAL_QUEUE);
+		pool->workers[i].pool=pool;
+		pool->workers[i].index=i;
+	}
+
+	for (i=0; i<threads; i++) {
+#ifdef WIN32
+		pool->threads[i]=CreateThread(NULL,0,threadpool_worker,pool->workers+i,0,NULL);
+#else
+		pthread_create(pool->threads+i,NULL,threadpool_worker,pool->workers+i);
+#endif
+	}
+
+	return pool;
+
+}
+
+void threadpool_submit(THREADPOOL* pool, THREADJOB fn, void* arg) {
+
+	int d=threadpool_self(pool);
+
+	/* Count the job before it can be run, so pending never drops to zero early */
+	mutex_lock(&(pool->lock));
+	pool->pending++;
+	if (d==-1)
+		d=pool->next=(pool->next+1)%pool->threads_enum;
+	mutex_unlock(&(pool->lock));
+
+	/* Jobs made by a job stay with its worker (and hot in its cache) until someone steals them */
+	deque_push(pool->deques+d,fn,arg);
+
+	mutex_lock(&(pool->lock));
+	pool->queued++;
+	condvar_broadcast(&(pool->jobready));
+	mutex_unlock(&(pool->lock));
+
+}
+
+void threadpool_wait(THREADPOOL* pool) {
+
+	mutex_lock(&(pool->lock));
+	while (pool->pending)
+		condvar_wait(&(pool->alldone),&(pool->lock));
+	mutex_unlock(&(pool->lock));
+
+}
+
+void threadpool_destroy(THREADPOOL* pool) {
+
+	int i;
+
+	threadpool_wait(pool);
+
+	mutex_lock(&(pool->lock));
+	pool->shutdown=1;
+	condvar_broadcast(&(pool->jobready));
+	mutex_unlock(&(pool->lock));
+
+	for (i=0; i<pool->threads_enum; i++) {
+#ifdef WIN32
+		WaitForSingleObject(pool->threads[i],INFINITE);
+		CloseHandle(pool->threads[i]);
+#else
+		pthread_join(pool->threads[i],NULL);
+#endif
+	}
+
+	for (i=0; i<pool->threads_enum; i++) {
+		mutex_destroy(&(pool->deques[i].lock));
+		free(pool->deques[i].jobs);
+	}
+
+	condvar_destroy(&(pool->alldone));
+	condvar_destroy(&(pool->jobready));
+	mutex_destroy(&(pool->lock));
+#ifdef WIN32
+	TlsFree(pool->self);
+#else
+	pthread_key_delete(pool->self);
+#endif
+	free(pool->deques);
+	free(pool->workers);
+	free(pool->threads);
+	free(pool);
+
+}
+
+int threadpool_self(THREADPOOL* pool) {
+
+	THREADWORKER* w;
+
+#ifdef WIN32
+	w=(THREADWORKER*)TlsGetValue(pool->self);
+#else
+	w=(THREADWORKER*)pthread_getspecific(pool->self);
+#endif
+
+	return w ? w->index : -1;
+
+}
+
+#ifdef WIN32
+DWORD WINAPI threadpool_worker(LPVOID arg) {
+#else
+void* threadpool_worker(void* arg) {
+#endif
+
+	THREADPOOL*		pool=((THREADWORKER*)arg)->pool;
+	int				self=((THREADWORKER*)arg)->index;
+	THREADJOBENTRY	job;
+
+#ifdef WIN32
+	TlsSetValue(pool->self,arg);
+#else
+	pthread_setspecific(pool->self,arg);
+#endif
+
+	while (1) {
+		if (threadpool_take(pool,self,&job)) {
+			/* Run the job without holding any lock */
+			job.fn(job.arg);
+
+			mutex_lock(&(pool->lock));
+			if (!--pool->pending)
+				condvar_broadcast(&(pool->alldone));
+			mutex_unlock(&(pool->lock));
+			continue;
+		}
+
+		/* Nothing anywhere - sleep until a job is queued */
+		mutex_lock(&(pool->lock));
+		while (pool->queued<=0 && !pool->shutdown)
+			condvar_wait(&(pool->jobready),&(pool->lock));
+		if (pool->queued<=0) {
+			mutex_unlock(&(pool->lock));
+			break;
+		}
+		mutex_unlock(&(pool->lock));
+	}
+
+	return 0;
+
+}
+
+int threadpool_take(THREADPOOL* pool, int self, THREADJOBENTRY* job) {
+
+	int i, found;
+
+	/* Own work first, newest first - then the oldest job of each other worker in turn */
+	found=deque_popnewest(pool->deques+self,job);
+	for (i=1; !found && i<pool->threads_enum; i++)
+		found=deque_popoldest(pool->deques+(self+i)%pool->threads_enum,job);
+
+	if (found) {
+		mutex_lock(&(pool->lock));
+		pool->queued--;
+		mutex_unlock(&(pool->lock));
+	}
+
+	return found;
+
+}
+
+
+void deque_push(THREADDEQUE* dq, THREADJOB fn, void* arg) {
+
+	THREADJOBENTRY* grown;
+	int i;
+
+	mutex_lock(&(dq->lock));
+
+	if (dq->jobs_enum==dq->jobs_alloc) {
+		/* Unwrap the ring into one twice the size */
+		grown=(THREADJOBENTRY*)malloc(sizeof(THREADJOBENTRY)*dq->jobs_alloc*2);
+		for (i=0; i<dq->jobs_enum; i++)
+			grown[i]=dq->jobs[(dq->head+i)%dq->jobs_alloc];
+		free(dq->jobs);
+		dq->jobs=grown;
+		dq->head=0;
+		dq->jobs_alloc*=2;
+	}
+
+	dq->jobs[(dq->head+dq->jobs_enum)%dq->jobs_alloc].fn=fn;
+	dq->jobs[(dq->head+dq->jobs_enum)%dq->jobs_alloc].arg=arg;
+	dq->jobs_enum++;
+
+	mutex_unlock(&(dq->lock));
+
+}
+
+int deque_popnewest(THREADDEQUE* dq, THREADJOBENTRY* job) {
+
+	int found;
+
+	mutex_lock(&(dq->lock));
+	if ((found=(dq->jobs_enum>0))) {
+		dq->jobs_enum--;
+		*job=dq->jobs[(dq->head+dq->jobs_enum)%dq->jobs_alloc];
+	}
+	mutex_unlock(&(dq->lock));
+
+	return found;
+
+}
+
+int deque_popoldest(THREADDEQUE* dq, THREADJOBENTRY* job) {
+
+	int found;
+
+	mutex_lock(&(dq->lock));
+	if ((found=(dq->jobs_enum>0))) {
+		*job=dq->jobs[dq->head];
+		dq->head=(dq->head+1)%dq->jobs_alloc;
+		dq->jobs_enum--;
+	}
+	mutex_unlock(&(dq->lock));
+
+	return found;
+
+}
+
+int threadpool_cpucount(void) {
+
+#ifdef WIN32
+	SYSTEM_INFO si;
+
+	GetSystemInfo(&si);
+	return (int)si.dwNumberOfProcessors;
+#else
+	long n=sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (n>0) ? (int)n : 1;
+#endif
+
+}
+
+
+#ifdef WIN32
+
+void mutex_init(MUTEX* m)						{ InitializeCriticalSection(m); }
+void mutex_destroy(MUTEX* m)					{ DeleteCriticalSection(m); }
+void mutex_lock(MUTEX* m)						{ EnterCriticalSection(m); }
+void mutex_unlock(MUTEX* m)						{ LeaveCriticalSection(m); }
+void condvar_init(CONDVAR* c)					{ InitializeConditionVariable(c); }
+void condvar_destroy(CONDVAR* c)				{ }
+void condvar_wait(CONDVAR* c, MUTEX* m)			{ SleepConditionVariableCS(c,m,INFINITE); }
+void condvar_timedwait(CONDVAR* c, MUTEX* m, double seconds)	{ SleepConditionVariableCS(c,m,(DWORD)(seconds*1000)); }
+void condvar_broadcast(CONDVAR* c)				{ WakeAllConditionVariable(c); }
+
+#else
+
+void mutex_init(MUTEX* m)						{ pthread_mutex_init(m,NULL); }
+void mutex_destroy(MUTEX* m)					{ pthread_mutex_destroy(m); }
+void mutex_lock(MUTEX* m)						{ pthread_mutex_lock(m); }
+void mutex_unlock(MUTEX* m)						{ pthread_mutex_unlock(m); }
+void condvar_init(CONDVAR* c)					{ pthread_cond_init(c,NULL); }
+void condvar_destroy(CONDVAR* c)				{ pthread_cond_destroy(c); }
+void condvar_wait(CONDVAR* c, MUTEX* m)			{ pthread_cond_wait(c,m); }
+void condvar_broadcast(CONDVAR* c)				{ pthread_cond_broadcast(c); }
+
+void condvar_timedwait(CONDVAR* c, MUTEX* m, double seconds) {
+
+	struct timespec	until;
+	long long		ns;
+
+	/* pthread_cond_timedwait wants an absolute time on the realtime clock */
+	clock_gettime(CLOCK_REALTIME,&until);
+	ns=until.tv_nsec+(long long)(seconds*1e9);
+	until.tv_sec+=(time_t)(ns/1000000000);
+	until.tv_nsec=(long)(ns%1000000000);
+	pthread_cond_timedwait(c,m,&until);
+
+}
+
+#endif
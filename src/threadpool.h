@@ -0,0 +1,99 @@
+#ifndef COLLOMOSSE_MOCAP_THREADPOOL_INCLUDED
+#define COLLOMOSSE_MOCAP_THREADPOOL_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  THREADPOOL.H                                         *
+*  Fixed size pool of work-stealing worker threads      *
+*                                                       *
+*  Runs independent jobs (e.g. chunks of an AMC file)   *
+*  on every core, idle workers stealing from busy ones  *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#ifdef WIN32
+	#include "windows.h"
+	typedef HANDLE				THREAD;
+	typedef CRITICAL_SECTION	MUTEX;
+	typedef CONDITION_VARIABLE	CONDVAR;	/* Windows Vista or later */
+	typedef DWORD				TLSKEY;
+#else
+	#include <pthread.h>
+	typedef pthread_t			THREAD;
+	typedef pthread_mutex_t		MUTEX;
+	typedef pthread_cond_t		CONDVAR;
+	typedef pthread_key_t		TLSKEY;
+#endif
+
+/* A job is a function run once on some worker with its argument */
+typedef void (*THREADJOB)(void* arg);
+
+typedef struct _threadjob {
+
+	THREADJOB	fn;
+	void*		arg;
+
+} THREADJOBENTRY;
+
+/* Jobs waiting on one worker - the owner takes the newest, idle workers steal the oldest */
+typedef struct _threaddeque {
+
+	MUTEX			lock;			/* Protects this deque only */
+	THREADJOBENTRY*	jobs;			/* Circular buffer */
+	int				jobs_alloc;
+	int				head;			/* Oldest job */
+	int				jobs_enum;
+
+} THREADDEQUE;
+
+/* Start up argument of each worker */
+typedef struct _threadworker {
+
+	struct _threadpool*	pool;
+	int					index;		/* Worker number, also its deque */
+
+} THREADWORKER;
+
+/* Type for representing the pool */
+typedef struct _threadpool {
+
+	int				threads_enum;	/* Number of worker threads */
+	THREAD*			threads;
+	THREADWORKER*	workers;
+	THREADDEQUE*	deques;			/* One per worker */
+	TLSKEY			self;			/* Each worker's own THREADWORKER, NULL on any other thread */
+
+	MUTEX			lock;			/* Protects everything below */
+	CONDVAR			jobready;		/* Signalled when a job is queued or the pool shuts down */
+	CONDVAR			alldone;		/* Signalled when the last outstanding job finishes */
+
+	int				queued;			/* Jobs sitting in the deques (may dip below zero briefly) */
+	int				pending;		/* Jobs queued or running */
+	int				next;			/* Deque given the next job submitted from outside the pool */
+	int				shutdown;
+
+} THREADPOOL;
+
+
+THREADPOOL*	threadpool_create(int threads);									/* Start a pool - threads<=0 means one per CPU */
+void		threadpool_submit(THREADPOOL* pool, THREADJOB fn, void* arg);	/* Queue a job - on the caller's own deque when called from a job */
+void		threadpool_wait(THREADPOOL* pool);								/* Block until every queued job has finished */
+void		threadpool_destroy(THREADPOOL* pool);							/* Finish outstanding jobs and stop the workers */
+int			threadpool_self(THREADPOOL* pool);								/* Index of the calling worker (0 to threads_enum-1), -1 outside the pool */
+int			threadpool_cpucount(void);										/* Number of logical CPUs */
+
+/* Thin wrappers over the native threading primitives */
+void		mutex_init(MUTEX* m);
+void		mutex_destroy(MUTEX* m);
+void		mutex_lock(MUTEX* m);
+void		mutex_unlock(MUTEX* m);
+void		condvar_init(CONDVAR* c);
+void		condvar_destroy(CONDVAR* c);
+void		condvar_wait(CONDVAR* c, MUTEX* m);
+void		condvar_timedwait(CONDVAR* c, MUTEX* m, double seconds);		/* As condvar_wait, giving up after about this long */
+void		condvar_broadcast(CONDVAR* c);
+
+#endif
@@ -0,0 +1,52 @@
+/*******************************************************\
+*                                                       *
+*  TIMER.C                                              *
+*  High resolution monotonic timer                      *
+*                                                       *
+*  Used by the benchmarks to time the parsers           *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#ifndef WIN32
+	#define _POSIX_C_SOURCE 199309L
+	#include <time.h>
+#endif
+
+#include "timer.h"
+
+
+double timer_seconds(void) {
+
+#ifdef WIN32
+	LARGE_INTEGER freq, now;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+
+	return (double)now.QuadPart/(double)freq.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+
+	return (double)ts.tv_sec+(double)ts.tv_nsec*1e-9;
+#endif
+
+}
+
+void timer_sleep(double seconds) {
+
+#ifdef WIN32
+	Sleep((DWORD)(seconds*1000));
+#else
+	struct timespec ts;
+
+	ts.tv_sec=(time_t)seconds;
+	ts.tv_nsec=(long)((seconds-(double)ts.tv_sec)*1e9);
+	nanosleep(&ts,NULL);
+#endif
+
+}
@@ -0,0 +1,23 @@
+#ifndef COLLOMOSSE_MOCAP_TIMER_INCLUDED
+#define COLLOMOSSE_MOCAP_TIMER_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  TIMER.H                                              *
+*  High resolution monotonic timer                      *
+*                                                       *
+*  Used by the benchmarks to time the parsers           *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#ifdef WIN32
+	#include "windows.h"
+#endif
+
+double	timer_seconds(void);		/* Seconds elapsed since an arbitrary fixed point (never goes backwards) */
+void	timer_sleep(double seconds);	/* Give up the CPU for about this long */
+
+#endif
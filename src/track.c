@@ -0,0 +1,273 @@
+/*******************************************************\
+*                                                       *
+*  TRACK.C                                              *
+*  Quaternion pose tracks sampled at any time           *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+
+#include <math.h>
+#include "track.h"
+
+/*
+ * SLERP without trig: sin(t.a)/sin(a) as a series in powers of (cos(a)-1), eight terms evaluated
+ * Horner fashion as t.(1+(u_1.t^2-v_1).(cos(a)-1).(1+...)) with u_i=1/(i(2i+1)) and v_i=i/(2i+1),
+ * the last term scaled by mu to make up for the ones left out.  Off by less than 1e-15 for the few
+ * degrees between captured frames, 2e-5 at worst for a bone turning half way round in one frame
+ */
+#define TRACK_SLERPTERMS	(8)
+#define TRACK_SLERPMU		(1.85298109240830)
+
+/* Parts of a quaternion smaller than this are stored as 0 - near-zero axis angles otherwise leave
+   denormals whose products slow every sample of the track down several times over */
+#define TRACK_TINY			(1e-12f)
+
+const double track_slerpu[TRACK_SLERPTERMS]={1/3.,1/10.,1/21.,1/36.,1/55.,1/78.,1/105.,TRACK_SLERPMU/136.};
+const double track_slerpv[TRACK_SLERPTERMS]={1/3.,2/5.,3/7.,4/9.,5/11.,6/13.,7/15.,TRACK_SLERPMU*8./17.};
+
+
+/* Internal prototypes */
+
+void	track_fromrotation(MAT3*, QUAT*);				/* Quaternion of a rotation matrix */
+void	track_torotation(float*, int, int, MAT3*);		/* Rotation matrix of entry i of rows of n quaternions */
+void	track_multiply(QUAT*, QUAT*, QUAT*);			/* a.b */
+
+
+POSETRACK* track_create(RIG* rig, MOCAP* mocap) {
+
+	POSETRACK*	track;
+	QUAT*		links;			/* link of each rig bone */
+	QUAT*		bones;			/* R of each skeleton bone at a frame */
+	QUAT		q;
+	float*		row;
+	float*		prev;
+	float		dot;
+	int			f, i, n;
+
+	track=(POSETRACK*)calloc(1,sizeof(POSETRACK));
+	track->frames_enum=mocap->frames_enum;
+	track->quats_enum=n=rig->bones_enum+1;
+	track->root_pos=(POINT3D*)malloc(sizeof(POINT3D)*(mocap->frames_enum ? mocap->frames_enum : 1));
+	track->quats=(float*)malloc(sizeof(float)*4*n*(size_t)(mocap->frames_enum ? mocap->frames_enum : 1));
+
+	links=(QUAT*)malloc(sizeof(QUAT)*n);
+	bones=(QUAT*)malloc(sizeof(QUAT)*(rig->bonearray_enum ? rig->bonearray_enum : 1));
+	for (i=0; i<rig->bones_enum; i++)
+		track_fromrotation(&(rig->bones[i].link),links+i);
+
+	for (f=0; f<mocap->frames_enum; f++) {
+		row=track->quats+(size_t)f*4*n;
+		track->root_pos[f]=mocap->root_pos[f];
+
+		euler_quats(mocap->root_orient+f,1,EULER_EXACT,&q);
+		row[0]=q.w;	row[n]=q.x;	row[2*n]=q.y;	row[3*n]=q.z;
+
+		euler_quats(mocap->bones_orient[f],rig->bonearray_enum,EULER_EXACT,bones);
+		for (i=0; i<rig->bones_enum; i++) {
+			track_multiply(&q,links+i,bones+rig->bones[i].bone);
+			row[1+i]=q.w;	row[n+1+i]=q.x;	row[2*n+1+i]=q.y;	row[3*n+1+i]=q.z;
+		}
+
+		for (i=0; i<4*n; i++)
+			if (row[i]<TRACK_TINY && row[i]>-TRACK_TINY)
+				row[i]=0;
+
+		/* q and -q are the same rotation - take whichever is nearer the last frame */
+		if (f) {
+			prev=row-4*n;
+			for (i=0; i<n; i++) {
+				dot=row[i]*prev[i]+row[n+i]*prev[n+i]+row[2*n+i]*prev[2*n+i]+row[3*n+i]*prev[3*n+i];
+				if (dot<0) {
+					row[i]=-row[i];
+					row[n+i]=-row[n+i];
+					row[2*n+i]=-row[2*n+i];
+					row[3*n+i]=-row[3*n+i];
+				}
+			}
+		}
+	}
+
+	free(bones);
+	free(links);
+
+	return track;
+
+}
+
+void track_free(POSETRACK* track) {
+
+	free(track->root_pos);
+	free(track->quats);
+	free(track);
+
+}
+
+TRACKPOSE* track_createpose(POSETRACK* track) {
+
+	TRACKPOSE* sample;
+
+	sample=(TRACKPOSE*)calloc(1,sizeof(TRACKPOSE));
+	sample->quats_enum=track->quats_enum;
+	sample->quats=(float*)calloc(4*track->quats_enum,sizeof(float));
+	sample->weights=(float*)calloc(2*track->quats_enum,sizeof(float));
+
+	return sample;
+
+}
+
+void track_freepose(TRACKPOSE* sample) {
+
+	free(sample->quats);
+	free(sample->weights);
+	free(sample);
+
+}
+
+void track_sample(POSETRACK* track, double frame, int mode, TRACKPOSE* sample) {
+
+	float		bt[TRACK_SLERPTERMS], bd[TRACK_SLERPTERMS];
+	float*		a;				/* Rows of the frame before */
+	float*		b;				/* and after */
+	float*		out;
+	float*		ca;				/* Weight of a and of b for each bone */
+	float*		cb;
+	float		t, d, x, len;
+	int			f, g, i, k, n=track->quats_enum;
+
+	if (!track->frames_enum)
+		return;
+
+	/* The two frames either side, t of the way from one to the other */
+	if (frame<0)
+		frame=0;
+	if (frame>track->frames_enum-1)
+		frame=track->frames_enum-1;
+	f=(int)frame;
+	if (f>track->frames_enum-2)
+		f=(track->frames_enum>1) ? track->frames_enum-2 : 0;
+	g=(track->frames_enum>1) ? f+1 : f;
+	t=(float)(frame-f);
+	d=1-t;
+	a=track->quats+(size_t)f*4*n;
+	b=track->quats+(size_t)g*4*n;
+	out=sample->quats;
+	ca=sample->weights;
+	cb=sample->weights+n;
+
+	sample->root_pos.x=d*track->root_pos[f].x+t*track->root_pos[g].x;
+	sample->root_pos.y=d*track->root_pos[f].y+t*track->root_pos[g].y;
+	sample->root_pos.z=d*track->root_pos[f].z+t*track->root_pos[g].z;
+
+	/*
+	 * Every bone is out = ca.a + cb.b, done as short passes along whole rows of bones with few enough
+	 * pointers in each loop for the compiler to run several bones at once down the vector unit
+	 */
+	if (mode==TRACK_SLERP) {
+		/* The series only depends on the bone through the dot product, so the rest is shared */
+		for (k=0; k<TRACK_SLERPTERMS; k++) {
+			bt[k]=(float)(track_slerpu[k]*t*t-track_slerpv[k]);
+			bd[k]=(float)(track_slerpu[k]*d*d-track_slerpv[k]);
+		}
+		for (i=0; i<n; i++)
+			cb[i]=a[i]*b[i]+a[n+i]*b[n+i]+a[2*n+i]*b[2*n+i]+a[3*n+i]*b[3*n+i]-1;
+		for (i=0; i<n; i++) {
+			x=cb[i];
+			ca[i]=d*(1+bd[0]*x*(1+bd[1]*x*(1+bd[2]*x*(1+bd[3]*x*(1+bd[4]*x*(1+bd[5]*x*(1+bd[6]*x*(1+bd[7]*x))))))));
+			cb[i]=t*(1+bt[0]*x*(1+bt[1]*x*(1+bt[2]*x*(1+bt[3]*x*(1+bt[4]*x*(1+bt[5]*x*(1+bt[6]*x*(1+bt[7]*x))))))));
+		}
+		for (k=0; k<4*n; k+=n)
+			for (i=0; i<n; i++)
+				out[k+i]=ca[i]*a[k+i]+cb[i]*b[k+i];
+	}
+	else {
+		for (i=0; i<4*n; i++)
+			out[i]=d*a[i]+t*b[i];
+
+		/* Neighbouring frames are in the same hemisphere, so the blend is between 1/sqrt(2) and 1 long
+		   and three Newton steps from a straight line guess at 1/sqrt normalise it to a float */
+		for (i=0; i<n; i++) {
+			x=out[i]*out[i]+out[n+i]*out[n+i]+out[2*n+i]*out[2*n+i]+out[3*n+i]*out[3*n+i];
+			len=1.8f-0.8f*x;
+			len=len*(1.5f-0.5f*x*len*len);
+			len=len*(1.5f-0.5f*x*len*len);
+			ca[i]=len*(1.5f-0.5f*x*len*len);
+		}
+		for (k=0; k<4*n; k+=n)
+			for (i=0; i<n; i++)
+				out[k+i]*=ca[i];
+	}
+
+}
+
+void track_pose(RIG* rig, TRACKPOSE* sample, FKPOSE* pose) {
+
+	MAT3	root;
+	int		i;
+
+	track_torotation(sample->quats,sample->quats_enum,0,&root);
+	for (i=0; i<rig->bones_enum; i++)
+		track_torotation(sample->quats,sample->quats_enum,1+i,pose->locals+i);
+
+	fk_chain(rig,&root,&(sample->root_pos),pose);
+
+}
+
+
+void track_fromrotation(MAT3* r, QUAT* q) {
+
+	double	m00=r->m[0][0], m11=r->m[1][1], m22=r->m[2][2];
+	double	s;
+
+	/* From whichever of w, x, y, z is largest, so the division is never by something small */
+	if (m00+m11+m22>0) {
+		s=0.5/sqrt(1+m00+m11+m22);
+		q->w=(float)(0.25/s);
+		q->x=(float)((r->m[2][1]-r->m[1][2])*s);
+		q->y=(float)((r->m[0][2]-r->m[2][0])*s);
+		q->z=(float)((r->m[1][0]-r->m[0][1])*s);
+	}
+	else if (m00>m11 && m00>m22) {
+		s=2*sqrt(1+m00-m11-m22);
+		q->w=(float)((r->m[2][1]-r->m[1][2])/s);
+		q->x=(float)(0.25*s);
+		q->y=(float)((r->m[0][1]+r->m[1][0])/s);
+		q->z=(float)((r->m[0][2]+r->m[2][0])/s);
+	}
+	else if (m11>m22) {
+		s=2*sqrt(1+m11-m00-m22);
+		q->w=(float)((r->m[0][2]-r->m[2][0])/s);
+		q->x=(float)((r->m[0][1]+r->m[1][0])/s);
+		q->y=(float)(0.25*s);
+		q->z=(float)((r->m[1][2]+r->m[2][1])/s);
+	}
+	else {
+		s=2*sqrt(1+m22-m00-m11);
+		q->w=(float)((r->m[1][0]-r->m[0][1])/s);
+		q->x=(float)((r->m[0][2]+r->m[2][0])/s);
+		q->y=(float)((r->m[1][2]+r->m[2][1])/s);
+		q->z=(float)(0.25*s);
+	}
+
+}
+
+void track_torotation(float* rows, int n, int i, MAT3* r) {
+
+	float w=rows[i], x=rows[n+i], y=rows[2*n+i], z=rows[3*n+i];
+
+	r->m[0][0]=1-2*(y*y+z*z);	r->m[0][1]=2*(x*y-w*z);		r->m[0][2]=2*(x*z+w*y);
+	r->m[1][0]=2*(x*y+w*z);		r->m[1][1]=1-2*(x*x+z*z);	r->m[1][2]=2*(y*z-w*x);
+	r->m[2][0]=2*(x*z-w*y);		r->m[2][1]=2*(y*z+w*x);		r->m[2][2]=1-2*(x*x+y*y);
+
+}
+
+void track_multiply(QUAT* out, QUAT* a, QUAT* b) {
+
+	out->w=a->w*b->w-a->x*b->x-a->y*b->y-a->z*b->z;
+	out->x=a->w*b->x+a->x*b->w+a->y*b->z-a->z*b->y;
+	out->y=a->w*b->y-a->x*b->z+a->y*b->w+a->z*b->x;
+	out->z=a->w*b->z+a->x*b->y-a->y*b->x+a->z*b->w;
+
+}
@@ -0,0 +1,54 @@
+#ifndef COLLOMOSSE_MOCAP_TRACK_INCLUDED
+#define COLLOMOSSE_MOCAP_TRACK_INCLUDED
+
+/*******************************************************\
+*                                                       *
+*  TRACK.H                                              *
+*  Quaternion pose tracks sampled at any time           *
+*                                                       *
+*  Turns a clip's Euler angles into one quaternion per  *
+*  bone per frame, then blends neighbouring frames with *
+*  SLERP or NLERP to pose a rig between frames          *
+*                                                       *
+*  Benjamin Bourdin, bb247, University of Bath          *
+*  December  2008                                       *
+*                                                       *
+\*******************************************************/
+
+#include "fk.h"
+
+/* How track_sample blends two frames */
+#define TRACK_NLERP			(0)		/* Straight line then normalised - cheapest, a little uneven in speed */
+#define TRACK_SLERP			(1)		/* Along the great arc at constant speed */
+
+/* Type for a clip as quaternions - entry 0 of a frame is the root, entry 1+i rig bone i.
+ * Each frame lies in the same hemisphere as the one before it, so neighbours blend the short way round.
+ */
+typedef struct _posetrack {
+
+	int			frames_enum;
+	int			quats_enum;		/* Rig bones + 1 */
+	POINT3D*	root_pos;		/* [frame] */
+	float*		quats;			/* [frame][4][quats_enum] Rows of w, x, y, z - root_orient for the root, link.R for a bone */
+
+} POSETRACK;
+
+/* Type for a track sampled at one instant, in the same rows as a frame of POSETRACK::quats */
+typedef struct _trackpose {
+
+	int			quats_enum;
+	POINT3D		root_pos;
+	float*		quats;			/* [4][quats_enum] */
+	float*		weights;		/* [2][quats_enum] Working space of track_sample */
+
+} TRACKPOSE;
+
+
+POSETRACK*	track_create(RIG* rig, MOCAP* mocap);										/* Quaternions of every frame of a clip */
+void		track_free(POSETRACK* track);
+TRACKPOSE*	track_createpose(POSETRACK* track);											/* Room for a sample of the track */
+void		track_freepose(TRACKPOSE* sample);
+void		track_sample(POSETRACK* track, double frame, int mode, TRACKPOSE* sample);	/* The track at a fractional frame (0 based, clamped to the clip) */
+void		track_pose(RIG* rig, TRACKPOSE* sample, FKPOSE* pose);						/* Forward kinematics of a sample */
+
+#endif